@@ -45,6 +45,85 @@ static const char* kTramas[] = {
  */
 static const size_t kCantidadTramas = sizeof(kTramas) / sizeof(kTramas[0]);
 
+/**
+ * @brief Si es true, las cargas consecutivas se agrupan en tramas "B,<texto>".
+ *
+ * Las tramas M cierran el lote en curso, porque cambian el rotor para los
+ * caracteres siguientes. Con false se envía el formato clásico "L,<c>".
+ */
+static const bool kUsarLotes = true;
+
+/**
+ * @brief Pausa entre líneas en milisegundos (1000 reproduce el ritmo original de demostración).
+ */
+static const unsigned long kPausaMs = 1000;
+
+/**
+ * @brief Máximo de caracteres por trama "B" (el decodificador acepta hasta 255 bytes por línea).
+ */
+static const size_t kMaxLote = 200;
+
+/**
+ * @brief Extrae el carácter de una trama "L,<c>" o "L,Space".
+ * @param trama Texto de la trama.
+ * @param caracter Recibe el carácter de carga.
+ * @return true si la trama es una carga reconocida.
+ */
+static bool caracterDeCarga(const char* trama, char& caracter) {
+  if (trama[0] != 'L' || trama[1] != ',') {
+    return false;
+  }
+  const char* carga = trama + 2;
+  if (strcmp(carga, "Space") == 0) {
+    caracter = ' ';
+    return true;
+  }
+  if (carga[0] != '\0' && carga[1] == '\0') {
+    caracter = carga[0];
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Envía una línea y espera kPausaMs.
+ * @param linea Texto a enviar sin salto de línea.
+ */
+static void enviarLinea(const char* linea) {
+  Serial.println(linea);
+  delay(kPausaMs);
+}
+
+/**
+ * @brief Envía la secuencia agrupando cargas consecutivas en tramas "B".
+ */
+static void enviarEnLotes() {
+  char lote[kMaxLote + 3] = "B,";
+  size_t enLote = 0;
+
+  for (size_t i = 0; i < kCantidadTramas; ++i) {
+    char caracter = '\0';
+    if (caracterDeCarga(kTramas[i], caracter) && enLote < kMaxLote) {
+      lote[2 + enLote++] = caracter;
+      continue;
+    }
+    if (enLote > 0) {
+      lote[2 + enLote] = '\0';
+      enviarLinea(lote);
+      enLote = 0;
+    }
+    if (caracterDeCarga(kTramas[i], caracter)) {
+      lote[2 + enLote++] = caracter;
+    } else {
+      enviarLinea(kTramas[i]);
+    }
+  }
+  if (enLote > 0) {
+    lote[2 + enLote] = '\0';
+    enviarLinea(lote);
+  }
+}
+
 /**
  * @brief Configura el puerto serie a 115200 8N1 y espera al monitor.
  */
@@ -53,18 +132,20 @@ void setup() {
   while (!Serial) {
     delay(10);
   }
-  Serial.println("# Emisor PRT-7 listo. Enviando una trama cada segundo.");
+  Serial.println("# Emisor PRT-7 listo.");
 }
 
 /**
- * @brief Envía "INICIO" y la secuencia de tramas una sola vez con delay(1000) entre líneas.
+ * @brief Envía "INICIO" y la secuencia de tramas, en lotes o una por línea, con kPausaMs entre líneas.
  */
 void loop() {
-  Serial.println(kInicio);
-  delay(1000);
+  enviarLinea(kInicio);
 
+  if (kUsarLotes) {
+    enviarEnLotes();
+    return;
+  }
   for (size_t i = 0; i < kCantidadTramas; ++i) {
-    Serial.println(kTramas[i]);
-    delay(1000);
+    enviarLinea(kTramas[i]);
   }
 }
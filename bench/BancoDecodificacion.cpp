@@ -0,0 +1,467 @@
+/**
+ * @file BancoDecodificacion.cpp
+ * @brief Banco de pruebas de rendimiento de la ruta de decodificación PRT-7.
+ *
+ * Mide el dispatcher, el rotor, los núcleos de decodificación por bloques, la lista de carga y el bucle completo de
+ * delimitación de líneas sobre tramas sintéticas. Los resultados se escriben en
+ * JSON (una entrada por caso) para compararlos entre versiones.
+ *
+ * Uso: prt7_bench [--proporcion-carga P] [--longitud-mensaje N] [--tramas N]
+ *                 [--repeticiones N] [--semilla N] [--filtro TEXTO] [--salida ARCHIVO]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "ArduinoParser.h"
+#include "LineaDispatcher.h"
+#include "ListaDeCarga.h"
+#include "NucleoRotor.h"
+#include "RotorDeMapeo.h"
+
+namespace {
+
+/**
+ * @brief Parámetros de la mezcla sintética y de la medición.
+ */
+struct Configuracion {
+    double proporcionCarga;
+    std::size_t longitudMensaje;
+    std::size_t tramas;
+    std::size_t repeticiones;
+    std::uint64_t semilla;
+    const char* filtro;
+    const char* salida;
+};
+
+/**
+ * @brief Resultado de un caso: tiempos por repetición reducidos a mínimo y mediana.
+ */
+struct Resultado {
+    const char* nombre;
+    std::uint64_t operaciones;
+    std::uint64_t bytes;
+    double nsMinimo;
+    double nsMediana;
+};
+
+/**
+ * @brief Flujo de tramas sintéticas en memoria, con su índice de líneas.
+ */
+struct Flujo {
+    char* datos;
+    std::size_t bytes;
+    VistaLinea* lineas;
+    std::size_t cantidadLineas;
+};
+
+// Evita que el compilador descarte cálculos cuyo resultado no se usa.
+volatile std::uint64_t gSumidero = 0;
+
+std::uint64_t siguienteAleatorio(std::uint64_t& estado)
+{
+    estado ^= estado << 13;
+    estado ^= estado >> 7;
+    estado ^= estado << 17;
+    return estado;
+}
+
+/**
+ * @brief Genera sesiones INICIO + tramas con la proporción LOAD/MAP pedida.
+ *
+ * Cada sesión contiene longitudMensaje tramas LOAD; entre ellas se intercalan
+ * tramas MAP para respetar la proporción. Se generan exactamente `tramas` tramas,
+ * aunque la última sesión quede incompleta.
+ */
+bool generarFlujo(const Configuracion& cfg, Flujo& flujo)
+{
+    const std::size_t maxPorTrama = 8; // "M,-12\n" o "L,Space\n"
+    flujo.datos = new (std::nothrow) char[cfg.tramas * maxPorTrama];
+    flujo.lineas = new (std::nothrow) VistaLinea[cfg.tramas];
+    if (!flujo.datos || !flujo.lineas) {
+        return false;
+    }
+
+    std::uint64_t estado = cfg.semilla ? cfg.semilla : 1;
+    const std::uint64_t umbralCarga = static_cast<std::uint64_t>(cfg.proporcionCarga * 1000000.0);
+    std::size_t usados = 0;
+    std::size_t lineas = 0;
+    std::size_t generadas = 0;
+
+    auto agregar = [&](const char* texto, std::size_t longitud) {
+        flujo.lineas[lineas].datos = flujo.datos + usados;
+        flujo.lineas[lineas].longitud = longitud;
+        ++lineas;
+        std::memcpy(flujo.datos + usados, texto, longitud);
+        usados += longitud;
+        flujo.datos[usados++] = '\n';
+        ++generadas;
+    };
+
+    while (generadas < cfg.tramas) {
+        agregar("INICIO", 6);
+        std::size_t cargas = 0;
+        while (cargas < cfg.longitudMensaje && generadas < cfg.tramas) {
+            char trama[8];
+            std::size_t longitud = 0;
+            if (siguienteAleatorio(estado) % 1000000 < umbralCarga) {
+                const unsigned valor = static_cast<unsigned>(siguienteAleatorio(estado) % 27);
+                if (valor == 26) {
+                    std::memcpy(trama, "L,Space", 7);
+                    longitud = 7;
+                } else {
+                    trama[0] = 'L';
+                    trama[1] = ',';
+                    trama[2] = static_cast<char>('A' + valor);
+                    longitud = 3;
+                }
+                ++cargas;
+            } else {
+                const int pasos = static_cast<int>(siguienteAleatorio(estado) % 51) - 25;
+                longitud = static_cast<std::size_t>(std::snprintf(trama, sizeof(trama), "M,%d", pasos));
+            }
+            agregar(trama, longitud);
+        }
+    }
+
+    flujo.bytes = usados;
+    flujo.cantidadLineas = lineas;
+    return true;
+}
+
+void liberarFlujo(Flujo& flujo)
+{
+    delete[] flujo.datos;
+    delete[] flujo.lineas;
+    flujo.datos = nullptr;
+    flujo.lineas = nullptr;
+}
+
+int compararDouble(const void* a, const void* b)
+{
+    const double x = *static_cast<const double*>(a);
+    const double y = *static_cast<const double*>(b);
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+/**
+ * @brief Ejecuta un caso `repeticiones` veces y reduce los tiempos por operación.
+ * @param cuerpo Función que ejecuta una repetición completa y devuelve sus operaciones.
+ */
+template <typename Cuerpo>
+Resultado medir(const Configuracion& cfg, const char* nombre, std::uint64_t bytesPorRepeticion, Cuerpo cuerpo)
+{
+    double* tiempos = new double[cfg.repeticiones];
+    std::uint64_t operaciones = 0;
+
+    cuerpo(); // calentamiento: cachés, bloques de nodos y tablas ya reservados
+    for (std::size_t i = 0; i < cfg.repeticiones; ++i) {
+        const auto inicio = std::chrono::steady_clock::now();
+        operaciones = cuerpo();
+        const auto fin = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(fin - inicio).count();
+        tiempos[i] = operaciones ? ns / static_cast<double>(operaciones) : ns;
+    }
+
+    std::qsort(tiempos, cfg.repeticiones, sizeof(double), compararDouble);
+    Resultado r {nombre, operaciones, bytesPorRepeticion, tiempos[0], tiempos[cfg.repeticiones / 2]};
+    delete[] tiempos;
+    return r;
+}
+
+bool seleccionado(const Configuracion& cfg, const char* nombre)
+{
+    return !cfg.filtro || std::strstr(nombre, cfg.filtro) != nullptr;
+}
+
+void escribirResultado(std::FILE* salida, const Resultado& r, bool primero)
+{
+    const double opsPorSegundo = r.nsMediana > 0 ? 1e9 / r.nsMediana : 0.0;
+    const double nsRepeticion = r.nsMediana * static_cast<double>(r.operaciones);
+    const double mibPorSegundo =
+        (r.bytes && nsRepeticion > 0) ? (static_cast<double>(r.bytes) / (1024.0 * 1024.0)) / (nsRepeticion / 1e9) : 0.0;
+    std::fprintf(salida,
+                 "%s    {\"nombre\": \"%s\", \"operaciones\": %llu, \"ns_por_op_min\": %.3f, "
+                 "\"ns_por_op_mediana\": %.3f, \"ops_por_s\": %.0f, \"mib_por_s\": %.2f}",
+                 primero ? "" : ",\n", r.nombre, static_cast<unsigned long long>(r.operaciones), r.nsMinimo, r.nsMediana,
+                 opsPorSegundo, mibPorSegundo);
+}
+
+bool leerArgumentos(int argc, char* argv[], Configuracion& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--ayuda") == 0 || std::strcmp(arg, "-h") == 0) {
+            return false;
+        }
+        if (!valor) {
+            std::fprintf(stderr, "Falta el valor de %s\n", arg);
+            return false;
+        }
+        if (std::strcmp(arg, "--proporcion-carga") == 0) {
+            cfg.proporcionCarga = std::strtod(valor, nullptr);
+        } else if (std::strcmp(arg, "--longitud-mensaje") == 0) {
+            cfg.longitudMensaje = std::strtoull(valor, nullptr, 10);
+        } else if (std::strcmp(arg, "--tramas") == 0) {
+            cfg.tramas = std::strtoull(valor, nullptr, 10);
+        } else if (std::strcmp(arg, "--repeticiones") == 0) {
+            cfg.repeticiones = std::strtoull(valor, nullptr, 10);
+        } else if (std::strcmp(arg, "--semilla") == 0) {
+            cfg.semilla = std::strtoull(valor, nullptr, 10);
+        } else if (std::strcmp(arg, "--filtro") == 0) {
+            cfg.filtro = valor;
+        } else if (std::strcmp(arg, "--salida") == 0) {
+            cfg.salida = valor;
+        } else {
+            std::fprintf(stderr, "Opción no reconocida: %s\n", arg);
+            return false;
+        }
+        ++i;
+    }
+
+    if (cfg.proporcionCarga <= 0.0 || cfg.proporcionCarga > 1.0 || cfg.longitudMensaje == 0 || cfg.tramas == 0
+        || cfg.repeticiones == 0) {
+        std::fprintf(stderr, "Parámetros fuera de rango.\n");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Configuracion cfg {0.8, 64, 1000000, 9, 0x9E3779B97F4A7C15ull, nullptr, nullptr};
+    if (!leerArgumentos(argc, argv, cfg)) {
+        std::fprintf(stderr,
+                     "Uso: %s [--proporcion-carga P] [--longitud-mensaje N] [--tramas N] [--repeticiones N]\n"
+                     "          [--semilla N] [--filtro TEXTO] [--salida ARCHIVO]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    Flujo flujo {};
+    if (!generarFlujo(cfg, flujo)) {
+        std::fprintf(stderr, "No se pudo reservar el flujo sintético.\n");
+        return 1;
+    }
+
+    std::FILE* salida = stdout;
+    if (cfg.salida) {
+        salida = std::fopen(cfg.salida, "w");
+        if (!salida) {
+            std::fprintf(stderr, "No se pudo abrir %s\n", cfg.salida);
+            liberarFlujo(flujo);
+            return 1;
+        }
+    }
+
+    std::fprintf(salida,
+                 "{\n  \"banco\": \"prt7\",\n  \"formato\": 1,\n  \"configuracion\": {\"proporcion_carga\": %.3f, "
+                 "\"longitud_mensaje\": %llu, \"tramas\": %llu, \"bytes\": %llu, \"repeticiones\": %llu, \"semilla\": \"%llu\"},\n"
+                 "  \"resultados\": [\n",
+                 cfg.proporcionCarga, static_cast<unsigned long long>(cfg.longitudMensaje),
+                 static_cast<unsigned long long>(flujo.cantidadLineas), static_cast<unsigned long long>(flujo.bytes),
+                 static_cast<unsigned long long>(cfg.repeticiones), static_cast<unsigned long long>(cfg.semilla));
+
+    bool primero = true;
+    auto publicar = [&](const Resultado& r) {
+        escribirResultado(salida, r, primero);
+        primero = false;
+    };
+
+    ListaDeCarga lista;
+    RotorDeMapeo rotor;
+    LineaDispatcher dispatcher(&lista, &rotor, nullptr);
+
+    if (seleccionado(cfg, "dispatcher.onRawLine")) {
+        publicar(medir(cfg, "dispatcher.onRawLine", flujo.bytes, [&]() -> std::uint64_t {
+            for (std::size_t i = 0; i < flujo.cantidadLineas; ++i) {
+                dispatcher.onRawLine(flujo.lineas[i].datos, flujo.lineas[i].longitud);
+            }
+            gSumidero = gSumidero + dispatcher.totalProcesado();
+            return flujo.cantidadLineas;
+        }));
+    }
+
+    if (seleccionado(cfg, "dispatcher.onRawLines")) {
+        publicar(medir(cfg, "dispatcher.onRawLines", flujo.bytes, [&]() -> std::uint64_t {
+            dispatcher.onRawLines(flujo.lineas, flujo.cantidadLineas);
+            gSumidero = gSumidero + dispatcher.totalProcesado();
+            return flujo.cantidadLineas;
+        }));
+    }
+
+    if (seleccionado(cfg, "dispatcher.onRawBytes")) {
+        publicar(medir(cfg, "dispatcher.onRawBytes", flujo.bytes, [&]() -> std::uint64_t {
+            dispatcher.onRawBytes(flujo.datos, flujo.bytes);
+            gSumidero = gSumidero + dispatcher.totalProcesado();
+            return flujo.cantidadLineas;
+        }));
+    }
+    dispatcher.terminarSesion();
+
+    static const struct {
+        const char* rotar;
+        const char* mapeo;
+        MotorRotor motor;
+    } kMotores[] = {
+        {"rotor.rotar.tabla", "rotor.getMapeo.tabla", MotorRotor::Tabla},
+        {"rotor.rotar.lista", "rotor.getMapeo.lista", MotorRotor::ListaEnlazada},
+    };
+    const std::size_t kOperacionesRotor = 1000000;
+    for (const auto& m : kMotores) {
+        RotorDeMapeo local(m.motor);
+        if (seleccionado(cfg, m.rotar)) {
+            publicar(medir(cfg, m.rotar, 0, [&]() -> std::uint64_t {
+                for (std::size_t i = 0; i < kOperacionesRotor; ++i) {
+                    local.rotar(static_cast<int>(i % 51) - 25);
+                }
+                gSumidero = gSumidero + static_cast<std::uint64_t>(local.getDesplazamiento());
+                return kOperacionesRotor;
+            }));
+        }
+        if (seleccionado(cfg, m.mapeo)) {
+            publicar(medir(cfg, m.mapeo, 0, [&]() -> std::uint64_t {
+                std::uint64_t suma = 0;
+                for (std::size_t i = 0; i < kOperacionesRotor; ++i) {
+                    suma += static_cast<unsigned char>(local.getMapeo(static_cast<char>('A' + i % 26)));
+                }
+                gSumidero = gSumidero + suma;
+                return kOperacionesRotor;
+            }));
+        }
+    }
+
+    // Decodificación de un bloque de carga contra un solo desplazamiento: la fila de la
+    // tabla carácter a carácter, la lista enlazada y cada variante de NucleoRotor.
+    const std::size_t kBloqueCarga = 1 << 20;
+    char* carga = new char[kBloqueCarga];
+    char* decodificada = new char[kBloqueCarga];
+    std::uint64_t estadoCarga = cfg.semilla ? cfg.semilla : 1;
+    for (std::size_t i = 0; i < kBloqueCarga; ++i) {
+        const std::uint64_t r = siguienteAleatorio(estadoCarga) % 32;
+        carga[i] = (r < 26) ? static_cast<char>('A' + r) : ' ';
+    }
+    {
+        RotorDeMapeo tabla(MotorRotor::Tabla);
+        RotorDeMapeo enlazada(MotorRotor::ListaEnlazada);
+        tabla.rotar(7);
+        enlazada.rotar(7);
+        if (seleccionado(cfg, "bloque.tabla")) {
+            publicar(medir(cfg, "bloque.tabla", kBloqueCarga, [&]() -> std::uint64_t {
+                for (std::size_t i = 0; i < kBloqueCarga; ++i) {
+                    decodificada[i] = tabla.getMapeo(carga[i]);
+                }
+                gSumidero = gSumidero + static_cast<unsigned char>(decodificada[kBloqueCarga / 2]);
+                return kBloqueCarga;
+            }));
+        }
+        if (seleccionado(cfg, "bloque.lista")) {
+            publicar(medir(cfg, "bloque.lista", kBloqueCarga, [&]() -> std::uint64_t {
+                enlazada.getMapeo(carga, decodificada, kBloqueCarga);
+                gSumidero = gSumidero + static_cast<unsigned char>(decodificada[kBloqueCarga / 2]);
+                return kBloqueCarga;
+            }));
+        }
+    }
+    static const ImplementacionNucleo kNucleos[] = {ImplementacionNucleo::Escalar, ImplementacionNucleo::Sse2,
+                                                    ImplementacionNucleo::Avx2};
+    for (ImplementacionNucleo nucleo : kNucleos) {
+        char nombre[32];
+        std::snprintf(nombre, sizeof(nombre), "bloque.nucleo.%s", NucleoRotor::nombre(nucleo));
+        if (!NucleoRotor::disponible(nucleo) || !seleccionado(cfg, nombre)) {
+            continue;
+        }
+        publicar(medir(cfg, nombre, kBloqueCarga, [&]() -> std::uint64_t {
+            NucleoRotor::decodificarCon(nucleo, carga, decodificada, kBloqueCarga, 7);
+            gSumidero = gSumidero + static_cast<unsigned char>(decodificada[kBloqueCarga / 2]);
+            return kBloqueCarga;
+        }));
+    }
+    delete[] decodificada;
+    delete[] carga;
+
+    const std::size_t kCaracteres = 1000000;
+    if (seleccionado(cfg, "lista.insertarAlFinal")) {
+        publicar(medir(cfg, "lista.insertarAlFinal", 0, [&]() -> std::uint64_t {
+            lista.limpiar();
+            for (std::size_t i = 0; i < kCaracteres; ++i) {
+                lista.insertarAlFinal(static_cast<char>('A' + i % 26));
+            }
+            gSumidero = gSumidero + lista.tamano();
+            return kCaracteres;
+        }));
+    }
+
+    // Una sesión completa: insertar el mensaje y limpiar. limpiar() es O(1), así que domina la inserción.
+    if (seleccionado(cfg, "lista.sesion")) {
+        const std::size_t kSesiones = 10000;
+        publicar(medir(cfg, "lista.sesion", 0, [&]() -> std::uint64_t {
+            for (std::size_t s = 0; s < kSesiones; ++s) {
+                for (std::size_t i = 0; i < cfg.longitudMensaje; ++i) {
+                    lista.insertarAlFinal('X');
+                }
+                lista.limpiar();
+            }
+            return kSesiones;
+        }));
+    }
+
+    if (seleccionado(cfg, "lista.copiarMensaje")) {
+        lista.limpiar();
+        for (std::size_t i = 0; i < cfg.longitudMensaje; ++i) {
+            lista.insertarAlFinal(static_cast<char>('A' + i % 26));
+        }
+        char* copia = new char[cfg.longitudMensaje + 1];
+        const std::size_t kCopias = 100000;
+        publicar(medir(cfg, "lista.copiarMensaje", 0, [&]() -> std::uint64_t {
+            for (std::size_t i = 0; i < kCopias; ++i) {
+                lista.copiarMensaje(copia, cfg.longitudMensaje + 1);
+                gSumidero = gSumidero + static_cast<unsigned char>(copia[i % cfg.longitudMensaje]);
+            }
+            return kCopias;
+        }));
+        delete[] copia;
+        lista.limpiar();
+    }
+
+    // Bucle completo de captura: bloques como los que entrega read() pasan por la
+    // delimitación de líneas de ArduinoParser (o el analizador de flujo) y el dispatcher.
+    static const struct {
+        const char* nombre;
+        ModoLectura modo;
+    } kModos[] = {
+        {"captura.lineas", ModoLectura::Lineas},
+        {"captura.flujo", ModoLectura::Flujo},
+    };
+    const std::size_t kBloque = 4096;
+    for (const auto& m : kModos) {
+        if (!seleccionado(cfg, m.nombre)) {
+            continue;
+        }
+        ArduinoParser parser(nullptr, &dispatcher);
+        parser.setModoLectura(m.modo);
+        publicar(medir(cfg, m.nombre, flujo.bytes, [&]() -> std::uint64_t {
+            for (std::size_t desde = 0; desde < flujo.bytes; desde += kBloque) {
+                const std::size_t resto = flujo.bytes - desde;
+                parser.alimentar(flujo.datos + desde, resto < kBloque ? resto : kBloque);
+            }
+            gSumidero = gSumidero + dispatcher.totalProcesado();
+            return flujo.cantidadLineas;
+        }));
+        dispatcher.terminarSesion();
+    }
+
+    std::fprintf(salida, "\n  ]\n}\n");
+    if (salida != stdout) {
+        std::fclose(salida);
+    }
+    liberarFlujo(flujo);
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file ConversorBinario.cpp
+ * @brief Convierte un flujo PRT-7 de texto al modo binario compacto.
+ *
+ * Lee tramas de texto (un archivo o STDIN), las analiza con AnalizadorTramas y
+ * las reescribe con CodificadorBinario: "INICIO-BIN", bloques con CRC-16 y la
+ * operación Fin al terminar. El resultado se decodifica con `program -d` o se
+ * reproduce sobre una pty para comparar ancho de banda con el formato de texto.
+ * Las tramas anteriores al primer INICIO se omiten, como haría el decodificador.
+ *
+ * Uso: prt7_binario [--por-trama] [-o ARCHIVO] [ENTRADA|-]
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "AnalizadorTramas.h"
+#include "CodificadorBinario.h"
+
+namespace {
+
+const std::size_t kBloqueLectura = 64 * 1024;
+const std::size_t kCapacidadSalida = 64 * 1024;
+
+bool escribirTodo(int fd, const char* datos, std::size_t longitud)
+{
+    while (longitud > 0) {
+        const ssize_t n = ::write(fd, datos, longitud);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        datos += n;
+        longitud -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief Escribe lo acumulado en el codificador si ya no queda la reserva de una operación.
+ */
+bool vaciarSiHaceFalta(CodificadorBinario& codificador, const char* salida, int fd, bool forzar)
+{
+    if (!forzar && kCapacidadSalida - codificador.longitud() >= 2 * CodificadorBinario::kReservaSalida) {
+        return true;
+    }
+    const bool escrito = escribirTodo(fd, salida, codificador.longitud());
+    codificador.descartarSalida();
+    return escrito;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const char* entrada = "-";
+    const char* rutaSalida = nullptr;
+    bool porTrama = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--por-trama") == 0) {
+            porTrama = true;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            rutaSalida = argv[++i];
+        } else if (argv[i][0] != '-' || std::strcmp(argv[i], "-") == 0) {
+            entrada = argv[i];
+        } else {
+            std::fprintf(stderr, "Uso: %s [--por-trama (un bloque con CRC por trama)] [-o ARCHIVO] [ENTRADA|-]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    const int entradaFd = (std::strcmp(entrada, "-") == 0) ? STDIN_FILENO : ::open(entrada, O_RDONLY);
+    if (entradaFd < 0) {
+        std::fprintf(stderr, "No se pudo abrir %s\n", entrada);
+        return 1;
+    }
+    const int salidaFd = rutaSalida ? ::open(rutaSalida, O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+    if (salidaFd < 0) {
+        std::fprintf(stderr, "No se pudo abrir %s para escritura\n", rutaSalida);
+        return 1;
+    }
+
+    char* bloque = new char[kBloqueLectura];
+    char* salida = new char[kCapacidadSalida];
+    CodificadorBinario codificador(salida, kCapacidadSalida);
+    codificador.setCrcPorTrama(porTrama);
+    AnalizadorTramas analizador;
+
+    unsigned long long bytesTexto = 0;
+    unsigned long long bytesBinario = 0;
+    unsigned long long tramas = 0;
+    unsigned long long omitidas = 0;
+    bool enSesion = false;
+    bool exito = true;
+    TramaDecodificada trama;
+
+    bool fin = false;
+    while (!fin && exito) {
+        const ssize_t leidos = ::read(entradaFd, bloque, kBloqueLectura);
+        if (leidos < 0 && errno == EINTR) {
+            continue;
+        }
+        if (leidos < 0) {
+            std::fprintf(stderr, "Fallo al leer %s\n", entrada);
+            exito = false;
+            break;
+        }
+        fin = (leidos == 0);
+        bytesTexto += static_cast<unsigned long long>(leidos);
+
+        for (ssize_t i = 0; i <= leidos && exito; ++i) {
+            // Al final de la entrada, una última línea sin '\n' también es una trama.
+            const bool completa = (i < leidos) ? analizador.consumir(bloque[i], trama) : fin && analizador.finalizar(trama);
+            if (!completa) {
+                continue;
+            }
+            enSesion = enSesion || trama.tipo == TipoTrama::Inicio || trama.tipo == TipoTrama::InicioBinario;
+            if (!enSesion || !codificador.agregar(trama)) {
+                ++omitidas;
+                continue;
+            }
+            ++tramas;
+            const std::size_t pendiente = codificador.longitud();
+            exito = vaciarSiHaceFalta(codificador, salida, salidaFd, false);
+            bytesBinario += pendiente - codificador.longitud();
+        }
+    }
+
+    if (exito && enSesion) {
+        codificador.agregarFin();
+    }
+    bytesBinario += codificador.longitud();
+    exito = vaciarSiHaceFalta(codificador, salida, salidaFd, true) && exito;
+
+    std::fprintf(stderr, "%llu tramas (%llu omitidas): %llu bytes de texto -> %llu bytes binarios (%.1f%%)\n", tramas,
+                 omitidas, bytesTexto, bytesBinario, bytesTexto ? 100.0 * bytesBinario / bytesTexto : 0.0);
+
+    delete[] salida;
+    delete[] bloque;
+    if (entradaFd != STDIN_FILENO) {
+        ::close(entradaFd);
+    }
+    if (rutaSalida) {
+        ::close(salidaFd);
+    }
+    return exito ? 0 : 1;
+}
@@ -0,0 +1,322 @@
+/**
+ * @file EmuladorArduino.cpp
+ * @brief Emisor PRT-7 sobre una pseudo-terminal para pruebas extremo a extremo.
+ *
+ * Crea una pty, publica la ruta del lado esclavo y envía sesiones de tramas con
+ * la mezcla y el ritmo indicados, intercalando marcas "T,<ns>" con el instante de
+ * envío. Del otro lado se ejecuta `program --latencia RUTA`, que abre la pty con la
+ * misma configuración termios que un Arduino real y reporta percentiles.
+ *
+ * Con --lote N las cargas consecutivas viajan en tramas "B,<texto>" de hasta N
+ * caracteres en lugar de una trama "L" por carácter.
+ *
+ * Uso: prt7_emulador [--tasa TRAMAS_S] [--baud B] [--segundos S] [--proporcion-carga P]
+ *                    [--longitud-mensaje N] [--marca-cada N] [--espera S] [--enlace RUTA]
+ *                    [--lote N]
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Parámetros del tráfico generado.
+ */
+struct Configuracion {
+    double tasa;
+    unsigned baud;
+    double segundos;
+    double proporcionCarga;
+    std::size_t longitudMensaje;
+    std::size_t marcaCada;
+    double espera;
+    const char* enlace;
+    std::size_t lote;
+};
+
+const std::size_t kMaxRafaga = 16 * 1024;
+// Cabe en el límite de 255 bytes por línea del decodificador con "B," y el salto.
+const std::size_t kMaxLote = 200;
+const long kTickNs = 1000000; // 1 ms entre ráfagas
+
+std::uint64_t ahoraNs()
+{
+    timespec ahora {};
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return static_cast<std::uint64_t>(ahora.tv_sec) * 1000000000u + static_cast<std::uint64_t>(ahora.tv_nsec);
+}
+
+std::uint64_t siguienteAleatorio(std::uint64_t& estado)
+{
+    estado ^= estado << 13;
+    estado ^= estado >> 7;
+    estado ^= estado << 17;
+    return estado;
+}
+
+/**
+ * @brief Genera tramas LOAD/MAP con sesiones de longitud fija y marcas periódicas.
+ */
+class Generador {
+public:
+    explicit Generador(const Configuracion& cfg) noexcept
+        : _cfg(cfg)
+        , _estado(0x9E3779B97F4A7C15ull)
+        , _cargasSesion(cfg.longitudMensaje)
+        , _desdeMarca(0)
+        , _tramas(0)
+    {
+    }
+
+    /**
+     * @brief Escribe la siguiente trama (con salto de línea) en @p destino.
+     * @return Bytes escritos.
+     */
+    std::size_t siguiente(char* destino, std::uint64_t instanteNs)
+    {
+        ++_tramas;
+        if (_cfg.marcaCada > 0 && ++_desdeMarca >= _cfg.marcaCada) {
+            _desdeMarca = 0;
+            return static_cast<std::size_t>(
+                std::sprintf(destino, "T,%llu\n", static_cast<unsigned long long>(instanteNs)));
+        }
+        if (_cargasSesion >= _cfg.longitudMensaje) {
+            _cargasSesion = 0;
+            std::memcpy(destino, "INICIO\n", 7);
+            return 7;
+        }
+        if (static_cast<double>(siguienteAleatorio(_estado) % 1000000) < _cfg.proporcionCarga * 1000000.0) {
+            if (_cfg.lote > 0) {
+                return siguienteLote(destino);
+            }
+            ++_cargasSesion;
+            const unsigned valor = static_cast<unsigned>(siguienteAleatorio(_estado) % 27);
+            if (valor == 26) {
+                std::memcpy(destino, "L,Space\n", 8);
+                return 8;
+            }
+            destino[0] = 'L';
+            destino[1] = ',';
+            destino[2] = static_cast<char>('A' + valor);
+            destino[3] = '\n';
+            return 4;
+        }
+        const int pasos = static_cast<int>(siguienteAleatorio(_estado) % 51) - 25;
+        return static_cast<std::size_t>(std::sprintf(destino, "M,%d\n", pasos));
+    }
+
+    std::uint64_t tramas() const noexcept
+    {
+        return _tramas;
+    }
+
+private:
+    /**
+     * @brief Escribe una trama "B," con hasta _cfg.lote caracteres que no rebasan la sesión.
+     */
+    std::size_t siguienteLote(char* destino)
+    {
+        std::size_t cantidad = _cfg.longitudMensaje - _cargasSesion;
+        if (cantidad > _cfg.lote) {
+            cantidad = _cfg.lote;
+        }
+        _cargasSesion += cantidad;
+
+        destino[0] = 'B';
+        destino[1] = ',';
+        for (std::size_t i = 0; i < cantidad; ++i) {
+            const unsigned valor = static_cast<unsigned>(siguienteAleatorio(_estado) % 27);
+            destino[2 + i] = (valor == 26) ? ' ' : static_cast<char>('A' + valor);
+        }
+        destino[2 + cantidad] = '\n';
+        return cantidad + 3;
+    }
+
+    const Configuracion& _cfg;
+    std::uint64_t _estado;
+    std::size_t _cargasSesion;
+    std::size_t _desdeMarca;
+    std::uint64_t _tramas;
+};
+
+bool escribirTodo(int fd, const char* datos, std::size_t longitud, std::uint64_t& bloqueos)
+{
+    while (longitud > 0) {
+        const ssize_t escritos = ::write(fd, datos, longitud);
+        if (escritos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (static_cast<std::size_t>(escritos) < longitud) {
+            ++bloqueos;
+        }
+        datos += escritos;
+        longitud -= static_cast<std::size_t>(escritos);
+    }
+    return true;
+}
+
+bool leerArgumentos(int argc, char* argv[], Configuracion& cfg)
+{
+    for (int i = 1; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* valor = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!valor) {
+            return false;
+        }
+        if (std::strcmp(arg, "--tasa") == 0) {
+            cfg.tasa = std::strtod(valor, nullptr);
+        } else if (std::strcmp(arg, "--baud") == 0) {
+            cfg.baud = static_cast<unsigned>(std::strtoul(valor, nullptr, 10));
+        } else if (std::strcmp(arg, "--segundos") == 0) {
+            cfg.segundos = std::strtod(valor, nullptr);
+        } else if (std::strcmp(arg, "--proporcion-carga") == 0) {
+            cfg.proporcionCarga = std::strtod(valor, nullptr);
+        } else if (std::strcmp(arg, "--longitud-mensaje") == 0) {
+            cfg.longitudMensaje = std::strtoull(valor, nullptr, 10);
+        } else if (std::strcmp(arg, "--marca-cada") == 0) {
+            cfg.marcaCada = std::strtoull(valor, nullptr, 10);
+        } else if (std::strcmp(arg, "--espera") == 0) {
+            cfg.espera = std::strtod(valor, nullptr);
+        } else if (std::strcmp(arg, "--enlace") == 0) {
+            cfg.enlace = valor;
+        } else if (std::strcmp(arg, "--lote") == 0) {
+            cfg.lote = std::strtoull(valor, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return cfg.tasa >= 0.0 && cfg.segundos > 0.0 && cfg.proporcionCarga > 0.0 && cfg.proporcionCarga <= 1.0
+        && cfg.longitudMensaje > 0 && cfg.lote <= kMaxLote;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Configuracion cfg {1000.0, 115200, 10.0, 0.8, 64, 16, 2.0, nullptr, 0};
+    if (!leerArgumentos(argc, argv, cfg)) {
+        std::fprintf(stderr,
+                     "Uso: %s [--tasa TRAMAS_S (0 = sin límite)] [--baud B (0 = sin límite de enlace)]\n"
+                     "          [--segundos S] [--proporcion-carga P] [--longitud-mensaje N]\n"
+                     "          [--marca-cada N (0 = sin marcas)] [--espera S] [--enlace RUTA]\n"
+                     "          [--lote N (1-200 caracteres por trama B; 0 = solo tramas L)]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    const int maestro = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || ::grantpt(maestro) != 0 || ::unlockpt(maestro) != 0) {
+        std::perror("posix_openpt");
+        return 1;
+    }
+    const char* nombre = ::ptsname(maestro);
+    if (!nombre) {
+        std::perror("ptsname");
+        return 1;
+    }
+
+    // Se mantiene abierto el esclavo en modo crudo para que nada haga eco antes de
+    // que el decodificador aplique su propia configuración.
+    const int esclavo = ::open(nombre, O_RDWR | O_NOCTTY);
+    if (esclavo >= 0) {
+        termios crudo {};
+        if (tcgetattr(esclavo, &crudo) == 0) {
+            cfmakeraw(&crudo);
+            tcsetattr(esclavo, TCSANOW, &crudo);
+        }
+    }
+
+    if (cfg.enlace) {
+        // Solo se reemplaza un enlace de una ejecución anterior; una ruta mal escrita no borra un archivo real.
+        struct stat previo {};
+        if (::lstat(cfg.enlace, &previo) == 0) {
+            if (!S_ISLNK(previo.st_mode)) {
+                std::fprintf(stderr, "%s ya existe y no es un enlace simbólico; no se reemplaza.\n", cfg.enlace);
+                return 1;
+            }
+            ::unlink(cfg.enlace);
+        }
+        if (::symlink(nombre, cfg.enlace) != 0) {
+            std::perror("symlink");
+        }
+    }
+    std::printf("%s\n", cfg.enlace ? cfg.enlace : nombre);
+    std::fflush(stdout);
+
+    timespec espera {};
+    espera.tv_sec = static_cast<time_t>(cfg.espera);
+    espera.tv_nsec = static_cast<long>((cfg.espera - static_cast<double>(espera.tv_sec)) * 1e9);
+    nanosleep(&espera, nullptr);
+
+    // Límite del enlace 8N1: 10 bits por byte.
+    const double bytesPorSegundo = cfg.baud ? cfg.baud / 10.0 : 0.0;
+    Generador generador(cfg);
+    char* rafaga = new char[kMaxRafaga + kMaxLote + 32];
+    std::uint64_t bytes = 0;
+    std::uint64_t bloqueos = 0;
+    bool exito = true;
+
+    const std::uint64_t inicio = ahoraNs();
+    const std::uint64_t fin = inicio + static_cast<std::uint64_t>(cfg.segundos * 1e9);
+    std::uint64_t proximo = inicio;
+    while (exito) {
+        const std::uint64_t ahora = ahoraNs();
+        if (ahora >= fin) {
+            break;
+        }
+
+        const double transcurrido = (ahora - inicio) / 1e9;
+        const double tramasPermitidas = cfg.tasa > 0.0 ? cfg.tasa * transcurrido : 1e300;
+        const double bytesPermitidos = bytesPorSegundo > 0.0 ? bytesPorSegundo * transcurrido : 1e300;
+
+        std::size_t usados = 0;
+        while (usados < kMaxRafaga && static_cast<double>(generador.tramas()) < tramasPermitidas
+               && static_cast<double>(bytes + usados) < bytesPermitidos) {
+            usados += generador.siguiente(rafaga + usados, ahora);
+        }
+        if (usados > 0) {
+            exito = escribirTodo(maestro, rafaga, usados, bloqueos);
+            bytes += usados;
+            continue;
+        }
+
+        proximo += kTickNs;
+        if (proximo < ahora) {
+            proximo = ahora + kTickNs;
+        }
+        timespec objetivo {};
+        objetivo.tv_sec = static_cast<time_t>(proximo / 1000000000u);
+        objetivo.tv_nsec = static_cast<long>(proximo % 1000000000u);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &objetivo, nullptr);
+    }
+
+    const double duracion = (ahoraNs() - inicio) / 1e9;
+    std::fprintf(stderr, "Enviadas %llu tramas (%llu bytes) en %.3f s: %.0f tramas/s, %.0f bytes/s; escrituras parciales: %llu\n",
+                 static_cast<unsigned long long>(generador.tramas()), static_cast<unsigned long long>(bytes), duracion,
+                 generador.tramas() / duracion, bytes / duracion, static_cast<unsigned long long>(bloqueos));
+
+    // Deja que el decodificador drene la pty antes de cerrarla.
+    const timespec drenado {0, 200000000};
+    nanosleep(&drenado, nullptr);
+    delete[] rafaga;
+    if (cfg.enlace) {
+        ::unlink(cfg.enlace);
+    }
+    if (esclavo >= 0) {
+        ::close(esclavo);
+    }
+    ::close(maestro);
+    return exito ? 0 : 1;
+}
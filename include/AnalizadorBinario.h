@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ProtocoloBinario.h"
+
+/**
+ * @file AnalizadorBinario.h
+ * @brief Delimitación y verificación de los bloques del modo binario de PRT-7.
+ */
+
+/**
+ * @brief Motivo por el que se descartó un bloque binario.
+ */
+enum class ErrorBinario { Ninguno, Vacio, Crc };
+
+/**
+ * @brief Bloque binario completo; el cuerpo solo es válido hasta el siguiente byte analizado.
+ */
+struct BloqueBinario {
+    ErrorBinario error;
+    const unsigned char* cuerpo;
+    std::size_t longitud;
+};
+
+/**
+ * @class AnalizadorBinario
+ * @brief Máquina de estados que separa bloques "0xA5, longitud, cuerpo, CRC" de un flujo de bytes.
+ *
+ * Los bloques pueden llegar partidos entre lecturas. Los bytes fuera de un bloque
+ * se descartan hasta encontrar el byte de sincronía; un bloque con CRC incorrecto
+ * se reporta y el análisis continúa con el siguiente. No interpreta las operaciones
+ * del cuerpo: de eso se encarga LineaDispatcher::onBloqueBinario().
+ */
+class AnalizadorBinario {
+public:
+    /**
+     * @brief Crea el analizador esperando el byte de sincronía.
+     */
+    AnalizadorBinario() noexcept;
+
+    /**
+     * @brief Descarta el bloque parcial y vuelve a esperar sincronía.
+     */
+    void reiniciar() noexcept;
+
+    /**
+     * @brief Consume bytes hasta completar un bloque o agotar la entrada.
+     * @param datos Siguiente byte por analizar; avanza hasta el primer byte no consumido.
+     * @param fin Fin de los bytes disponibles.
+     * @param salida Se llena cuando se completa un bloque, válido o no.
+     * @return true si se completó un bloque en @p salida.
+     */
+    bool consumir(const char*& datos, const char* fin, BloqueBinario& salida) noexcept;
+
+    /**
+     * @brief Bytes descartados mientras se buscaba el byte de sincronía.
+     * @return Total desde la construcción.
+     */
+    std::uint64_t bytesDescartados() const noexcept;
+
+private:
+    enum class Estado { Sincronia, Longitud, Cuerpo, CrcAlto, CrcBajo };
+
+    Estado _estado;
+    std::size_t _longitud;
+    std::size_t _recibidos;
+    std::uint16_t _crc;
+    std::uint64_t _descartados;
+    unsigned char _cuerpo[ProtocoloBinario::kMaxCuerpo];
+};
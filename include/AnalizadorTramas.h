@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @file AnalizadorTramas.h
+ * @brief Analizador léxico de una sola pasada para las tramas del protocolo PRT-7.
+ */
+
+/**
+ * @brief Clasificación de una línea analizada.
+ *
+ * TipoTrama::InicioBinario corresponde a "INICIO-BIN": abre una sesión como INICIO y
+ * a partir del byte siguiente el enlace transporta bloques binarios (ver ProtocoloBinario.h).
+ *
+ * TipoTrama::Marca corresponde a "T,<ns>": una marca de tiempo de envío que solo
+ * emiten las herramientas de prueba (prt7_emulador) y no altera la sesión.
+ *
+ * TipoTrama::Lote corresponde a "B,<texto>": varios caracteres de carga en una sola
+ * línea. Todo lo que sigue a la primera coma es carga literal, incluidos espacios
+ * y comas; equivale a una trama "L" por carácter con el rotor en la misma posición.
+ *
+ * TipoTrama::FinMensaje corresponde a "FIN": cierra el mensaje en curso sin cerrar
+ * la sesión; el siguiente carácter empieza otro mensaje con el rotor donde quedó.
+ *
+ * Cualquier trama salvo "INICIO-BIN" puede llevar el prefijo de canal lógico "N:"
+ * (p. ej. "3:L,H" o "3:INICIO"); ver TramaDecodificada::canal.
+ */
+enum class TipoTrama { Inicio, InicioBinario, Carga, Mapa, Marca, Lote, FinMensaje, Invalida };
+
+/**
+ * @brief Motivo por el que una línea se considera inválida.
+ */
+enum class ErrorTrama { Ninguno, Incompleta, PrefijoDesconocido, TokenInvalido, RotacionInvalida, Desbordada, CanalInvalido };
+
+/**
+ * @brief Resultado de analizar una línea: tipo, error y valor decodificado.
+ */
+struct TramaDecodificada {
+    TipoTrama tipo;
+    ErrorTrama error;
+    char dato;
+    int desplazamiento;
+    long marca;
+    const char* lote;         ///< Carga de una trama Lote; válida hasta el siguiente byte analizado.
+    std::size_t longitudLote; ///< Caracteres en @ref lote.
+    int canal;                ///< Canal lógico del prefijo "N:", o -1 si la trama no lo lleva.
+};
+
+/**
+ * @class AnalizadorTramas
+ * @brief Máquina de estados que clasifica y decodifica una trama byte por byte.
+ *
+ * Reconoce INICIO, INICIO-BIN, FIN, el prefijo L/M/T, el carácter entre comillas, los tokens con
+ * nombre (Space, Tab, Comma) y el entero con signo en un solo recorrido, sin
+ * copiar la línea ni emplear strtok. Todo el estado vive en la instancia.
+ */
+class AnalizadorTramas {
+public:
+    /**
+     * @brief Longitud máxima por línea mientras no se llame a setLongitudMaxima().
+     */
+    static const std::size_t kLongitudMaximaPorDefecto = 255;
+
+    /**
+     * @brief Máximo de caracteres en una trama "B": la línea por defecto sin el "B,".
+     *
+     * Las más largas se reportan como desbordadas aunque se amplíe la longitud por línea.
+     */
+    static const std::size_t kMaxLote = kLongitudMaximaPorDefecto - 2;
+
+    /**
+     * @brief Número de canales lógicos; los prefijos "N:" fuera de rango se reportan como CanalInvalido.
+     */
+    static const int kMaxCanales = 256;
+
+    /**
+     * @brief Crea el analizador listo para recibir el primer byte.
+     */
+    AnalizadorTramas() noexcept;
+
+    /**
+     * @brief Descarta la línea parcial y vuelve al estado inicial.
+     */
+    void reiniciar() noexcept;
+
+    /**
+     * @brief Ajusta la longitud máxima por línea; las más largas se reportan como desbordadas.
+     * @param maximo Número de bytes permitidos sin contar el salto de línea.
+     */
+    void setLongitudMaxima(std::size_t maximo) noexcept;
+
+    /**
+     * @brief Consume un byte del flujo crudo.
+     * @param byte Siguiente byte recibido; '\\n' cierra la línea y un '\\r' justo antes
+     *        de él se descarta. Cualquier otro '\\r' es parte de la línea.
+     * @param salida Se llena cuando el byte completa una línea no vacía.
+     * @return true si se completó una trama en @p salida.
+     */
+    bool consumir(char byte, TramaDecodificada& salida) noexcept;
+
+    /**
+     * @brief Cierra la línea en curso como si hubiera llegado '\\n'.
+     * @param salida Se llena si la línea pendiente no estaba vacía.
+     * @return true si se completó una trama en @p salida.
+     */
+    bool finalizar(TramaDecodificada& salida) noexcept;
+
+    /**
+     * @brief Analiza una línea completa en una sola pasada.
+     * @param linea Inicio de la línea; no requiere terminador nulo.
+     * @param longitud Número de bytes válidos.
+     * @param salida Resultado del análisis.
+     * @return true si la línea contenía algo distinto de saltos de línea.
+     */
+    bool analizarLinea(const char* linea, std::size_t longitud, TramaDecodificada& salida) noexcept;
+
+private:
+    enum class Estado { Prefijo, Canal, Tipo, AntesDeCarga, Carga, DespuesDeCarga, Lote };
+    enum class EstadoNumero { Espacios, Signo, Digitos, Terminado, Invalido };
+
+    Estado _estado;
+    EstadoNumero _numero;
+    std::size_t _longitud;
+    std::size_t _maxLongitud;
+    char _prefijo;
+    std::size_t _posInicio;
+    bool _esInicio;
+    std::size_t _posFin;
+    bool _esFin;
+    bool _hayCarga;
+    std::size_t _lonCarga;
+    char _primeros[3];
+    unsigned _candidatos;
+    bool _negativo;
+    long _valor;
+    std::size_t _lonLote;
+    int _canal;
+    int _digitosCanal;
+    bool _retornoPendiente;
+    char _lote[kMaxLote];
+
+    void procesarByte(char byte) noexcept;
+    void avanzarCarga(char byte) noexcept;
+    void cerrar(TramaDecodificada& salida) const noexcept;
+};
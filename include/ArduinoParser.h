@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstddef>
+#include <sys/types.h>
+
+#include "AnalizadorBinario.h"
 
 /**
  * @file ArduinoParser.h
@@ -8,7 +11,10 @@
  */
 
 class AuxiliarCli;
+class GrabadorCaptura;
+class InstrumentacionEtapas;
 class LineaDispatcher;
+class RegistroContadores;
 
 /**
  * @brief Presets válidos para elegir el dispositivo serie.
@@ -20,11 +26,34 @@ class LineaDispatcher;
  */
 enum class Preset { ACM0, USB0, Custom };
 
+/**
+ * @brief Forma en que se entregan los datos leídos al LineaDispatcher.
+ *
+ * - ModoLectura::Lineas delimita líneas y las entrega en lotes de vistas.
+ * - ModoLectura::Flujo entrega los bytes crudos y el dispatcher los analiza al vuelo.
+ */
+enum class ModoLectura { Lineas, Flujo };
+
+/**
+ * @brief Perfil de E/S del puerto serie: cuándo despierta read() y cuánto lee.
+ *
+ * - PerfilEntrada::Estandar: VMIN=0/VTIME=1 y descriptor bloqueante (comportamiento histórico).
+ * - PerfilEntrada::BajaLatencia: VMIN=1/VTIME=0, ASYNC_LOW_LATENCY en el controlador y
+ *   descriptor no bloqueante que se drena hasta EAGAIN en cada despertar.
+ * - PerfilEntrada::Rendimiento: VMIN=255/VTIME=1 para agrupar bytes en el kernel,
+ *   sin ASYNC_LOW_LATENCY y con bloques de lectura de 64 KB.
+ */
+enum class PerfilEntrada { Estandar, BajaLatencia, Rendimiento };
+
 /**
  * @brief Gestiona las lecturas crudas del puerto serie y las reenvía.
  *
  * Esta clase solo entrega cada línea completa al LineaDispatcher configurado.
  * Cualquier detalle de configuración POSIX se realiza en la implementación.
+ *
+ * En modo ModoLectura::Lineas la línea "INICIO-BIN" cambia la delimitación: los bytes
+ * siguientes se separan en bloques binarios verificados por CRC, que se entregan con
+ * LineaDispatcher::onBloqueBinario() hasta la operación Fin.
  */
 class ArduinoParser {
 public:
@@ -35,6 +64,14 @@ public:
      */
     explicit ArduinoParser(AuxiliarCli* logger = nullptr, LineaDispatcher* target = nullptr) noexcept;
 
+    /**
+     * @brief Cierra el puerto si sigue abierto y libera el buffer de lectura.
+     */
+    ~ArduinoParser();
+
+    ArduinoParser(const ArduinoParser&) = delete;
+    ArduinoParser& operator=(const ArduinoParser&) = delete;
+
     /**
      * @brief Define el preset que resolverá la ruta del dispositivo serie.
      * @param p Nuevo preset a emplear al abrir el puerto.
@@ -53,16 +90,73 @@ public:
 
     /**
      * @brief Ajusta el baudrate que se intentará aplicar al abrir el puerto.
-     * @param baud Valor deseado; por defecto 115200 (configuración 8N1 sin flow control).
+     * @param baud Valor deseado, estándar o arbitrario; por defecto 115200 (configuración 8N1 sin flow control).
      */
     void setBaudrate(unsigned baud = 115200) noexcept;
 
+    /**
+     * @brief Ajusta la longitud máxima aceptada por línea; las más largas se descartan.
+     * @param maximo Número de bytes permitidos sin contar el salto de línea (mínimo 1).
+     */
+    void setLongitudMaximaLinea(std::size_t maximo) noexcept;
+
+    /**
+     * @brief Devuelve la longitud máxima aceptada por línea.
+     * @return Número de bytes permitidos por línea.
+     */
+    std::size_t getLongitudMaximaLinea() const noexcept;
+
+    /**
+     * @brief Define cómo se entregarán los datos leídos al dispatcher.
+     * @param modo Modo de entrega; por defecto ModoLectura::Lineas.
+     */
+    void setModoLectura(ModoLectura modo) noexcept;
+
+    /**
+     * @brief Define el perfil de E/S que se aplicará al abrir el puerto.
+     * @param perfil Perfil deseado; por defecto PerfilEntrada::Estandar.
+     */
+    void setPerfil(PerfilEntrada perfil) noexcept;
+
+    /**
+     * @brief Devuelve el perfil de E/S configurado.
+     * @return Perfil activo.
+     */
+    PerfilEntrada getPerfil() const noexcept;
+
     /**
      * @brief Cambia el objetivo que recibirá las líneas crudas.
      * @param target Instancia de LineaDispatcher; puede ser nula para desactivar el reenvío.
      */
     void setTarget(LineaDispatcher* target) noexcept;
 
+    /**
+     * @brief Define el grabador que recibirá una copia de cada lectura del puerto.
+     * @param grabador Grabador abierto; nullptr desactiva la grabación.
+     */
+    void setGrabador(GrabadorCaptura* grabador) noexcept;
+
+    /**
+     * @brief Define el colector de latencias por etapa (solo con PRT7_INSTRUMENTACION).
+     *
+     * Debe ser el mismo que recibe el LineaDispatcher destino. Durante
+     * listenUntilEnter(), SIGUSR1 imprime un reporte parcial si se instaló
+     * InstrumentacionEtapas::instalarSenalReporte().
+     *
+     * @param instrumentacion Colector; nullptr desactiva las marcas.
+     */
+    void setInstrumentacion(InstrumentacionEtapas* instrumentacion) noexcept;
+
+    /**
+     * @brief Define el registro donde se cuentan bytes, lecturas, descartes y fallos del puerto.
+     *
+     * Durante la captura, SIGUSR2 escribe el archivo de métricas si se instaló
+     * RegistroContadores::instalarSenalVolcado().
+     *
+     * @param contadores Registro compartido con el LineaDispatcher; puede ser nulo.
+     */
+    void setContadores(RegistroContadores* contadores) noexcept;
+
     /**
      * @brief Devuelve el preset actualmente configurado.
      * @return Valor del preset activo.
@@ -81,6 +175,17 @@ public:
      */
     bool openPort();
 
+    /**
+     * @brief Abre y configura una ruta concreta sin pasar por los presets.
+     *
+     * Pensado para pty de prueba como las de prt7_emulador; el menú sigue usando
+     * solo los presets.
+     *
+     * @param ruta Ruta del dispositivo serie o pty.
+     * @return true si el descriptor se abrió y configuró correctamente.
+     */
+    bool openPath(const char* ruta);
+
     /**
      * @brief Cierra el descriptor abierto, si existe.
      */
@@ -89,13 +194,38 @@ public:
     /**
      * @brief Inicia el ciclo de lectura hasta que el usuario presione ENTER en STDIN.
      *
-     * Cada línea terminada en '\n' debe reenviarse mediante LineaDispatcher::onRawLine().
+     * Se lee el puerto en bloques grandes y todas las líneas completas de cada lectura
+     * se entregan juntas, sin copiarlas, mediante LineaDispatcher::onRawLines().
      * LineaDispatcher es quien valida y procesa cada cadena recibida.
      *
      * @return true cuando el bucle concluyó sin fallas fatales; false en caso de error.
      */
     bool listenUntilEnter();
 
+    /**
+     * @brief Igual que listenUntilEnter(), pero con lectura, decodificación y salida en hilos separados.
+     *
+     * Ver TuberiaCaptura. El mensaje decodificado se escribe en @p salidaFd y al final se
+     * reportan los contadores de espera y descarte de cada etapa.
+     *
+     * @param salidaFd Descriptor de los mensajes, normalmente STDOUT_FILENO.
+     * @return true cuando la captura concluyó sin fallas de lectura.
+     */
+    bool listenEnTuberia(int salidaFd);
+
+    /**
+     * @brief Entrega bytes crudos como si se hubieran leído del puerto.
+     *
+     * Sigue el mismo camino que una lectura real según el modo de lectura, por lo
+     * que las líneas partidas entre llamadas se reconstruyen igual. Lo usa
+     * ReproductorCaptura para reproducir capturas grabadas.
+     *
+     * @param datos Bytes a entregar.
+     * @param cantidad Número de bytes.
+     * @return false si no se pudo reservar el buffer de lectura.
+     */
+    bool alimentar(const char* datos, std::size_t cantidad);
+
     /**
      * @brief Devuelve la ruta predeterminada asociada a un preset dado.
      * @param p Preset a consultar.
@@ -103,8 +233,54 @@ public:
      */
     static const char* defaultPathFor(Preset p) noexcept;
 
+    /**
+     * @brief Nombre de un perfil de E/S tal como se acepta en la línea de comandos.
+     * @param perfil Perfil a describir.
+     * @return "estandar", "baja-latencia" o "rendimiento".
+     */
+    static const char* nombrePerfil(PerfilEntrada perfil) noexcept;
+
+    /**
+     * @brief Interpreta el nombre de un perfil de E/S.
+     * @param nombre Texto recibido ("estandar", "baja-latencia" o "rendimiento").
+     * @param perfil Recibe el perfil si el nombre es válido.
+     * @return true si el nombre se reconoció.
+     */
+    static bool interpretarPerfil(const char* nombre, PerfilEntrada& perfil) noexcept;
+
+    /**
+     * @brief Abre un dispositivo serie (o pty) y lo configura en modo 8N1 crudo.
+     * @param ruta Ruta del dispositivo.
+     * @param baud Baudrate deseado; los que no tienen constante Bxxx se aplican con
+     *             termios2/BOTHER y, si el controlador no lo admite, se usa 115200.
+     * @param bloqueante Si es false, el descriptor conserva O_NONBLOCK para usarse con epoll.
+     * @param logger Logger opcional para reportar fallas.
+     * @param perfil Perfil de E/S; PerfilEntrada::BajaLatencia siempre deja O_NONBLOCK.
+     * @return Descriptor abierto o -1 en caso de error.
+     */
+    static int abrirDispositivo(const char* ruta, unsigned baud, bool bloqueante, AuxiliarCli* logger,
+                                PerfilEntrada perfil = PerfilEntrada::Estandar);
+
+    /**
+     * @brief Prueba baudrates candidatos y elige el que produce tramas PRT-7 válidas.
+     *
+     * Cada candidato se escucha hasta @p msPorCandidato milisegundos; a una velocidad
+     * equivocada llegan bytes sin sentido que el analizador rechaza. La búsqueda se
+     * detiene en cuanto un candidato acumula suficientes tramas válidas. El
+     * dispositivo debe estar transmitiendo mientras se detecta.
+     *
+     * @param ruta Ruta del dispositivo.
+     * @param logger Logger opcional para reportar el resultado de cada candidato.
+     * @param msPorCandidato Tiempo máximo de escucha por candidato.
+     * @return Baudrate detectado, o 0 si ningún candidato fue concluyente.
+     */
+    static unsigned detectarBaudrate(const char* ruta, AuxiliarCli* logger, unsigned msPorCandidato = 500);
+
 private:
     static const std::size_t kMaxRuta = 255;
+    static const std::size_t kBloqueLectura = 4096;
+    static const std::size_t kBloqueRendimiento = 64 * 1024;
+    static const std::size_t kMaxLote = 256;
 
     int _fd;
     Preset _preset;
@@ -112,4 +288,20 @@ private:
     char _customPath[kMaxRuta + 1];
     AuxiliarCli* _logger;
     LineaDispatcher* _target;
+    GrabadorCaptura* _grabador;
+    InstrumentacionEtapas* _instrumentacion;
+    RegistroContadores* _contadores;
+    std::size_t _maxLinea;
+    ModoLectura _modo;
+    PerfilEntrada _perfil;
+    char* _buffer;
+    std::size_t _capacidad;
+    std::size_t _usados;
+    bool _desbordado;
+    bool _binario;
+    AnalizadorBinario _analizadorBinario;
+
+    bool prepararBuffer();
+    ssize_t leerPuerto();
+    void despacharLineas();
 };
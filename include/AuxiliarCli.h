@@ -1,56 +1,187 @@
 #ifndef AUXILIARCLI_H
 #define AUXILIARCLI_H
 
+#include <atomic>
 #include <iostream>
 #include <limits>
 #include <cstring>
+#include <thread>
+
+#include "ColaSpsc.h"
+#include "EventoEspera.h"
 
 /**
  * @file AuxiliarCli.h
  * @brief Utilidades para interacción en consola y mensajes coloreados.
  */
+
+/**
+ * @brief Nivel máximo de log compilado; los niveles superiores desaparecen del binario.
+ *
+ * 0 = solo ERROR, 1 = +WARNING, 2 = +SUCCESS, 3 = +STATUS, 4 = +detalle por trama.
+ */
+#ifndef PRT7_NIVEL_LOG
+#define PRT7_NIVEL_LOG 4
+#endif
+
+/**
+ * @brief Niveles de log en orden de severidad.
+ */
+enum class NivelLog { Error = 0, Warning = 1, Success = 2, Status = 3, Detalle = 4 };
+
+struct RegistroLog;
+
+/**
+ * @brief Función que convierte un registro en texto; se ejecuta en el hilo de escritura.
+ */
+typedef void (*FormateadorLog)(const RegistroLog& registro, char* destino, std::size_t tam);
+
+/**
+ * @brief Argumentos crudos de un mensaje pendiente de formatear.
+ */
+struct RegistroLog {
+    static const std::size_t kMaxTexto = 192;
+
+    NivelLog nivel;
+    int color;
+    char tipo[12];
+    FormateadorLog formatear;
+    long enteros[3];
+    std::size_t longitudTexto;
+    char texto[kMaxTexto];
+};
+
 /**
  * @brief Auxilia a la interfaz de consola con logs y lectura validada.
+ *
+ * Los mensajes se filtran por nivel en compilación (PRT7_NIVEL_LOG) y en ejecución
+ * (setNivel()). En modo asíncrono el hilo que registra solo encola los argumentos;
+ * un hilo de fondo los formatea y escribe en lotes. Si la cola se llena, el hilo
+ * que registra espera en lugar de perder mensajes y la espera se contabiliza.
+ * Un texto que no cabe en un registro se escribe directo, después de vaciar la
+ * cola y con los demás productores en espera, así que el orden se conserva.
  */
 class AuxiliarCli
 {
 public:
-    AuxiliarCli() = default;
+    AuxiliarCli() noexcept;
+
+    /**
+     * @brief Detiene el hilo de escritura si sigue activo.
+     */
+    ~AuxiliarCli();
+
+    AuxiliarCli(const AuxiliarCli&) = delete;
+    AuxiliarCli& operator=(const AuxiliarCli&) = delete;
+
+    /**
+     * @brief Indica si un nivel fue compilado en el binario.
+     * @param nivel Nivel a consultar.
+     * @return true si el nivel no excede PRT7_NIVEL_LOG.
+     */
+    static constexpr bool nivelCompilado(NivelLog nivel)
+    {
+        return static_cast<int>(nivel) <= PRT7_NIVEL_LOG;
+    }
+
+    /**
+     * @brief Indica si un mensaje del nivel dado se emitirá; permite omitir su formateo.
+     * @param nivel Nivel del mensaje.
+     * @return true si el nivel está compilado y habilitado en ejecución.
+     */
+    bool habilitado(NivelLog nivel) const noexcept
+    {
+        return nivelCompilado(nivel) && static_cast<int>(nivel) <= _nivel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Ajusta el nivel máximo que se emitirá en ejecución.
+     * @param nivel Nivel máximo permitido.
+     */
+    void setNivel(NivelLog nivel) noexcept
+    {
+        _nivel.store(static_cast<int>(nivel), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Devuelve el nivel máximo permitido en ejecución.
+     * @return Nivel actual.
+     */
+    NivelLog getNivel() const noexcept
+    {
+        return static_cast<NivelLog>(_nivel.load(std::memory_order_relaxed));
+    }
 
     /**
      * @brief Imprime un mensaje con color según la etiqueta proporcionada.
      * @param tipo Texto que describe el tipo de log (STATUS, WARNING, SUCCESS, ERROR).
      * @param msj Mensaje a desplegar.
      */
-    void imprimirLog(const char* tipo, const char* msj)
-    {
-        if (!tipo || !msj)
-        {
-            return;
-        }
+    void imprimirLog(const char* tipo, const char* msj);
 
-        int colorId = 37;
-        if (coincide(tipo, "RED") || coincide(tipo, "ERROR") || coincide(tipo, "error"))
-        {
-            colorId = 31;
-        }
-        else if (coincide(tipo, "GREEN") || coincide(tipo, "SUCCESS") || coincide(tipo, "success"))
-        {
-            colorId = 32;
-        }
-        else if (coincide(tipo, "YELLOW") || coincide(tipo, "WARNING") || coincide(tipo, "warning"))
-        {
-            colorId = 33;
-        }
-        else if (coincide(tipo, "CYAN") || coincide(tipo, "STATUS") || coincide(tipo, "status"))
-        {
-            colorId = 36;
-        }
+    /**
+     * @brief Abre una línea de log cuyo texto se escribirá por tramos.
+     *
+     * Sirve para textos que no conviene reunir en memoria. La línea se escribe
+     * directo, como un texto largo de imprimirLog(); hasta terminarLogLargo()
+     * los demás productores esperan.
+     *
+     * @param tipo Etiqueta de la línea (STATUS, WARNING, SUCCESS, ERROR).
+     * @return false si el nivel no está habilitado; entonces no se llama a terminarLogLargo().
+     */
+    bool iniciarLogLargo(const char* tipo);
 
-        std::cout << "\033[" << colorId << "m";
-        std::cout << "[" << tipo << "] " << msj << std::endl;
-        std::cout << "\033[0m";
-    }
+    /**
+     * @brief Agrega un tramo a la línea abierta con iniciarLogLargo().
+     * @param datos Bytes del tramo.
+     * @param longitud Número de bytes en @p datos.
+     */
+    void escribirLogLargo(const char* datos, std::size_t longitud);
+
+    /**
+     * @brief Cierra la línea abierta y libera a los demás productores.
+     */
+    void terminarLogLargo();
+
+    /**
+     * @brief Registra un mensaje cuyo texto se formateará después.
+     *
+     * El llamador debe verificar habilitado() antes de reunir argumentos costosos.
+     *
+     * @param nivel Nivel del mensaje.
+     * @param tipo Etiqueta que se mostrará entre corchetes.
+     * @param formatear Función que producirá el texto a partir del registro.
+     * @param a Primer entero crudo.
+     * @param b Segundo entero crudo.
+     * @param c Tercer entero crudo.
+     * @param texto Texto crudo opcional; se copia hasta RegistroLog::kMaxTexto bytes.
+     * @param longitud Número de bytes de @p texto.
+     */
+    void registrar(NivelLog nivel, const char* tipo, FormateadorLog formatear, long a = 0, long b = 0, long c = 0,
+                   const char* texto = nullptr, std::size_t longitud = 0);
+
+    /**
+     * @brief Imprime una línea sin etiqueta ni color (por ejemplo, un separador vacío).
+     * @param nivel Nivel usado para filtrar la línea.
+     * @param texto Texto a imprimir.
+     */
+    void imprimirCrudo(NivelLog nivel, const char* texto);
+
+    /**
+     * @brief Arranca el hilo de escritura en segundo plano.
+     * @return true si el modo asíncrono quedó activo.
+     */
+    bool iniciarAsincrono();
+
+    /**
+     * @brief Escribe lo pendiente, detiene el hilo y regresa al modo síncrono.
+     */
+    void detenerAsincrono();
+
+    /**
+     * @brief Espera a que todos los mensajes encolados se hayan escrito.
+     */
+    void vaciar();
 
     /**
      * @brief Solicita un dato primitivo y valida la entrada.
@@ -60,6 +191,7 @@ public:
     template <typename T>
     void obtenerDato(const char* mensaje, T& valor)
     {
+        vaciar();
         if (!mensaje)
         {
             mensaje = "Entrada";
@@ -84,6 +216,7 @@ public:
      */
     void obtenerCadena(const char* mensaje, char* destino, std::size_t capacidad)
     {
+        vaciar();
         if (!destino || capacidad == 0)
         {
             imprimirLog("WARNING", "Buffer inválido para lectura de cadena.");
@@ -111,10 +244,26 @@ public:
     }
 
 private:
-    bool coincide(const char* texto, const char* referencia) const
-    {
-        return std::strcmp(texto, referencia) == 0;
-    }
+    static const std::size_t kRegistrosEnCola = 4096;
+
+    std::atomic<int> _nivel;
+    ColaSpsc<RegistroLog, kRegistrosEnCola>* _cola;
+    std::thread _escritor;
+    std::atomic_flag _candado;
+    std::atomic<bool> _asincrono;
+    std::atomic<bool> _detener;
+    std::atomic<unsigned long> _encolados;
+    std::atomic<unsigned long> _escritos;
+    std::atomic<unsigned long> _esperas;
+    EventoEspera _hayRegistros; ///< Lo avisa emitir() al encolar; lo espera el hilo de escritura.
+    EventoEspera _progreso;     ///< Lo avisa el hilo de escritura al liberar o escribir registros.
+    bool _largoBloqueado;
+
+    void emitir(RegistroLog& registro);
+    void escribirEnFondo();
+    static std::size_t formatearLinea(const RegistroLog& registro, char* destino, std::size_t tam);
+    static void escribirDirecto(const char* datos, std::size_t longitud);
+    static void clasificar(const char* tipo, NivelLog& nivel, int& color);
 };
 
 #endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "LineaDispatcher.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+class AuxiliarCli;
+
+/**
+ * @file CapturaMultiple.h
+ * @brief Captura simultánea desde varios dispositivos serie multiplexados con epoll.
+ */
+
+/**
+ * @class CapturaMultiple
+ * @brief Reparte varios dispositivos entre un grupo fijo de hilos trabajadores.
+ *
+ * Cada dispositivo tiene su propia ListaDeCarga, RotorDeMapeo y LineaDispatcher,
+ * y siempre lo atiende el mismo hilo (dispositivo i -> hilo i % hilos), por lo que
+ * el estado de sesión no necesita candados. Las rutas pueden ser puertos reales
+ * o pseudo-terminales (/dev/pts/N) para pruebas sin hardware.
+ */
+class CapturaMultiple {
+public:
+    static const std::size_t kMaxDispositivos = 128;
+
+    /**
+     * @brief Contadores de un dispositivo, leídos sin detener la captura.
+     */
+    struct Estadisticas {
+        std::uint64_t bytes;
+        std::uint64_t lecturas;
+        bool conectado;
+    };
+
+    /**
+     * @brief Construye el motor sin dispositivos.
+     * @param logger Logger para mensajes de estado; los dispatchers trabajan en silencio.
+     * @param hilos Número de hilos trabajadores (mínimo 1).
+     */
+    explicit CapturaMultiple(AuxiliarCli* logger = nullptr, std::size_t hilos = 2) noexcept;
+
+    /**
+     * @brief Detiene la captura y libera dispositivos y descriptores.
+     */
+    ~CapturaMultiple();
+
+    CapturaMultiple(const CapturaMultiple&) = delete;
+    CapturaMultiple& operator=(const CapturaMultiple&) = delete;
+
+    /**
+     * @brief Ajusta el baudrate que se aplicará a cada dispositivo.
+     * @param baud Valor deseado.
+     */
+    void setBaudrate(unsigned baud) noexcept;
+
+    /**
+     * @brief Registra un dispositivo para la siguiente captura.
+     * @param ruta Ruta del dispositivo serie o pty.
+     * @return false si se alcanzó kMaxDispositivos o la ruta es inválida.
+     */
+    bool agregarDispositivo(const char* ruta);
+
+    /**
+     * @brief Devuelve el número de dispositivos registrados.
+     * @return Cantidad de dispositivos.
+     */
+    std::size_t totalDispositivos() const noexcept;
+
+    /**
+     * @brief Abre los dispositivos y arranca los hilos trabajadores.
+     * @return true si al menos un dispositivo quedó abierto.
+     */
+    bool iniciar();
+
+    /**
+     * @brief Señala a los hilos que terminen y espera a que concluyan.
+     */
+    void detener();
+
+    /**
+     * @brief Ejecuta la captura hasta que el usuario presione ENTER y reporta los resultados.
+     * @return true si la captura pudo iniciarse.
+     */
+    bool ejecutarHastaEnter();
+
+    /**
+     * @brief Obtiene los contadores actuales de un dispositivo.
+     * @param indice Posición del dispositivo en el orden de registro.
+     * @return Copia de los contadores; todo en cero si el índice no existe.
+     */
+    Estadisticas estadisticas(std::size_t indice) const noexcept;
+
+    /**
+     * @brief Imprime rendimiento y mensaje ensamblado de cada dispositivo.
+     * @param segundos Duración de la captura usada para calcular el rendimiento.
+     */
+    void imprimirReporte(double segundos) const;
+
+private:
+    static const std::size_t kMaxRuta = 255;
+
+    struct Dispositivo {
+        char ruta[kMaxRuta + 1];
+        int fd;
+        ListaDeCarga carga;
+        RotorDeMapeo rotor;
+        LineaDispatcher dispatcher;
+        std::atomic<std::uint64_t> bytes;
+        std::atomic<std::uint64_t> lecturas;
+        std::atomic<bool> conectado;
+
+        Dispositivo() noexcept;
+    };
+
+    AuxiliarCli* _logger;
+    unsigned _baud;
+    std::size_t _totalHilos;
+    std::size_t _hilosActivos;
+    Dispositivo* _dispositivos[kMaxDispositivos];
+    std::size_t _cantidad;
+    // Nunca hay más hilos que dispositivos: el arreglo fijo evita reservarlos con un tamaño sin cota.
+    std::thread _hilos[kMaxDispositivos];
+    int* _epolls;
+    int _eventoParo;
+    bool _activa;
+
+    void trabajar(std::size_t hilo);
+    void cerrarDescriptores() noexcept;
+};
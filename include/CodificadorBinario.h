@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ProtocoloBinario.h"
+
+struct TramaDecodificada;
+
+/**
+ * @file CodificadorBinario.h
+ * @brief Codificador del modo binario de PRT-7 para herramientas y pruebas en el host.
+ */
+
+/**
+ * @class CodificadorBinario
+ * @brief Empaqueta operaciones PRT-7 en bloques binarios con CRC sobre un buffer del llamador.
+ *
+ * Las operaciones se acumulan en el bloque en curso; cuando la siguiente no cabe
+ * en kMaxCuerpo bytes, el bloque se cierra en el destino y se abre otro. Con
+ * setCrcPorTrama(true) cada operación viaja en su propio bloque.
+ *
+ * Ninguna operación escribe si quedan menos de kReservaSalida bytes libres en el
+ * destino: el llamador vacía el buffer (longitud(), descartarSalida()) y reintenta.
+ */
+class CodificadorBinario {
+public:
+    /**
+     * @brief Espacio libre que requiere cualquier operación (cierra a lo sumo dos bloques).
+     */
+    static const std::size_t kReservaSalida = 2 * ProtocoloBinario::kMaxTrama;
+
+    /**
+     * @brief Crea el codificador sobre un buffer de salida.
+     * @param destino Buffer donde se escriben las tramas completas.
+     * @param capacidad Bytes del buffer; debe ser al menos kReservaSalida.
+     */
+    CodificadorBinario(char* destino, std::size_t capacidad) noexcept;
+
+    /**
+     * @brief Cierra cada operación en su propio bloque (CRC por trama) en lugar de agruparlas.
+     * @param activo true para un bloque por operación; por defecto false.
+     */
+    void setCrcPorTrama(bool activo) noexcept;
+
+    /**
+     * @brief Etiqueta las operaciones siguientes con un canal lógico, como el prefijo "N:".
+     *
+     * La operación Canal se escribe solo cuando cambia el canal o empieza un bloque nuevo.
+     *
+     * @param canal Canal entre 0 y AnalizadorTramas::kMaxCanales - 1, o -1 para la sesión sin canal.
+     */
+    void setCanal(int canal) noexcept;
+
+    /**
+     * @brief Abre una sesión: escribe "INICIO-BIN" la primera vez y la operación Inicio después.
+     * @return false si no hay espacio en el destino.
+     */
+    bool agregarInicio() noexcept;
+
+    /**
+     * @brief Agrega una carga de un carácter.
+     * @return false sin espacio o si aún no se llamó a agregarInicio().
+     */
+    bool agregarCarga(char caracter) noexcept;
+
+    /**
+     * @brief Agrega una rotación del rotor.
+     * @return false sin espacio o si aún no se llamó a agregarInicio().
+     */
+    bool agregarMapa(int desplazamiento) noexcept;
+
+    /**
+     * @brief Agrega varios caracteres de carga; se reparten en operaciones que quepan en un bloque.
+     * @param datos Caracteres literales.
+     * @param cantidad Número de caracteres, como máximo AnalizadorTramas::kMaxLote.
+     * @return false sin espacio, fuera de sesión o si @p cantidad excede el máximo.
+     */
+    bool agregarLote(const char* datos, std::size_t cantidad) noexcept;
+
+    /**
+     * @brief Agrega una marca de tiempo de envío en nanosegundos.
+     * @return false sin espacio o si aún no se llamó a agregarInicio().
+     */
+    bool agregarMarca(std::uint64_t nanosegundos) noexcept;
+
+    /**
+     * @brief Agrega el cierre del mensaje en curso; la sesión sigue abierta.
+     * @return false sin espacio o si aún no se llamó a agregarInicio().
+     */
+    bool agregarFinMensaje() noexcept;
+
+    /**
+     * @brief Agrega una trama de texto ya analizada (INICIO, L, M, B, T o FIN), con su canal.
+     * @param trama Resultado de AnalizadorTramas; las inválidas se ignoran.
+     * @return false si la trama no se codificó.
+     */
+    bool agregar(const TramaDecodificada& trama) noexcept;
+
+    /**
+     * @brief Escribe la operación Fin y cierra el bloque; el enlace vuelve a modo texto.
+     * @return false sin espacio o fuera del modo binario.
+     */
+    bool agregarFin() noexcept;
+
+    /**
+     * @brief Cierra el bloque en curso aunque tenga espacio libre.
+     */
+    void cerrarBloque() noexcept;
+
+    /**
+     * @brief Bytes de tramas completas escritos en el destino.
+     * @return Bytes listos para enviar.
+     */
+    std::size_t longitud() const noexcept;
+
+    /**
+     * @brief Indica que el contenido del destino ya se envió; el bloque en curso se conserva.
+     */
+    void descartarSalida() noexcept;
+
+private:
+    char* _destino;
+    std::size_t _capacidad;
+    std::size_t _usados;
+    bool _enBinario;
+    bool _crcPorTrama;
+    std::size_t _lonCuerpo;
+    int _canal;
+    int _canalBloque;
+    unsigned char _cuerpo[ProtocoloBinario::kMaxCuerpo];
+
+    bool hayEspacio() const noexcept;
+    void agregarOperacion(const unsigned char* operacion, std::size_t longitud) noexcept;
+};
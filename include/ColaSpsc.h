@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file ColaSpsc.h
+ * @brief Cola acotada sin candados para un productor y un consumidor.
+ */
+
+/**
+ * @class ColaSpsc
+ * @brief Anillo de capacidad fija que un hilo llena y otro hilo vacía.
+ *
+ * Los elementos se escriben y leen en su lugar: el productor pide un espacio
+ * con espacioLibre(), lo llena y lo publica; el consumidor toma frente() y lo
+ * libera. Ninguna operación bloquea ni reserva memoria.
+ *
+ * @tparam T Tipo de elemento almacenado.
+ * @tparam Capacidad Número de espacios; debe ser potencia de dos.
+ */
+template <typename T, std::size_t Capacidad>
+class ColaSpsc {
+    static_assert(Capacidad >= 2 && (Capacidad & (Capacidad - 1)) == 0, "La capacidad debe ser potencia de dos.");
+
+public:
+    ColaSpsc() noexcept : _cabeza(0), _cola(0) {}
+
+    ColaSpsc(const ColaSpsc&) = delete;
+    ColaSpsc& operator=(const ColaSpsc&) = delete;
+
+    /**
+     * @brief Devuelve el siguiente espacio disponible para el productor.
+     * @return Puntero al espacio o nulo si la cola está llena.
+     */
+    T* espacioLibre() noexcept
+    {
+        const std::size_t cola = _cola.load(std::memory_order_relaxed);
+        if (cola - _cabeza.load(std::memory_order_acquire) == Capacidad) {
+            return nullptr;
+        }
+        return &_datos[cola & (Capacidad - 1)];
+    }
+
+    /**
+     * @brief Hace visible al consumidor el espacio obtenido con espacioLibre().
+     */
+    void publicar() noexcept
+    {
+        _cola.store(_cola.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Devuelve el elemento más antiguo para el consumidor.
+     * @return Puntero al elemento o nulo si la cola está vacía.
+     */
+    T* frente() noexcept
+    {
+        const std::size_t cabeza = _cabeza.load(std::memory_order_relaxed);
+        if (cabeza == _cola.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &_datos[cabeza & (Capacidad - 1)];
+    }
+
+    /**
+     * @brief Devuelve al productor el espacio leído con frente().
+     */
+    void liberar() noexcept
+    {
+        _cabeza.store(_cabeza.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Número aproximado de elementos en la cola.
+     * @return Elementos publicados y no liberados.
+     */
+    std::size_t tamano() const noexcept
+    {
+        return _cola.load(std::memory_order_acquire) - _cabeza.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> _cabeza;
+    alignas(64) std::atomic<std::size_t> _cola;
+    alignas(64) T _datos[Capacidad];
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "LineaDispatcher.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+class AuxiliarCli;
+class RegistroContadores;
+
+/**
+ * @file DecodificadorLotes.h
+ * @brief Decodificación no interactiva de archivos de tramas o de STDIN.
+ */
+
+/**
+ * @class DecodificadorLotes
+ * @brief Decodifica un flujo completo de tramas PRT-7 y escribe solo los mensajes.
+ *
+ * Los archivos regulares se proyectan en memoria con mmap(); las tuberías y STDIN
+ * se leen en bloques grandes. Cada mensaje se escribe en una línea al terminar su
+ * sesión (nuevo INICIO o fin de la entrada).
+ */
+class DecodificadorLotes {
+public:
+    /**
+     * @brief Prepara el decodificador con estructuras propias.
+     * @param logger Logger para errores de E/S; la decodificación no genera logs.
+     */
+    explicit DecodificadorLotes(AuxiliarCli* logger = nullptr) noexcept;
+
+    DecodificadorLotes(const DecodificadorLotes&) = delete;
+    DecodificadorLotes& operator=(const DecodificadorLotes&) = delete;
+
+    /**
+     * @brief Define el registro donde se acumulan bytes, lecturas y tramas decodificadas.
+     * @param contadores Registro de métricas; puede ser nulo.
+     */
+    void setContadores(RegistroContadores* contadores) noexcept;
+
+    /**
+     * @brief Decodifica un archivo o STDIN.
+     * @param ruta Ruta del archivo de tramas, o "-" para STDIN.
+     * @param salidaFd Descriptor donde se escriben los mensajes.
+     * @return true si la entrada se leyó y la salida se escribió sin errores.
+     */
+    bool decodificarArchivo(const char* ruta, int salidaFd);
+
+    /**
+     * @brief Decodifica todo lo que se lea de un descriptor abierto.
+     * @param entradaFd Descriptor de entrada; se usa mmap() si es un archivo regular.
+     * @param salidaFd Descriptor donde se escriben los mensajes.
+     * @return true si la entrada se leyó y la salida se escribió sin errores.
+     */
+    bool decodificarDescriptor(int entradaFd, int salidaFd);
+
+    /**
+     * @brief Devuelve los bytes de entrada procesados en la última decodificación.
+     * @return Número de bytes.
+     */
+    std::uint64_t bytesProcesados() const noexcept;
+
+private:
+    static const std::size_t kBloqueLectura = 256 * 1024;
+
+    AuxiliarCli* _logger;
+    ListaDeCarga _carga;
+    RotorDeMapeo _rotor;
+    LineaDispatcher _dispatcher;
+    RegistroContadores* _contadores;
+    std::uint64_t _bytes;
+
+    bool leerProyectado(int entradaFd, std::size_t tamano);
+    bool leerEnBloques(int entradaFd);
+    void error(const char* mensaje) const;
+};
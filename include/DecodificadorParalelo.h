@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class AuxiliarCli;
+class RegistroContadores;
+
+/**
+ * @file DecodificadorParalelo.h
+ * @brief Decodificación de archivos de tramas grabados repartida entre varios hilos.
+ */
+
+/**
+ * @class DecodificadorParalelo
+ * @brief Decodifica un archivo de tramas en tramos paralelos con el mismo resultado que DecodificadorLotes.
+ *
+ * Al llegar a una trama LOAD, el rotor solo depende de si hay sesión y de la suma
+ * módulo 26 de los MAP desde el último INICIO. El archivo se corta en tramos de
+ * líneas completas y se procesa en tres pasos:
+ *
+ * 1. Cada hilo resume su tramo: si contiene INICIO, la suma de rotaciones tras el último
+ *    y si termina con un mensaje abierto o cerrado por "FIN".
+ * 2. Un barrido de prefijos sobre los resúmenes da la sesión y el desplazamiento de entrada de cada tramo.
+ * 3. Cada hilo decodifica su tramo con un LineaDispatcher propio arrancado en ese estado.
+ *
+ * La salida de cada tramo se acumula en memoria y se escribe en orden. Las entradas
+ * que no son archivos regulares se delegan en DecodificadorLotes; las que usan canales
+ * "N:" o el modo binario, cuyo estado no se reduce a una suma, se decodifican en un solo tramo.
+ */
+class DecodificadorParalelo {
+public:
+    /**
+     * @brief Máximo de hilos por grupo; más allá solo se suman cambios de contexto.
+     */
+    static const std::size_t kMaxHilos = 256;
+
+    /**
+     * @brief Prepara el decodificador.
+     * @param hilos Número de hilos, como máximo kMaxHilos; 0 usa todos los núcleos disponibles.
+     * @param logger Logger para errores de E/S; la decodificación no genera logs.
+     */
+    explicit DecodificadorParalelo(std::size_t hilos = 0, AuxiliarCli* logger = nullptr) noexcept;
+
+    DecodificadorParalelo(const DecodificadorParalelo&) = delete;
+    DecodificadorParalelo& operator=(const DecodificadorParalelo&) = delete;
+
+    /**
+     * @brief Define el registro donde se acumulan bytes, lecturas y tramas decodificadas.
+     * @param contadores Registro de métricas; puede ser nulo.
+     */
+    void setContadores(RegistroContadores* contadores) noexcept;
+
+    /**
+     * @brief Decodifica un archivo o STDIN.
+     * @param ruta Ruta del archivo de tramas, o "-" para STDIN.
+     * @param salidaFd Descriptor donde se escriben los mensajes.
+     * @return true si la entrada se leyó y la salida se escribió sin errores.
+     */
+    bool decodificarArchivo(const char* ruta, int salidaFd);
+
+    /**
+     * @brief Decodifica un descriptor abierto; solo los archivos regulares se reparten entre hilos.
+     * @param entradaFd Descriptor de entrada.
+     * @param salidaFd Descriptor donde se escriben los mensajes.
+     * @return true si la entrada se leyó y la salida se escribió sin errores.
+     */
+    bool decodificarDescriptor(int entradaFd, int salidaFd);
+
+    /**
+     * @brief Decodifica un flujo completo de tramas que ya está en memoria.
+     * @param datos Tramas de texto; una última línea sin '\n' también cuenta.
+     * @param longitud Bytes de @p datos.
+     * @param salidaFd Descriptor donde se escriben los mensajes.
+     * @return true si la salida se escribió sin errores.
+     */
+    bool decodificarMemoria(const char* datos, std::size_t longitud, int salidaFd);
+
+    /**
+     * @brief Devuelve en cuántos tramos se repartió la última decodificación.
+     * @return Número de tramos; 1 si se decodificó de forma secuencial.
+     */
+    std::size_t tramosUsados() const noexcept;
+
+private:
+    /**
+     * @brief Tamaño mínimo de un tramo; por debajo no compensa lanzar otro hilo.
+     */
+    static const std::size_t kMinTramo = 256 * 1024;
+
+    struct Tramo;
+
+    AuxiliarCli* _logger;
+    RegistroContadores* _contadores;
+    std::size_t _hilos;
+    std::size_t _tramos;
+
+    static void resumir(Tramo* tramo);
+    static void decodificar(Tramo* tramo);
+    static void ejecutar(void (*tarea)(Tramo*), Tramo* tramos, std::size_t cantidad);
+    void error(const char* mensaje) const;
+};
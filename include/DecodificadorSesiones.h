@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "IndiceSesiones.h"
+
+class AuxiliarCli;
+class RegistroContadores;
+class SalidaMensaje;
+
+/**
+ * @file DecodificadorSesiones.h
+ * @brief Decodificación por sesiones de un archivo de tramas o de una captura, guiada por su índice.
+ */
+
+/**
+ * @class DecodificadorSesiones
+ * @brief Decodifica las sesiones de una fuente indexada en paralelo o salta directo a una de ellas.
+ *
+ * Al abrir la fuente se usa "<fuente>.idx" si existe y corresponde al archivo; si no,
+ * se construye con una pasada y se intenta guardar para la próxima vez. Las
+ * capturas se entregan a un ArduinoParser, igual que `program -r`; los archivos de
+ * texto, al analizador de flujo, igual que `program -d`.
+ *
+ * Un grupo fijo de hilos toma las sesiones en orden y cada una se decodifica con su
+ * propio estado en una SalidaMemoria; el hilo llamador las escribe en orden. Como
+ * mucho kVentana sesiones esperan en memoria a ser escritas.
+ */
+class DecodificadorSesiones {
+public:
+    /**
+     * @brief Sesiones decodificadas que pueden esperar su turno de escritura.
+     */
+    static const std::size_t kVentana = 256;
+
+    /**
+     * @brief Prepara el decodificador sin fuente.
+     * @param hilos Número de hilos; 0 usa todos los núcleos disponibles.
+     * @param logger Logger para errores; la decodificación no genera logs.
+     */
+    explicit DecodificadorSesiones(std::size_t hilos = 0, AuxiliarCli* logger = nullptr) noexcept;
+
+    /**
+     * @brief Libera la proyección de la fuente.
+     */
+    ~DecodificadorSesiones();
+
+    DecodificadorSesiones(const DecodificadorSesiones&) = delete;
+    DecodificadorSesiones& operator=(const DecodificadorSesiones&) = delete;
+
+    /**
+     * @brief Define el registro donde se suman las tramas y sesiones decodificadas.
+     * @param contadores Registro de métricas; puede ser nulo.
+     */
+    void setContadores(RegistroContadores* contadores) noexcept;
+
+    /**
+     * @brief Proyecta la fuente y carga o construye su índice.
+     * @param ruta Archivo de tramas o captura "PRT7CAP1".
+     * @param reconstruir true para ignorar el índice guardado y volver a escribirlo.
+     * @return false si el archivo no se pudo abrir o la captura está dañada.
+     */
+    bool abrir(const char* ruta, bool reconstruir = false);
+
+    /**
+     * @brief Libera la fuente abierta.
+     */
+    void cerrar() noexcept;
+
+    /**
+     * @brief Devuelve el índice de la fuente abierta.
+     */
+    const IndiceSesiones& indice() const noexcept;
+
+    /**
+     * @brief Indica si el índice se leyó de disco en lugar de construirse.
+     */
+    bool indiceReutilizado() const noexcept;
+
+    /**
+     * @brief Decodifica solo la sesión @p n sin recorrer las anteriores.
+     * @param n Sesión, desde 0.
+     * @param salidaFd Descriptor donde se escribe el mensaje.
+     * @return false si la sesión no existe, las sesiones no son independientes o falló la escritura.
+     */
+    bool decodificarSesion(std::size_t n, int salidaFd);
+
+    /**
+     * @brief Decodifica la fuente completa repartiendo las sesiones entre los hilos.
+     *
+     * Si las sesiones no son independientes (canales o modo binario) se decodifica
+     * de principio a fin en el hilo llamador.
+     *
+     * @param salidaFd Descriptor donde se escriben los mensajes.
+     * @return false si falló la escritura o la captura está dañada.
+     */
+    bool decodificarTodas(int salidaFd);
+
+private:
+    struct Trabajador;
+    struct Ranura;
+
+    AuxiliarCli* _logger;
+    RegistroContadores* _contadores;
+    std::size_t _hilos;
+    IndiceSesiones _indice;
+    const char* _fuente;
+    std::size_t _tamano;
+    bool _reutilizado;
+
+    Ranura* _ranuras;
+    std::size_t _regiones;
+    std::atomic<std::size_t> _siguiente;
+    std::atomic<std::size_t> _escritas;
+
+    bool decodificarRegion(std::size_t region, Trabajador& trabajador, SalidaMensaje& salida) const;
+    bool decodificarRango(const PosicionFuente& desde, const PosicionFuente* hasta, Trabajador& trabajador,
+                          SalidaMensaje& salida) const;
+    void trabajar(Trabajador* trabajador);
+    void sumarContadores(const Trabajador& trabajador) const;
+    void error(const char* mensaje) const;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+/**
+ * @file DestinoMensajes.h
+ * @brief Abre el destino de los mensajes decodificados: archivo, socket Unix o TCP.
+ *
+ * Especificaciones aceptadas:
+ *
+ * - "unix:RUTA": se conecta a un socket de flujo Unix ya escuchando en RUTA.
+ * - "tcp:HOST:PUERTO": se conecta por TCP (IPv4 o IPv6) a HOST:PUERTO.
+ * - Cualquier otra cosa es la ruta de un archivo, que se crea o se trunca.
+ */
+
+namespace DestinoMensajes {
+
+/**
+ * @brief Clase de destino que indica una especificación.
+ */
+enum class TipoDestino { Archivo, SocketUnix, SocketTcp };
+
+/**
+ * @brief Clasifica una especificación sin abrirla.
+ * @param especificacion Texto recibido en `-o` o en el menú.
+ * @return Tipo de destino; nullptr se trata como archivo.
+ */
+TipoDestino clasificar(const char* especificacion) noexcept;
+
+/**
+ * @brief Abre el destino para escritura.
+ *
+ * Con un socket se ignora SIGPIPE en todo el proceso: si el receptor se va, la
+ * escritura falla con EPIPE y la salida lo reporta en lugar de terminar el programa.
+ *
+ * @param especificacion Archivo, "unix:RUTA" o "tcp:HOST:PUERTO".
+ * @return Descriptor abierto, o -1 si no se pudo abrir o conectar.
+ */
+int abrir(const char* especificacion) noexcept;
+
+} // namespace DestinoMensajes
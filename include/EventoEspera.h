@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file EventoEspera.h
+ * @brief Espera bloqueante entre hilos sobre un futex, para acompañar a ColaSpsc.
+ */
+
+/**
+ * @class EventoEspera
+ * @brief Duerme a un hilo hasta que otro avise que una condición pudo cambiar.
+ *
+ * El hilo que espera se anota, vuelve a evaluar la condición y solo entonces duerme
+ * en el futex; el que avisa solo entra al kernel si hay alguien anotado, así que
+ * notificar() sin hilos dormidos cuesta una barrera y una lectura. La condición se
+ * revisa siempre después de anotarse, por lo que un aviso no se pierde aunque llegue
+ * entre la revisión y la llamada a dormir.
+ */
+class EventoEspera {
+public:
+    EventoEspera() noexcept;
+
+    EventoEspera(const EventoEspera&) = delete;
+    EventoEspera& operator=(const EventoEspera&) = delete;
+
+    /**
+     * @brief Bloquea hasta que @p lista() sea verdadera, llegue un aviso o pase @p maxMs.
+     * @param lista Condición sin efectos secundarios; se evalúa antes y después de anotarse.
+     * @param maxMs Tope de la espera en milisegundos; negativo espera sin tope.
+     * @return Valor de lista() al regresar.
+     */
+    template <typename Condicion>
+    bool esperar(Condicion lista, int maxMs) noexcept
+    {
+        if (lista()) {
+            return true;
+        }
+        _esperando.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::uint32_t secuencia = _secuencia.load(std::memory_order_acquire);
+        if (!lista()) {
+            dormir(secuencia, maxMs);
+        }
+        _esperando.fetch_sub(1, std::memory_order_relaxed);
+        return lista();
+    }
+
+    /**
+     * @brief Despierta a los hilos dormidos en esperar(); llamar tras publicar el cambio.
+     */
+    void notificar() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_esperando.load(std::memory_order_relaxed) > 0) {
+            despertar();
+        }
+    }
+
+private:
+    std::atomic<std::uint32_t> _secuencia;
+    std::atomic<std::uint32_t> _esperando;
+
+    void dormir(std::uint32_t secuencia, int maxMs) noexcept;
+    void despertar() noexcept;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file GrabadorCaptura.h
+ * @brief Grabación del flujo crudo del puerto serie con marcas de tiempo monotónicas.
+ *
+ * Formato del archivo (solo se agrega al final, nunca se reescribe):
+ *
+ * - Cabecera de 8 bytes "PRT7CAP1", escrita solo cuando el archivo está vacío.
+ * - Secuencia de registros, cada uno con un byte de tipo:
+ *   - 'S' inicio de segmento: varint con el baudrate. Cada grabación abre un
+ *     segmento y sus tiempos cuentan desde cero.
+ *   - 'D' datos: varint con los microsegundos transcurridos desde el registro
+ *     anterior del segmento, varint con la longitud y los bytes tal como llegaron.
+ *
+ * Los varint son LEB128 sin signo (7 bits por byte, el bit alto indica continuación),
+ * así una lectura típica de pocos bytes ocupa tres o cuatro bytes de cabecera.
+ */
+
+namespace FormatoCaptura {
+
+/** @brief Cabecera que identifica el archivo y su versión. */
+static const char kFirma[8] = {'P', 'R', 'T', '7', 'C', 'A', 'P', '1'};
+/** @brief Tipo de registro que abre un segmento de grabación. */
+static const unsigned char kSegmento = 'S';
+/** @brief Tipo de registro con bytes leídos del puerto. */
+static const unsigned char kDatos = 'D';
+
+/**
+ * @brief Registro de una captura ya validado.
+ */
+struct Registro {
+    unsigned char tipo;    ///< kSegmento o kDatos.
+    std::uint64_t valor;   ///< Baudrate ('S') o microsegundos desde el registro anterior ('D').
+    std::size_t datos;     ///< Desplazamiento del primer byte de datos ('D').
+    std::size_t longitud;  ///< Bytes de datos ('D'); 0 en un segmento.
+};
+
+/**
+ * @brief Lee el registro que empieza en @p pos y deja @p pos en el siguiente.
+ *
+ * Lector único del formato: lo comparten ReproductorCaptura, IndiceSesiones y la
+ * reapertura de GrabadorCaptura. No comprueba que un 'D' esté dentro de un segmento.
+ * @param fuente Bytes del archivo completo (incluida la firma).
+ * @param tamano Bytes disponibles en @p fuente.
+ * @param pos Desplazamiento del byte de tipo; solo avanza si el registro es válido.
+ * @param registro Recibe el registro leído.
+ * @return false al final del archivo o si el registro está truncado o dañado.
+ */
+bool leerRegistro(const unsigned char* fuente, std::size_t tamano, std::size_t& pos, Registro& registro) noexcept;
+
+} // namespace FormatoCaptura
+
+/**
+ * @class GrabadorCaptura
+ * @brief Agrega al archivo de captura cada bloque leído junto con su instante de llegada.
+ *
+ * Los registros se acumulan en un buffer propio y se escriben en bloques grandes para
+ * no añadir una llamada al sistema por cada lectura del puerto. El buffer también se
+ * vacía cuando pasa kIntervaloVaciadoMs desde la última escritura, así una caída del
+ * proceso pierde como mucho ese intervalo de captura. No es seguro usar una misma
+ * instancia desde varios hilos a la vez.
+ */
+class GrabadorCaptura {
+public:
+    /** @brief Tiempo máximo que un registro espera en el buffer antes de escribirse. */
+    static const int kIntervaloVaciadoMs = 1000;
+
+    GrabadorCaptura() noexcept;
+
+    /**
+     * @brief Vacía lo pendiente y cierra el archivo.
+     */
+    ~GrabadorCaptura();
+
+    GrabadorCaptura(const GrabadorCaptura&) = delete;
+    GrabadorCaptura& operator=(const GrabadorCaptura&) = delete;
+
+    /**
+     * @brief Abre (o crea) el archivo en modo de solo agregado e inicia un segmento.
+     * @param ruta Ruta del archivo de captura.
+     * @param baud Baudrate del puerto, guardado como referencia en el segmento.
+     *
+     * Si el archivo ya existe se recorren sus registros y se trunca tras el último
+     * completo: una grabación anterior interrumpida a mitad de registro no debe dejar
+     * bytes sueltos delante del segmento nuevo.
+     * @return true si el archivo quedó listo para grabar; false también si ya existe
+     *         y no empieza con FormatoCaptura::kFirma.
+     */
+    bool abrir(const char* ruta, unsigned baud);
+
+    /**
+     * @brief Vacía lo pendiente y cierra el archivo.
+     * @return false si alguna escritura falló durante la grabación.
+     */
+    bool cerrar() noexcept;
+
+    /**
+     * @brief Indica si hay un archivo abierto.
+     * @return true mientras se esté grabando.
+     */
+    bool activo() const noexcept;
+
+    /**
+     * @brief Registra un bloque recién leído con el instante actual.
+     * @param datos Bytes tal como llegaron del puerto.
+     * @param longitud Número de bytes.
+     */
+    void registrar(const char* datos, std::size_t longitud) noexcept;
+
+    /**
+     * @brief Escribe lo pendiente si lleva más de kIntervaloVaciadoMs en el buffer.
+     *
+     * Lo llama el bucle de lectura cuando el puerto queda en silencio, para que los
+     * últimos registros no esperen a la siguiente lectura o al cierre.
+     */
+    void vaciarSiVencido() noexcept;
+
+    /**
+     * @brief Devuelve los bytes de datos grabados en el segmento actual.
+     * @return Número de bytes crudos (sin contar cabeceras).
+     */
+    std::uint64_t bytesGrabados() const noexcept;
+
+    /**
+     * @brief Devuelve los bytes de un registro incompleto descartados al abrir.
+     * @return 0 si el archivo existente terminaba en un registro completo.
+     */
+    std::uint64_t bytesDescartados() const noexcept;
+
+private:
+    static const std::size_t kCapacidad = 64 * 1024;
+
+    int _fd;
+    char* _buffer;
+    std::size_t _usados;
+    std::uint64_t _ultimoUs;
+    std::uint64_t _ultimoVaciadoUs;
+    std::uint64_t _bytes;
+    std::uint64_t _descartados;
+    bool _error;
+
+    void agregar(const void* datos, std::size_t longitud) noexcept;
+    void agregarVarint(std::uint64_t valor) noexcept;
+    bool vaciar() noexcept;
+    bool truncarIncompleto(std::size_t tamano) noexcept;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file HistogramaLatencia.h
+ * @brief Histograma log-lineal de memoria fija para latencias en nanosegundos.
+ */
+
+/**
+ * @class HistogramaLatencia
+ * @brief Cuenta muestras en cubetas log-lineales: 16 subcubetas por potencia de dos.
+ *
+ * Los valores menores que 16 se guardan exactos; el resto con un error relativo
+ * menor al 6.25 %. Ocupa siempre lo mismo (976 contadores) y registrar una muestra
+ * no reserva memoria, por lo que puede usarse dentro de la ruta crítica.
+ */
+class HistogramaLatencia {
+public:
+    HistogramaLatencia() noexcept;
+
+    /**
+     * @brief Descarta todas las muestras.
+     */
+    void reiniciar() noexcept;
+
+    /**
+     * @brief Registra una muestra.
+     * @param valor Latencia en nanosegundos.
+     */
+    void registrar(std::uint64_t valor) noexcept;
+
+    /**
+     * @brief Acumula las muestras de otro histograma.
+     * @param otro Histograma a sumar.
+     */
+    void combinar(const HistogramaLatencia& otro) noexcept;
+
+    /**
+     * @brief Devuelve el valor bajo el cual queda la fracción indicada de muestras.
+     * @param fraccion Valor entre 0 y 1 (por ejemplo 0.999 para p99.9).
+     * @return Cota superior de la cubeta correspondiente, acotada por el máximo observado.
+     */
+    std::uint64_t percentil(double fraccion) const noexcept;
+
+    /** @brief Número de muestras registradas. */
+    std::uint64_t cantidad() const noexcept;
+    /** @brief Menor muestra registrada (0 si no hay muestras). */
+    std::uint64_t minimo() const noexcept;
+    /** @brief Mayor muestra registrada. */
+    std::uint64_t maximo() const noexcept;
+    /** @brief Promedio de las muestras. */
+    double promedio() const noexcept;
+
+private:
+    static const unsigned kBitsSubcubeta = 4;
+    static const unsigned kSubcubetas = 1u << kBitsSubcubeta;
+    static const std::size_t kCubetas = (64 - kBitsSubcubeta + 1) * kSubcubetas;
+
+    std::uint64_t _cuentas[kCubetas];
+    std::uint64_t _cantidad;
+    std::uint64_t _suma;
+    std::uint64_t _minimo;
+    std::uint64_t _maximo;
+
+    static std::size_t indice(std::uint64_t valor) noexcept;
+    static std::uint64_t cotaSuperior(std::size_t indice) noexcept;
+};
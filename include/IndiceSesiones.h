@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file IndiceSesiones.h
+ * @brief Índice de inicios de sesión de un archivo de tramas o de una captura grabada.
+ *
+ * El índice se guarda junto a la fuente, en "<fuente>.idx", con enteros little-endian
+ * de tamaño fijo para poder leer la entrada N sin recorrer las anteriores:
+ *
+ * - Cabecera de 32 bytes: firma "PRT7IDX1", tamaño de la fuente (u64), número de
+ *   sesiones (u64), formato de la fuente (u8), sesiones independientes (u8) y relleno.
+ * - Una entrada de 32 bytes por sesión: registro (u64), desplazamiento dentro del
+ *   registro (u64), instante en microsegundos (u64) y segmento (u32), más relleno.
+ */
+
+namespace FormatoIndice {
+
+/** @brief Cabecera que identifica el índice y su versión. */
+static const char kFirma[8] = {'P', 'R', 'T', '7', 'I', 'D', 'X', '1'};
+/** @brief Bytes de la cabecera. */
+static const std::size_t kCabecera = 32;
+/** @brief Bytes de cada entrada. */
+static const std::size_t kEntrada = 32;
+
+} // namespace FormatoIndice
+
+/**
+ * @brief Tipo de archivo indexado.
+ *
+ * - FormatoFuente::Texto: tramas de texto tal cual (lo que decodifica `program -d`).
+ * - FormatoFuente::Captura: archivo "PRT7CAP1" de GrabadorCaptura (lo que reproduce `program -r`).
+ */
+enum class FormatoFuente : unsigned char { Texto = 0, Captura = 1 };
+
+/**
+ * @brief Posición de un byte del flujo de datos dentro de la fuente.
+ *
+ * En una captura, @c registro es el desplazamiento del registro 'D' (o 'S') en el
+ * archivo y @c dentro el byte dentro de sus datos; en texto, @c registro es el
+ * desplazamiento del byte y @c dentro vale 0.
+ */
+struct PosicionFuente {
+    std::uint64_t registro;
+    std::uint64_t dentro;
+};
+
+/**
+ * @brief Inicio de una sesión: la línea INICIO que la abre.
+ */
+struct EntradaSesion {
+    PosicionFuente posicion;
+    std::uint64_t instanteUs; ///< Microsegundos desde el inicio del segmento (0 en texto).
+    std::uint32_t segmento;   ///< Segmento de grabación, contando desde 0 (0 en texto).
+};
+
+/**
+ * @class IndiceSesiones
+ * @brief Localiza con una sola pasada las líneas INICIO de una fuente y las guarda como índice.
+ *
+ * Cada INICIO limpia la lista y el rotor, así que las sesiones se decodifican por
+ * separado y en cualquier orden. No ocurre así si la fuente usa canales "N:" o el
+ * modo binario: entonces el índice queda marcado como no independiente y el
+ * recorrido se detiene en la primera trama de ese tipo.
+ */
+class IndiceSesiones {
+public:
+    /**
+     * @brief Recibe un tramo del flujo de datos de una sesión.
+     */
+    using EntregaDatos = void (*)(void* contexto, const char* datos, std::size_t longitud);
+
+    IndiceSesiones() noexcept;
+
+    /**
+     * @brief Libera las entradas.
+     */
+    ~IndiceSesiones();
+
+    IndiceSesiones(const IndiceSesiones&) = delete;
+    IndiceSesiones& operator=(const IndiceSesiones&) = delete;
+
+    /**
+     * @brief Construye el índice recorriendo una fuente ya cargada en memoria.
+     * @param fuente Contenido completo del archivo de tramas o de la captura.
+     * @param tamano Bytes de @p fuente.
+     * @return false si la captura está truncada o no hubo memoria para las entradas.
+     */
+    bool construir(const char* fuente, std::size_t tamano);
+
+    /**
+     * @brief Escribe el índice en un archivo, reemplazándolo de forma atómica.
+     * @param ruta Ruta del índice, normalmente la de rutaIndice().
+     * @return true si el archivo quedó escrito.
+     */
+    bool guardar(const char* ruta) const;
+
+    /**
+     * @brief Carga un índice guardado y comprueba que corresponda a la fuente.
+     * @param ruta Ruta del índice.
+     * @param tamanoFuente Tamaño actual de la fuente; si no coincide el índice está obsoleto.
+     * @return false si el archivo no existe, está dañado u obsoleto.
+     */
+    bool cargar(const char* ruta, std::uint64_t tamanoFuente);
+
+    /**
+     * @brief Número de sesiones encontradas.
+     */
+    std::size_t sesiones() const noexcept;
+
+    /**
+     * @brief Devuelve el inicio de la sesión @p n (desde 0).
+     */
+    const EntradaSesion& sesion(std::size_t n) const noexcept;
+
+    /**
+     * @brief Tipo de la fuente indexada.
+     */
+    FormatoFuente formato() const noexcept;
+
+    /**
+     * @brief Indica si las sesiones pueden decodificarse por separado.
+     * @return false si la fuente usa canales o el modo binario.
+     */
+    bool independientes() const noexcept;
+
+    /**
+     * @brief Posición del primer byte de datos de la fuente (antes de la primera sesión).
+     */
+    PosicionFuente inicioDatos() const noexcept;
+
+    /**
+     * @brief Entrega en orden los datos entre dos posiciones de la fuente.
+     * @param fuente Contenido de la fuente indexada.
+     * @param tamano Bytes de @p fuente.
+     * @param desde Primer byte a entregar.
+     * @param hasta Primer byte que ya no se entrega; nullptr para llegar al final.
+     * @param entrega Función que recibe cada tramo contiguo.
+     * @param contexto Puntero que se pasa tal cual a @p entrega.
+     * @return false si la captura está dañada en ese rango.
+     */
+    bool recorrer(const char* fuente, std::size_t tamano, const PosicionFuente& desde, const PosicionFuente* hasta,
+                  EntregaDatos entrega, void* contexto) const;
+
+    /**
+     * @brief Forma la ruta del índice de una fuente agregando ".idx".
+     * @param fuente Ruta de la fuente.
+     * @param destino Buffer para la ruta del índice.
+     * @param capacidad Bytes de @p destino.
+     * @return false si la ruta no cabe.
+     */
+    static bool rutaIndice(const char* fuente, char* destino, std::size_t capacidad) noexcept;
+
+private:
+    EntradaSesion* _entradas;
+    std::size_t _cantidad;
+    std::size_t _capacidad;
+    std::uint64_t _tamanoFuente;
+    FormatoFuente _formato;
+    bool _independientes;
+
+    bool agregar(const EntradaSesion& entrada) noexcept;
+    void limpiar() noexcept;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "HistogramaLatencia.h"
+
+class AuxiliarCli;
+
+/**
+ * @file InstrumentacionEtapas.h
+ * @brief Latencia por etapa de cada trama, desde read() hasta la salida.
+ */
+
+/**
+ * @brief Activa la instrumentación de la ruta crítica (0 = desactivada).
+ *
+ * Con 0 las llamadas PRT7_INSTRUMENTAR desaparecen del binario: no se lee el reloj
+ * ni se consulta ningún puntero por trama.
+ */
+#ifndef PRT7_INSTRUMENTACION
+#define PRT7_INSTRUMENTACION 0
+#endif
+
+#if PRT7_INSTRUMENTACION
+#define PRT7_INSTRUMENTAR(instrumentacion, llamada) \
+    do {                                            \
+        if (instrumentacion) {                      \
+            (instrumentacion)->llamada;             \
+        }                                           \
+    } while (0)
+#else
+#define PRT7_INSTRUMENTAR(instrumentacion, llamada) \
+    do {                                            \
+    } while (0)
+#endif
+
+/**
+ * @brief Etapas medidas para cada trama.
+ *
+ * - Delimitacion: de read() a tener la línea separada (por lote de líneas).
+ * - Espera: tiempo detrás de las tramas anteriores del mismo lote.
+ * - Analisis: clasificación y decodificación del texto.
+ * - Mapeo: rotación del rotor en tramas MAP.
+ * - Insercion: traducción en el rotor e inserción en ListaDeCarga (TramaLoad::aplicar).
+ * - Salida: entrega del fragmento a SalidaMensaje.
+ * - Total: de read() al final del procesamiento de la trama.
+ */
+enum class EtapaTrama { Delimitacion, Espera, Analisis, Mapeo, Insercion, Salida, Total };
+
+/**
+ * @class InstrumentacionEtapas
+ * @brief Marca cada etapa con CLOCK_MONOTONIC y acumula histogramas por etapa.
+ *
+ * Cada etapa registra el tiempo desde la marca anterior de la misma trama. La
+ * memoria es fija (un HistogramaLatencia por etapa). Debe usarse desde un solo hilo.
+ */
+class InstrumentacionEtapas {
+public:
+    static const std::size_t kEtapas = static_cast<std::size_t>(EtapaTrama::Total) + 1;
+
+    InstrumentacionEtapas() noexcept;
+
+    /**
+     * @brief Descarta lo medido.
+     */
+    void reiniciar() noexcept;
+
+    /**
+     * @brief Marca el instante en que read() entregó un bloque.
+     */
+    void inicioBloque() noexcept;
+
+    /**
+     * @brief Marca el instante en que un lote de líneas quedó delimitado.
+     */
+    void finDelimitacion() noexcept;
+
+    /**
+     * @brief Comienza una trama: registra delimitación y espera en el lote.
+     */
+    void inicioTrama() noexcept;
+
+    /**
+     * @brief Registra el tiempo transcurrido desde la marca anterior en la etapa dada.
+     * @param etapa Etapa que acaba de terminar.
+     */
+    void marcar(EtapaTrama etapa) noexcept;
+
+    /**
+     * @brief Cierra la trama y registra su latencia total desde read().
+     */
+    void finTrama() noexcept;
+
+    /**
+     * @brief Devuelve el histograma de una etapa.
+     * @param etapa Etapa a consultar.
+     * @return Referencia al histograma.
+     */
+    const HistogramaLatencia& histograma(EtapaTrama etapa) const noexcept;
+
+    /**
+     * @brief Imprime p50/p99/p99.9/max de cada etapa.
+     * @param logger Logger de destino; si es nulo se escribe en STDERR.
+     */
+    void imprimirReporte(AuxiliarCli* logger) const;
+
+    /**
+     * @brief Instala un manejador de SIGUSR1 que solicita un reporte.
+     *
+     * El manejador solo levanta una bandera; el bucle de captura la consulta con
+     * reporteSolicitado() e imprime fuera del contexto de la señal.
+     */
+    static void instalarSenalReporte() noexcept;
+
+    /**
+     * @brief Consume una solicitud de reporte pendiente.
+     * @return true si llegó SIGUSR1 desde la última consulta.
+     */
+    static bool reporteSolicitado() noexcept;
+
+    /**
+     * @brief Nombre legible de una etapa.
+     * @param etapa Etapa a describir.
+     * @return Cadena literal.
+     */
+    static const char* nombreEtapa(EtapaTrama etapa) noexcept;
+
+private:
+    HistogramaLatencia _histogramas[kEtapas];
+    std::uint64_t _lecturaNs;
+    std::uint64_t _delimitacionNs;
+    std::uint64_t _anteriorNs;
+};
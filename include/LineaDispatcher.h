@@ -2,17 +2,50 @@
 
 #include <cstddef>
 
+#include "AnalizadorBinario.h"
+#include "AnalizadorTramas.h"
+
 class AuxiliarCli;
+class InstrumentacionEtapas;
 class ListaDeCarga;
+class MedidorLatencia;
+class RegistroContadores;
 class RotorDeMapeo;
+class SalidaMensaje;
+class TramaLoad;
+class TramaLote;
+class TramaMap;
+enum class Contador;
 
 /**
  * @file LineaDispatcher.h
  * @brief Declara el despachador que interpreta las líneas del protocolo PRT-7.
  */
+/**
+ * @brief Vista sin copia de una línea cruda; no incluye el salto de línea ni terminador nulo.
+ */
+struct VistaLinea {
+    const char* datos;
+    std::size_t longitud;
+};
+
 /**
  * @class LineaDispatcher
  * @brief Gestiona las tramas crudas recibidas y coordina la decodificación.
+ *
+ * Las tramas con prefijo de canal "N:" se enrutan a una sesión independiente por
+ * canal: cada una tiene su ListaDeCarga, la posición del rotor y su propio INICIO.
+ * Los canales viven en una sola tabla que se reserva con la primera trama
+ * etiquetada y comparten el RotorDeMapeo configurado, del que solo guardan el
+ * desplazamiento. Desde esa primera trama los mensajes ya no se escriben al vuelo
+ * en la SalidaMensaje: salen completos al cerrar su sesión, precedidos por "N:"
+ * los de un canal, para que no se intercalen en la salida.
+ *
+ * Una trama "FIN" cierra el mensaje sin cerrar la sesión: se escribe el final del
+ * mensaje (con prefijo y contenido retenido, si hay canales) y la ListaDeCarga se
+ * limpia para el siguiente, conservando sus bloques. Así una sesión larga con
+ * muchos mensajes no acumula caracteres y cada cierre cuesta O(1) sin canales,
+ * porque el contenido ya se entregó al vuelo.
  */
 class LineaDispatcher {
 public:
@@ -24,12 +57,56 @@ public:
      */
     LineaDispatcher(ListaDeCarga* carga = nullptr, RotorDeMapeo* rotor = nullptr, AuxiliarCli* logger = nullptr) noexcept;
 
+    /**
+     * @brief Libera la tabla de canales, si se llegó a reservar.
+     */
+    ~LineaDispatcher();
+
+    LineaDispatcher(const LineaDispatcher&) = delete;
+    LineaDispatcher& operator=(const LineaDispatcher&) = delete;
+
     /**
      * @brief Define el logger a utilizar.
      * @param logger Nuevo logger; puede ser nulo.
      */
     void setLogger(AuxiliarCli* logger) noexcept;
 
+    /**
+     * @brief Devuelve el logger configurado.
+     * @return Logger actual; puede ser nulo.
+     */
+    AuxiliarCli* getLogger() const noexcept;
+
+    /**
+     * @brief Define el destino que recibirá los caracteres decodificados al vuelo.
+     * @param salida Receptor de fragmentos; puede ser nulo para desactivarlo.
+     */
+    void setSalida(SalidaMensaje* salida) noexcept;
+
+    /**
+     * @brief Define el medidor que contará tramas y recibirá las marcas "T,<ns>".
+     * @param medidor Medidor de latencia; nullptr (por defecto) ignora las marcas.
+     */
+    void setMedidor(MedidorLatencia* medidor) noexcept;
+
+    /**
+     * @brief Define dónde se registran las latencias por etapa de cada trama.
+     *
+     * Solo tiene efecto si se compiló con PRT7_INSTRUMENTACION.
+     *
+     * @param instrumentacion Colector compartido con el ArduinoParser; puede ser nulo.
+     */
+    void setInstrumentacion(InstrumentacionEtapas* instrumentacion) noexcept;
+
+    /**
+     * @brief Define el registro donde se acumulan tramas, descartes y sesiones.
+     *
+     * A diferencia de totalProcesado(), estos contadores no se reinician con cada sesión.
+     *
+     * @param contadores Registro compartido con el ArduinoParser; puede ser nulo.
+     */
+    void setContadores(RegistroContadores* contadores) noexcept;
+
     /**
      * @brief Configura la lista y el rotor que serán manipulados.
      * @param carga Lista destino.
@@ -38,7 +115,7 @@ public:
     void setComponentes(ListaDeCarga* carga, RotorDeMapeo* rotor) noexcept;
 
     /**
-     * @brief Inicia una nueva sesión de decodificación.
+     * @brief Inicia una nueva sesión de decodificación en la sesión sin canal.
      * @param motivo Texto que describe el origen del reinicio.
      * @param limpiar Si es true, limpia la lista y reinicia el rotor.
      */
@@ -46,11 +123,19 @@ public:
 
     /**
      * @brief Termina la sesión actual; se ignoran tramas hasta reactivarla.
+     *
+     * Si la sesión estaba activa, reporta el mensaje completo antes de cerrarla.
+     * También cierra las sesiones abiertas de todos los canales.
      */
-    void terminarSesion() noexcept;
+    void terminarSesion();
 
     /**
-     * @brief Indica si hay una sesión activa.
+     * @brief Reporta el mensaje ensamblado completo hasta el momento.
+     */
+    void reportarMensaje() const;
+
+    /**
+     * @brief Indica si hay una sesión activa en el canal de la última trama recibida.
      * @return true cuando se aceptan tramas.
      */
     bool sesionActiva() const noexcept;
@@ -66,6 +151,50 @@ public:
      */
     void onRawLine(const char* linea);
 
+    /**
+     * @brief Procesa una línea cruda delimitada por longitud.
+     * @param linea Inicio de la línea; no requiere terminador nulo.
+     * @param longitud Número de bytes válidos en la línea.
+     */
+    void onRawLine(const char* linea, std::size_t longitud);
+
+    /**
+     * @brief Procesa en orden un lote de líneas completas entregadas por el lector.
+     * @param lineas Arreglo de vistas; solo son válidas durante la llamada.
+     * @param cantidad Número de vistas en el arreglo.
+     */
+    void onRawLines(const VistaLinea* lineas, std::size_t cantidad);
+
+    /**
+     * @brief Procesa bytes crudos del puerto sin que el lector delimite líneas.
+     *
+     * Las líneas pueden llegar partidas entre llamadas; el analizador conserva
+     * el estado de la línea en curso hasta recibir '\n'. Tras "INICIO-BIN" los
+     * bytes se delimitan como bloques binarios hasta la operación Fin.
+     *
+     * @param datos Bytes recibidos.
+     * @param cantidad Número de bytes en @p datos.
+     */
+    void onRawBytes(const char* datos, std::size_t cantidad);
+
+    /**
+     * @brief Decodifica las operaciones de un bloque del modo binario.
+     *
+     * Cada operación se aplica como su trama de texto equivalente. Un bloque con CRC
+     * incorrecto se descarta completo; una operación malformada descarta el resto
+     * del bloque.
+     *
+     * @param bloque Bloque entregado por AnalizadorBinario.
+     * @return false si el bloque terminó con la operación Fin (el enlace vuelve a texto).
+     */
+    bool onBloqueBinario(const BloqueBinario& bloque);
+
+    /**
+     * @brief Ajusta la longitud máxima por línea aceptada por el analizador.
+     * @param maximo Número de bytes permitidos sin contar el salto de línea.
+     */
+    void setLongitudMaximaLinea(std::size_t maximo) noexcept;
+
     /**
      * @brief Obtiene el número de líneas procesadas exitosamente.
      * @return Contador de tramas válidas.
@@ -73,16 +202,49 @@ public:
     std::size_t totalProcesado() const noexcept;
 
 private:
+    /**
+     * @brief Estado de una sesión que se guarda al cambiar de canal.
+     */
+    struct EstadoSesion {
+        ListaDeCarga* carga;
+        int desplazamiento;
+        std::size_t procesadas;
+        bool activa;
+        bool mensajeAbierto;
+    };
+    struct Canal;
+
     ListaDeCarga* _carga;
     RotorDeMapeo* _rotor;
     AuxiliarCli* _logger;
+    SalidaMensaje* _salida;
+    MedidorLatencia* _medidor;
+    InstrumentacionEtapas* _instrumentacion;
+    RegistroContadores* _contadores;
     std::size_t _procesadas;
     bool _sesionActiva;
+    bool _mensajeAbierto;
+    bool _binario;
+    AnalizadorTramas _analizador;
+    AnalizadorTramas _analizadorFlujo;
+    AnalizadorBinario _analizadorBinario;
+    EstadoSesion _base;
+    Canal* _canales;
+    int _canalActual;
 
-    bool procesarCarga(char* payload);
-    bool procesarMapa(char* payload);
-    static char interpretarTokenCarga(const char* payload, bool& valido);
+    void abrirSesion(const char* motivo, bool limpiar);
+    void cerrarMensaje();
+    void emitirMensaje();
+    bool cambiarCanal(int canal);
+    std::size_t entregarPendiente(char* destino, std::size_t capacidad);
+    void aplicarTrama(const TramaDecodificada& trama, const char* texto, std::size_t longitud);
+    // Un manejador por tipo de trama; una trama nueva solo agrega su sobrecarga.
+    bool procesar(const TramaLoad& trama);
+    bool procesar(const TramaLote& trama);
+    bool procesar(const TramaMap& trama);
+    void contar(Contador contador) noexcept;
+    // Cuenta y avisa los desbordes a disco que fallaron en la última inserción.
+    void revisarDesborde();
     void log(const char* tipo, const char* mensaje) const;
-    static void describirCaracter(char caracter, char* destino, std::size_t tam);
     void registrarSaltoLinea() const;
 };
@@ -11,9 +11,34 @@ class AuxiliarCli;
 /**
  * @class ListaDeCarga
  * @brief Lista doblemente enlazada que guarda los fragmentos decodificados.
+ *
+ * Los nodos se toman de bloques preasignados que se conservan entre sesiones,
+ * por lo que insertar no reserva memoria por carácter y limpiar() es O(1).
+ *
+ * Con un límite de memoria residente (setDesborde()) solo los últimos bloques
+ * quedan en RAM: al llenarse el límite, el bloque más antiguo se copia a un
+ * archivo temporal proyectado en memoria, a un byte por carácter en vez de un
+ * nodo, y se reutiliza para los caracteres nuevos. Como los nodos se reservan en
+ * orden, el archivo guarda siempre un prefijo del mensaje y la lectura sigue
+ * siendo secuencial: primero el archivo, luego los nodos.
  */
 class ListaDeCarga {
 public:
+    /**
+     * @brief Recibe un tramo contiguo del mensaje durante recorrerMensaje().
+     */
+    using EntregaDatos = void (*)(void* contexto, const char* datos, std::size_t longitud);
+
+    /**
+     * @brief Bytes de archivo que se proyectan a la vez para escribir lo desbordado.
+     */
+    static const std::size_t kSegmentoDesborde = 256 * 1024;
+
+    /**
+     * @brief Bloques nuevos que se esperan tras un desborde fallido antes de reintentarlo.
+     */
+    static const std::size_t kBloquesEntreReintentos = 64;
+
     /**
      * @brief Crea una lista vacía.
      */
@@ -24,6 +49,36 @@ public:
      */
     ~ListaDeCarga();
 
+    ListaDeCarga(const ListaDeCarga&) = delete;
+    ListaDeCarga& operator=(const ListaDeCarga&) = delete;
+
+    /**
+     * @brief Limita la memoria de los nodos; lo más antiguo del mensaje pasa a disco.
+     *
+     * El límite se redondea a bloques de nodos, con un mínimo de dos. Al desbordar
+     * se suma un segmento proyectado de kSegmentoDesborde bytes. El archivo se crea
+     * con el primer desborde y se borra del directorio en cuanto se abre, así que
+     * no queda en disco al terminar el proceso. Si el desborde falla (por ejemplo,
+     * disco lleno), la lista sigue creciendo en memoria, cuenta el fallo para
+     * tomarFallosDesborde() y lo reintenta kBloquesEntreReintentos bloques después;
+     * al lograrlo baja de nuevo hasta el límite.
+     *
+     * @param limiteResidente Bytes de nodos en RAM; 0 desactiva el desborde.
+     * @param directorio Directorio del archivo temporal; nullptr usa $TMPDIR o /tmp.
+     */
+    void setDesborde(std::size_t limiteResidente, const char* directorio = nullptr) noexcept;
+
+    /**
+     * @brief Define el límite con el que nacen las listas creadas desde ahora.
+     *
+     * Alcanza también a las listas internas de los decodificadores y de los
+     * canales, que no se configuran una por una. Debe llamarse antes de crear hilos.
+     *
+     * @param limiteResidente Bytes de nodos en RAM por lista; 0 desactiva el desborde.
+     * @param directorio Directorio de los archivos temporales; debe seguir válido mientras se usen.
+     */
+    static void setDesbordePorDefecto(std::size_t limiteResidente, const char* directorio = nullptr) noexcept;
+
     /**
      * @brief Inserta un nuevo carácter al final de la lista.
      * @param dato Carácter a agregar.
@@ -31,7 +86,18 @@ public:
     void insertarAlFinal(char dato);
 
     /**
-     * @brief Elimina todos los nodos y deja la lista vacía.
+     * @brief Inserta varios caracteres al final con un solo enlace por tramo de nodos contiguos.
+     *
+     * Equivale a llamar insertarAlFinal() por cada carácter, pero reserva los nodos
+     * por tramos dentro del bloque actual y los enlaza en una sola pasada.
+     *
+     * @param datos Caracteres a agregar, en orden.
+     * @param cantidad Número de caracteres.
+     */
+    void insertarVarios(const char* datos, std::size_t cantidad);
+
+    /**
+     * @brief Deja la lista vacía; los bloques de nodos se conservan para reutilizarse.
      */
     void limpiar() noexcept;
 
@@ -48,8 +114,53 @@ public:
      */
     void copiarMensaje(char* destino, std::size_t capacidad) const;
 
+    /**
+     * @brief Copia los caracteres insertados desde la última extracción y avanza el cursor.
+     *
+     * Permite reportar el mensaje de forma incremental: cada llamada cuesta lo mismo
+     * que los caracteres nuevos, sin recorrer lo ya entregado.
+     *
+     * @param destino Arreglo donde se escribirán los caracteres pendientes.
+     * @param capacidad Número máximo de caracteres permitidos (incluye terminador nulo).
+     * @return Cantidad de caracteres copiados; los que no quepan quedan pendientes.
+     */
+    std::size_t extraerPendiente(char* destino, std::size_t capacidad);
+
+    /**
+     * @brief Indica cuántos caracteres no se han extraído todavía.
+     * @return Caracteres insertados después de la última extracción.
+     */
+    std::size_t pendientes() const noexcept;
+
+    /**
+     * @brief Entrega el mensaje completo en orden, por tramos, sin reunirlo en un solo buffer.
+     * @param entrega Función que recibe cada tramo.
+     * @param contexto Puntero que se pasa tal cual a @p entrega.
+     */
+    void recorrerMensaje(EntregaDatos entrega, void* contexto) const;
+
+    /**
+     * @brief Indica cuántos caracteres del inicio del mensaje están en el archivo de desborde.
+     * @return 0 si el mensaje cabe en el límite o no hay límite.
+     */
+    std::size_t desbordados() const noexcept;
+
+    /**
+     * @brief Devuelve los desbordes fallidos desde la llamada anterior y los pone en cero.
+     *
+     * Mientras falle, el mensaje ocupa más memoria que el límite configurado; el
+     * LineaDispatcher lo consulta tras cada inserción para contarlo y avisar.
+     *
+     * @return Número de intentos fallidos sin reportar.
+     */
+    std::size_t tomarFallosDesborde() noexcept;
+
     /**
      * @brief Imprime el mensaje ensamblado. Utiliza el logger si está disponible.
+     *
+     * Un mensaje largo se escribe por tramos con recorrerMensaje(), sin copiarlo
+     * completo a memoria.
+     *
      * @param logger Utilidad opcional para emitir el mensaje u advertencias.
      */
     void imprimirMensaje(AuxiliarCli* logger = nullptr) const;
@@ -67,7 +178,43 @@ private:
         Nodo* siguiente;
     };
 
+    static const std::size_t kNodosPorBloque = 256;
+
+    /**
+     * @brief Bloque contiguo de nodos; los bloques forman una lista simple.
+     */
+    struct Bloque {
+        Nodo nodos[kNodosPorBloque];
+        Bloque* siguiente;
+    };
+
+    static std::size_t _limitePorDefecto;
+    static const char* _directorioPorDefecto;
+
     Nodo* _cabeza;
     Nodo* _cola;
     std::size_t _cantidad;
+    Nodo* _ultimoEntregado;
+    std::size_t _entregados;
+    Bloque* _primerBloque;
+    Bloque* _bloqueActual;
+    std::size_t _usadosEnBloque;
+    std::size_t _bloquesEnUso;
+
+    // Desborde a disco: el archivo guarda los primeros _desbordados caracteres del mensaje.
+    std::size_t _limiteBloques;
+    const char* _directorio;
+    int _fdDesborde;
+    char* _segmento;
+    std::size_t _inicioSegmento;
+    std::size_t _tamanoArchivo;
+    std::size_t _desbordados;
+    std::size_t _bloquesHastaReintento;
+    std::size_t _fallosDesborde;
+
+    Nodo* reservarNodos(std::size_t& cantidad);
+    bool desbordarBloque() noexcept;
+    bool proyectarSegmento(std::size_t desplazamiento) noexcept;
+    std::size_t leerDesbordado(std::size_t desde, char* destino, std::size_t cantidad) const noexcept;
+    void cerrarDesborde() noexcept;
 };
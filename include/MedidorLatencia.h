@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include "HistogramaLatencia.h"
+
+/**
+ * @file MedidorLatencia.h
+ * @brief Medición de latencia extremo a extremo con las marcas "T,<ns>" del emisor.
+ */
+
+/**
+ * @class MedidorLatencia
+ * @brief Compara cada marca de envío con el reloj monotónico al decodificarla.
+ *
+ * El emisor (prt7_emulador) y el decodificador corren en el mismo equipo, así que
+ * ambos relojes CLOCK_MONOTONIC son comparables. También cuenta todas las tramas
+ * para calcular el ritmo sostenido entre la primera y la última.
+ */
+class MedidorLatencia {
+public:
+    MedidorLatencia() noexcept;
+
+    /**
+     * @brief Descarta las mediciones anteriores.
+     */
+    void reiniciar() noexcept;
+
+    /**
+     * @brief Cuenta una trama decodificada de cualquier tipo.
+     */
+    void contarTrama() noexcept;
+
+    /**
+     * @brief Registra la latencia de una marca de envío.
+     * @param enviadoNs Instante de envío en nanosegundos de CLOCK_MONOTONIC.
+     */
+    void registrarMarca(std::uint64_t enviadoNs) noexcept;
+
+    /**
+     * @brief Devuelve el histograma de latencias de las marcas.
+     * @return Referencia al histograma interno.
+     */
+    const HistogramaLatencia& histograma() const noexcept;
+
+    /**
+     * @brief Tramas por segundo entre la primera y la última trama contadas.
+     * @return Ritmo sostenido, o 0 si hubo menos de dos tramas.
+     */
+    double tramasPorSegundo() const noexcept;
+
+    /**
+     * @brief Escribe el resumen de latencia y ritmo.
+     * @param destino Flujo de salida.
+     */
+    void imprimirReporte(std::FILE* destino) const;
+
+    /**
+     * @brief Lee CLOCK_MONOTONIC en nanosegundos.
+     * @return Instante actual.
+     */
+    static std::uint64_t ahoraNs() noexcept;
+
+private:
+    HistogramaLatencia _histograma;
+    std::uint64_t _tramas;
+    std::uint64_t _primeraNs;
+    std::uint64_t _ultimaNs;
+    std::uint64_t _marcasAdelantadas;
+};
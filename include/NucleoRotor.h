@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @file NucleoRotor.h
+ * @brief Núcleos que decodifican un bloque de caracteres contra un solo desplazamiento del rotor.
+ */
+
+/**
+ * @brief Variantes del núcleo de decodificación por bloques.
+ *
+ * Todas suman el desplazamiento módulo 26 a las letras 'A'-'Z' y copian el resto
+ * de bytes sin cambios, igual que la fila de RotorDeMapeo para ese desplazamiento.
+ *
+ * - ImplementacionNucleo::Escalar: aritmética byte a byte, portable.
+ * - ImplementacionNucleo::Sse2: 16 bytes por iteración (x86-64 siempre la tiene).
+ * - ImplementacionNucleo::Avx2: 32 bytes por iteración si la CPU la soporta.
+ */
+enum class ImplementacionNucleo { Escalar, Sse2, Avx2 };
+
+namespace NucleoRotor {
+
+/**
+ * @brief Decodifica un bloque con la mejor variante detectada en la CPU al primer uso.
+ * @param entrada Caracteres originales.
+ * @param salida Destino; puede ser igual a @p entrada.
+ * @param cantidad Número de caracteres.
+ * @param desplazamiento Posición del rotor, entre 0 y 25.
+ */
+void decodificar(const char* entrada, char* salida, std::size_t cantidad, int desplazamiento) noexcept;
+
+/**
+ * @brief Decodifica un bloque con una variante concreta; para bancos de prueba y comparaciones.
+ * @param implementacion Variante a usar; si no está disponible se usa la escalar.
+ */
+void decodificarCon(ImplementacionNucleo implementacion, const char* entrada, char* salida, std::size_t cantidad,
+                    int desplazamiento) noexcept;
+
+/**
+ * @brief Indica si la CPU y el compilador permiten usar una variante.
+ */
+bool disponible(ImplementacionNucleo implementacion) noexcept;
+
+/**
+ * @brief Devuelve la variante que usa decodificar().
+ */
+ImplementacionNucleo activa() noexcept;
+
+/**
+ * @brief Nombre corto de una variante ("escalar", "sse2", "avx2").
+ */
+const char* nombre(ImplementacionNucleo implementacion) noexcept;
+
+} // namespace NucleoRotor
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file ProtocoloBinario.h
+ * @brief Constantes y utilidades del modo binario compacto de PRT-7.
+ *
+ * El emisor negocia el modo con la línea de texto "INICIO-BIN", que además abre
+ * una sesión como "INICIO". A partir de ahí el flujo se compone de bloques:
+ *
+ * | Sincronía | Longitud | Cuerpo           | CRC-16          |
+ * |-----------|----------|------------------|-----------------|
+ * | 0xA5      | 1..255   | operaciones      | 2 bytes, big-endian |
+ *
+ * El CRC-16/CCITT-FALSE cubre la longitud y el cuerpo. El cuerpo es una secuencia
+ * de operaciones de un byte seguidas de sus operandos; un bloque puede llevar una
+ * sola operación (CRC por trama) o muchas (CRC por bloque). La operación Fin
+ * devuelve el enlace al modo texto; si el bloque que la lleva llega dañado, el
+ * receptor sigue en modo binario hasta el siguiente Fin válido.
+ */
+
+namespace ProtocoloBinario {
+
+/**
+ * @brief Línea de texto que activa el modo binario.
+ */
+const char kMarcador[] = "INICIO-BIN";
+const std::size_t kLongitudMarcador = sizeof(kMarcador) - 1;
+
+/**
+ * @brief Primer byte de cada bloque; lo que no empiece con él se descarta al resincronizar.
+ */
+const unsigned char kSincronia = 0xA5;
+
+const std::size_t kMaxCuerpo = 255;
+const std::size_t kMaxTrama = 1 + 1 + kMaxCuerpo + 2;
+const std::size_t kMaxVarint = 10;
+
+/**
+ * @brief Códigos de operación del cuerpo de un bloque.
+ *
+ * - Operacion::Inicio: sin operandos; equivale a "INICIO" sin salir del modo binario.
+ * - Operacion::Carga: un byte con el carácter; equivale a "L,<c>".
+ * - Operacion::Mapa: varint zigzag con la rotación; equivale a "M,<n>".
+ * - Operacion::Lote: varint con la cantidad y los caracteres; equivale a "B,<texto>".
+ * - Operacion::Marca: varint con el instante de envío en ns; equivale a "T,<ns>".
+ * - Operacion::Fin: sin operandos; lo que sigue en el enlace vuelve a ser texto.
+ * - Operacion::Canal: varint con el canal más uno (0 = sin canal); equivale al prefijo
+ *   "N:" para las operaciones siguientes hasta el final del bloque.
+ * - Operacion::FinMensaje: sin operandos; equivale a "FIN" (no confundir con Fin).
+ */
+enum class Operacion : unsigned char {
+    Inicio = 0x01,
+    Carga = 0x02,
+    Mapa = 0x03,
+    Lote = 0x04,
+    Marca = 0x05,
+    Fin = 0x06,
+    Canal = 0x07,
+    FinMensaje = 0x08
+};
+
+/**
+ * @brief Calcula el CRC-16/CCITT-FALSE (polinomio 0x1021) de un bloque de bytes.
+ * @param datos Bytes a cubrir.
+ * @param cantidad Número de bytes.
+ * @param crc Valor acumulado; 0xFFFF para empezar un cálculo nuevo.
+ * @return CRC actualizado.
+ */
+std::uint16_t crc16(const unsigned char* datos, std::size_t cantidad, std::uint16_t crc = 0xFFFF) noexcept;
+
+/**
+ * @brief Escribe un entero sin signo como varint LEB128 (7 bits por byte).
+ * @param valor Entero a codificar.
+ * @param destino Al menos kMaxVarint bytes.
+ * @return Bytes escritos.
+ */
+std::size_t escribirVarint(std::uint64_t valor, unsigned char* destino) noexcept;
+
+/**
+ * @brief Lee un varint LEB128.
+ * @param datos Inicio del varint.
+ * @param cantidad Bytes disponibles.
+ * @param valor Recibe el entero decodificado.
+ * @return Bytes consumidos, o 0 si el varint está truncado o excede 64 bits.
+ */
+std::size_t leerVarint(const unsigned char* datos, std::size_t cantidad, std::uint64_t& valor) noexcept;
+
+/**
+ * @brief Lleva un entero con signo a sin signo para que las rotaciones cortas ocupen un byte.
+ */
+inline std::uint64_t aZigzag(std::int64_t valor) noexcept
+{
+    return (static_cast<std::uint64_t>(valor) << 1) ^ static_cast<std::uint64_t>(valor >> 63);
+}
+
+/**
+ * @brief Inversa de aZigzag().
+ */
+inline std::int64_t desdeZigzag(std::uint64_t valor) noexcept
+{
+    return static_cast<std::int64_t>(valor >> 1) ^ -static_cast<std::int64_t>(valor & 1u);
+}
+
+/**
+ * @brief Indica si una línea de texto es el marcador "INICIO-BIN" (sin distinguir mayúsculas).
+ * @param linea Línea sin salto final.
+ * @param longitud Bytes de la línea.
+ * @return true si la línea activa el modo binario.
+ */
+bool esMarcador(const char* linea, std::size_t longitud) noexcept;
+
+} // namespace ProtocoloBinario
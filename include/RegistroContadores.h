@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RegistroContadores.h
+ * @brief Contadores acumulados del motor de captura con exportación estilo Prometheus.
+ */
+
+/**
+ * @brief Contadores disponibles. El orden agrupa las familias de métricas.
+ */
+enum class Contador {
+    BytesLeidos,
+    Lecturas,
+    ErroresLectura,
+    Desconexiones,
+    TramasInicio,
+    TramasCarga,
+    TramasMapa,
+    TramasMarca,
+    TramasLote,
+    TramasFin,
+    InvalidasDesbordada,
+    InvalidasIncompleta,
+    InvalidasPrefijo,
+    InvalidasToken,
+    InvalidasRotacion,
+    InvalidasSinInicio,
+    InvalidasCrc,
+    InvalidasCanal,
+    InvalidasSinManejador,
+    SesionesIniciadas,
+    SesionesTerminadas,
+    CaracteresDecodificados,
+    DesbordesFallidos,
+    Total
+};
+
+/**
+ * @class RegistroContadores
+ * @brief Registro de contadores monotónicos con atomics relajados.
+ *
+ * Cada incremento es un fetch_add relajado: no ordena memoria ni toma candados, así
+ * que puede compartirse entre el hilo lector y el decodificador de TuberiaCaptura.
+ * Los valores nunca se reinician mientras viva el registro (a diferencia de
+ * LineaDispatcher::totalProcesado()), como espera Prometheus de un counter.
+ */
+class RegistroContadores {
+public:
+    static const std::size_t kContadores = static_cast<std::size_t>(Contador::Total);
+
+    RegistroContadores() noexcept;
+
+    RegistroContadores(const RegistroContadores&) = delete;
+    RegistroContadores& operator=(const RegistroContadores&) = delete;
+
+    /**
+     * @brief Suma al contador indicado.
+     * @param contador Contador a incrementar.
+     * @param cantidad Valor a sumar.
+     */
+    void sumar(Contador contador, std::uint64_t cantidad = 1) noexcept
+    {
+        _valores[static_cast<std::size_t>(contador)].fetch_add(cantidad, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Lee el valor actual de un contador.
+     * @param contador Contador a consultar.
+     * @return Valor acumulado.
+     */
+    std::uint64_t valor(Contador contador) const noexcept;
+
+    /**
+     * @brief Define el archivo que escribe volcar(); por ejemplo el directorio textfile de node_exporter.
+     * @param ruta Ruta del archivo .prom; nullptr o vacío desactiva el volcado.
+     */
+    void setRutaVolcado(const char* ruta) noexcept;
+
+    /**
+     * @brief Devuelve la ruta configurada para el volcado.
+     * @return Ruta, o cadena vacía si no hay.
+     */
+    const char* getRutaVolcado() const noexcept;
+
+    /**
+     * @brief Escribe todos los contadores en formato de texto de Prometheus.
+     * @param destino Buffer de salida.
+     * @param capacidad Tamaño del buffer.
+     * @return Bytes escritos (sin terminador), o 0 si no cupo.
+     */
+    std::size_t formatear(char* destino, std::size_t capacidad) const noexcept;
+
+    /**
+     * @brief Escribe los contadores en la ruta configurada de forma atómica.
+     *
+     * Se escribe en "<ruta>.tmp" y luego se renombra, así el recolector nunca lee
+     * un archivo a medias.
+     *
+     * @return true si el archivo quedó escrito.
+     */
+    bool volcar() const noexcept;
+
+    /**
+     * @brief Instala un manejador de SIGUSR2 que solicita un volcado.
+     */
+    static void instalarSenalVolcado() noexcept;
+
+    /**
+     * @brief Consume una solicitud de volcado pendiente.
+     * @return true si llegó SIGUSR2 desde la última consulta.
+     */
+    static bool volcadoSolicitado() noexcept;
+
+private:
+    static const std::size_t kMaxRuta = 255;
+
+    std::atomic<std::uint64_t> _valores[kContadores];
+    char _ruta[kMaxRuta + 1];
+};
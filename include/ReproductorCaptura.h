@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file ReproductorCaptura.h
+ * @brief Reproducción de capturas grabadas con GrabadorCaptura.
+ */
+
+class ArduinoParser;
+class AuxiliarCli;
+
+/**
+ * @brief Ritmo con el que se entregan los bloques grabados.
+ *
+ * - RitmoReproduccion::Original respeta los intervalos medidos al grabar.
+ * - RitmoReproduccion::Maximo entrega los bloques sin pausas.
+ */
+enum class RitmoReproduccion { Original, Maximo };
+
+/**
+ * @class ReproductorCaptura
+ * @brief Entrega una captura grabada al ArduinoParser como si llegara del puerto.
+ *
+ * Los bloques pasan por ArduinoParser::alimentar(), por lo que recorren la misma
+ * delimitación de líneas y el mismo LineaDispatcher que una captura en vivo. En ritmo
+ * original se mide cuánto se retrasa cada entrega respecto al instante grabado.
+ *
+ * Un registro truncado o dañado no detiene la reproducción: se descarta el resto de
+ * su segmento y se sigue en el siguiente registro 'S' (FormatoCaptura::kSegmento).
+ */
+class ReproductorCaptura {
+public:
+    /**
+     * @brief Resultados de la última reproducción.
+     */
+    struct Estadisticas {
+        std::uint64_t segmentos;
+        std::uint64_t registros;
+        std::uint64_t bytes;
+        std::uint64_t duracionOriginalUs;
+        std::uint64_t duracionRealUs;
+        std::uint64_t retrasoMaximoUs;
+        std::uint64_t retrasoTotalUs;
+        std::uint64_t bytesSaltados; ///< Bytes dañados omitidos hasta el siguiente segmento.
+    };
+
+    /**
+     * @brief Crea el reproductor.
+     * @param destino Parser que recibirá los bytes grabados.
+     * @param logger Logger opcional para errores y estadísticas.
+     */
+    explicit ReproductorCaptura(ArduinoParser* destino, AuxiliarCli* logger = nullptr) noexcept;
+
+    /**
+     * @brief Define el ritmo de entrega.
+     * @param ritmo Ritmo deseado; por defecto RitmoReproduccion::Original.
+     */
+    void setRitmo(RitmoReproduccion ritmo) noexcept;
+
+    /**
+     * @brief Permite interrumpir la reproducción con ENTER en STDIN.
+     * @param detener true para vigilar STDIN mientras se espera entre bloques y,
+     *        sin espera (ritmo máximo o reproducción atrasada), cada cierto número de bloques.
+     */
+    void setDetenerConEnter(bool detener) noexcept;
+
+    /**
+     * @brief Reproduce un archivo de captura completo.
+     * @param ruta Ruta del archivo grabado.
+     * @return true si el archivo era una captura y se recorrió hasta el final (o hasta
+     *         ENTER), aunque se hayan saltado tramos dañados.
+     */
+    bool reproducir(const char* ruta);
+
+    /**
+     * @brief Devuelve los resultados de la última reproducción.
+     * @return Copia de los contadores.
+     */
+    Estadisticas estadisticas() const noexcept;
+
+    /**
+     * @brief Imprime los contadores mediante el logger.
+     */
+    void imprimirEstadisticas() const;
+
+private:
+    ArduinoParser* _destino;
+    AuxiliarCli* _logger;
+    RitmoReproduccion _ritmo;
+    bool _detenerConEnter;
+    Estadisticas _stats;
+
+    bool recorrer(const unsigned char* datos, std::size_t tamano);
+    bool esperarHasta(std::uint64_t objetivoNs);
+    bool enterPulsado(std::uint64_t esperaNs);
+    void aviso(const char* mensaje) const;
+    void error(const char* mensaje) const;
+};
@@ -7,22 +7,37 @@
  * @brief Lista circular doble para traducir caracteres según el protocolo PRT-7.
  */
 
+/**
+ * @brief Motores disponibles para resolver el mapeo del rotor.
+ *
+ * - MotorRotor::Tabla usa el desplazamiento actual y una tabla de 256 entradas (O(1)).
+ * - MotorRotor::ListaEnlazada recorre la lista circular; se conserva como referencia.
+ */
+enum class MotorRotor { Tabla, ListaEnlazada };
+
 /**
  * @class RotorDeMapeo
  * @brief Rotor circular doblemente enlazado que implementa el mapeo dinámico.
+ *
+ * Ambos motores producen exactamente el mismo resultado; el motor por tabla
+ * evita recorrer nodos al rotar y al mapear.
  */
 class RotorDeMapeo {
 public:
     /**
      * @brief Construye el rotor cargado con el alfabeto A-Z.
+     * @param motor Motor con el que se resolverán rotaciones y mapeos.
      */
-    RotorDeMapeo();
+    explicit RotorDeMapeo(MotorRotor motor = MotorRotor::Tabla);
 
     /**
      * @brief Libera todos los nodos del rotor.
      */
     ~RotorDeMapeo();
 
+    RotorDeMapeo(const RotorDeMapeo&) = delete;
+    RotorDeMapeo& operator=(const RotorDeMapeo&) = delete;
+
     /**
      * @brief Rota el rotor la cantidad indicada.
      * @param pasos Entero positivo (derecha) o negativo (izquierda).
@@ -36,11 +51,42 @@ public:
      */
     char getMapeo(char entrada) const;
 
+    /**
+     * @brief Traduce un bloque de caracteres con la posición actual del rotor.
+     *
+     * Con MotorRotor::Tabla el bucle solo indexa la fila vigente; no se consulta el
+     * motor por cada carácter. Los bloques de 16 caracteres o más usan el núcleo
+     * vectorial de NucleoRotor elegido según la CPU.
+     *
+     * @param entrada Caracteres originales.
+     * @param salida Destino de los caracteres decodificados; puede ser igual a @p entrada.
+     * @param cantidad Número de caracteres.
+     */
+    void getMapeo(const char* entrada, char* salida, std::size_t cantidad) const;
+
     /**
      * @brief Restablece la cabeza del rotor para que apunte nuevamente a 'A'.
      */
     void reiniciar() noexcept;
 
+    /**
+     * @brief Cambia el motor activo conservando la posición actual del rotor.
+     * @param motor Nuevo motor a emplear.
+     */
+    void setMotor(MotorRotor motor) noexcept;
+
+    /**
+     * @brief Devuelve el motor actualmente configurado.
+     * @return Motor activo.
+     */
+    MotorRotor getMotor() const noexcept;
+
+    /**
+     * @brief Devuelve el desplazamiento actual respecto a 'A'.
+     * @return Valor entre 0 y 25.
+     */
+    int getDesplazamiento() const noexcept;
+
 private:
     struct Nodo {
         char valor;
@@ -50,7 +96,11 @@ private:
 
     Nodo* _cabeza;
     std::size_t _tamano;
+    MotorRotor _motor;
+    int _desplazamiento;
+    const char* _fila;
 
     void inicializar();
     Nodo* crearNodo(char valor, Nodo* previo) const;
+    void sincronizarCabeza() noexcept;
 };
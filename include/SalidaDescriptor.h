@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+#include "SalidaMensaje.h"
+
+/**
+ * @file SalidaDescriptor.h
+ * @brief Destino de mensajes que escribe en un descriptor POSIX con buffer propio.
+ */
+
+/**
+ * @class SalidaDescriptor
+ * @brief Acumula los fragmentos decodificados y los escribe en bloques grandes.
+ *
+ * Cada mensaje terminado se cierra con un salto de línea. El descriptor no se
+ * cierra al destruir el objeto; solo se vacía lo pendiente.
+ */
+class SalidaDescriptor : public SalidaMensaje {
+public:
+    /**
+     * @brief Crea la salida sobre un descriptor ya abierto.
+     * @param fd Descriptor de archivo, tubería o socket.
+     */
+    explicit SalidaDescriptor(int fd) noexcept;
+
+    /**
+     * @brief Escribe lo pendiente y libera el buffer.
+     */
+    ~SalidaDescriptor() override;
+
+    SalidaDescriptor(const SalidaDescriptor&) = delete;
+    SalidaDescriptor& operator=(const SalidaDescriptor&) = delete;
+
+    void escribirFragmento(const char* datos, std::size_t longitud) override;
+    void finalizarMensaje() override;
+
+    /**
+     * @brief Escribe cada mensaje en cuanto termina en lugar de esperar a llenar el buffer.
+     *
+     * Pensado para capturas en vivo y sockets, donde el receptor espera cada
+     * mensaje; en decodificación por lotes conviene dejarlo desactivado.
+     *
+     * @param activo true para vaciar en cada finalizarMensaje().
+     */
+    void setVaciarPorMensaje(bool activo) noexcept;
+
+    /**
+     * @brief Escribe en el descriptor todo lo acumulado.
+     * @return false si alguna escritura falló.
+     */
+    bool vaciar() noexcept;
+
+    /**
+     * @brief Indica si alguna escritura falló.
+     * @return true tras el primer error de write().
+     */
+    bool huboError() const noexcept;
+
+private:
+    static const std::size_t kCapacidad = 64 * 1024;
+
+    int _fd;
+    char* _buffer;
+    std::size_t _usados;
+    bool _error;
+    bool _vaciarPorMensaje;
+
+    bool escribirTodo(const char* datos, std::size_t longitud) noexcept;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+#include "SalidaMensaje.h"
+
+/**
+ * @file SalidaMemoria.h
+ * @brief Destino de mensajes que acumula la salida en memoria.
+ */
+
+/**
+ * @class SalidaMemoria
+ * @brief Guarda los fragmentos decodificados en un buffer que crece según haga falta.
+ *
+ * La usan los decodificadores paralelos: cada tramo o sesión se decodifica por
+ * separado y su salida espera en memoria hasta que le toca escribirse en orden.
+ * Cada mensaje terminado se cierra con un salto de línea, como en SalidaDescriptor.
+ */
+class SalidaMemoria : public SalidaMensaje {
+public:
+    SalidaMemoria() noexcept;
+
+    /**
+     * @brief Libera el buffer.
+     */
+    ~SalidaMemoria() override;
+
+    SalidaMemoria(const SalidaMemoria&) = delete;
+    SalidaMemoria& operator=(const SalidaMemoria&) = delete;
+
+    void escribirFragmento(const char* datos, std::size_t longitud) override;
+    void finalizarMensaje() override;
+
+    /**
+     * @brief Descarta lo acumulado y conserva el buffer para reutilizarlo.
+     */
+    void reiniciar() noexcept;
+
+    /**
+     * @brief Devuelve el contenido acumulado.
+     */
+    const char* datos() const noexcept;
+
+    /**
+     * @brief Devuelve los bytes acumulados.
+     */
+    std::size_t longitud() const noexcept;
+
+    /**
+     * @brief Indica si algún fragmento se perdió por falta de memoria.
+     */
+    bool huboError() const noexcept;
+
+private:
+    char* _datos;
+    std::size_t _capacidad;
+    std::size_t _usados;
+    bool _error;
+
+    bool crecer(std::size_t minimo) noexcept;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @file SalidaMensaje.h
+ * @brief Interfaz para recibir el mensaje decodificado conforme se ensambla.
+ */
+
+/**
+ * @brief Destino opcional de los caracteres decodificados por LineaDispatcher.
+ */
+class SalidaMensaje {
+public:
+    /**
+     * @brief Recibe los caracteres agregados al mensaje desde la última notificación.
+     * @param datos Caracteres decodificados; solo son válidos durante la llamada.
+     * @param longitud Número de caracteres.
+     */
+    virtual void escribirFragmento(const char* datos, std::size_t longitud) = 0;
+
+    /**
+     * @brief Indica que el mensaje en curso terminó (fin de sesión o nuevo INICIO).
+     */
+    virtual void finalizarMensaje() = 0;
+
+    /**
+     * @brief Destructor virtual para liberar implementaciones de forma segura.
+     */
+    virtual ~SalidaMensaje() = default;
+};
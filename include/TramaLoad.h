@@ -12,8 +12,11 @@ class RotorDeMapeo;
 /**
  * @class TramaLoad
  * @brief Inserta en la lista el carácter decodificado por el rotor.
+ *
+ * Es final: LineaDispatcher llama a aplicar() directamente, sin pasar por la
+ * tabla virtual de TramaBase.
  */
-class TramaLoad : public TramaBase {
+class TramaLoad final : public TramaBase {
 public:
     /**
      * @brief Construye la trama con el carácter recibido.
@@ -28,6 +31,20 @@ public:
      */
     void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) override;
 
+    /**
+     * @brief Decodifica el carácter, lo agrega a la lista y devuelve el resultado.
+     * @param carga Lista doblemente enlazada que forma el mensaje final.
+     * @param rotor Rotor encargado de mapear el carácter de entrada.
+     * @return Carácter decodificado que se insertó.
+     */
+    char aplicar(ListaDeCarga& carga, const RotorDeMapeo& rotor) const;
+
+    /**
+     * @brief Devuelve el carácter bruto recibido.
+     * @return Carácter antes de pasar por el rotor.
+     */
+    char dato() const noexcept;
+
 private:
     char _dato;
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+
+#include "TramaBase.h"
+
+class ListaDeCarga;
+class RotorDeMapeo;
+
+/**
+ * @file TramaLote.h
+ * @brief Declara la trama de carga con varios caracteres ("B,<texto>").
+ */
+/**
+ * @class TramaLote
+ * @brief Decodifica un bloque de caracteres con el rotor y los inserta de una vez.
+ *
+ * Equivale a una TramaLoad por carácter sin rotaciones intermedias. La trama no
+ * copia el texto: solo debe vivir mientras lo haga el buffer de origen.
+ */
+class TramaLote final : public TramaBase {
+public:
+    /**
+     * @brief Construye la trama sobre el texto recibido.
+     * @param datos Caracteres brutos enviados por el Arduino.
+     * @param longitud Número de caracteres.
+     */
+    TramaLote(const char* datos, std::size_t longitud) noexcept;
+
+    /**
+     * @brief Decodifica los caracteres y los agrega a la lista de carga.
+     * @param carga Lista doblemente enlazada que forma el mensaje final.
+     * @param rotor Rotor encargado de mapear los caracteres.
+     */
+    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) override;
+
+    /**
+     * @brief Traduce el bloque con RotorDeMapeo::getMapeo() y lo inserta con ListaDeCarga::insertarVarios().
+     * @param carga Lista doblemente enlazada que forma el mensaje final.
+     * @param rotor Rotor encargado de mapear los caracteres.
+     * @return Número de caracteres insertados.
+     */
+    std::size_t aplicar(ListaDeCarga& carga, const RotorDeMapeo& rotor) const;
+
+    /**
+     * @brief Devuelve el texto bruto recibido.
+     * @return Inicio de los caracteres antes de pasar por el rotor.
+     */
+    const char* datos() const noexcept;
+
+    /**
+     * @brief Devuelve la cantidad de caracteres de la trama.
+     * @return Longitud del texto.
+     */
+    std::size_t longitud() const noexcept;
+
+private:
+    static const std::size_t kTramo = 256;
+
+    const char* _datos;
+    std::size_t _longitud;
+};
@@ -12,8 +12,11 @@ class RotorDeMapeo;
 /**
  * @class TramaMap
  * @brief Ordena la rotación del rotor de mapeo.
+ *
+ * Es final: LineaDispatcher llama a aplicar() directamente, sin pasar por la
+ * tabla virtual de TramaBase.
  */
-class TramaMap : public TramaBase {
+class TramaMap final : public TramaBase {
 public:
     /**
      * @brief Construye la trama con la magnitud de rotación solicitada.
@@ -28,6 +31,19 @@ public:
      */
     void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) override;
 
+    /**
+     * @brief Rota el rotor y devuelve su nueva posición.
+     * @param rotor Rotor circular que se debe rotar.
+     * @return Desplazamiento resultante respecto a 'A' (0 a 25).
+     */
+    int aplicar(RotorDeMapeo& rotor) const;
+
+    /**
+     * @brief Devuelve la magnitud de rotación solicitada.
+     * @return Pasos a rotar; positivo hacia adelante.
+     */
+    int desplazamiento() const noexcept;
+
 private:
     int _desplazamiento;
 };
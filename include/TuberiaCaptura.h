@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ColaSpsc.h"
+#include "EventoEspera.h"
+#include "SalidaMensaje.h"
+
+class AuxiliarCli;
+class GrabadorCaptura;
+class LineaDispatcher;
+class RegistroContadores;
+
+/**
+ * @file TuberiaCaptura.h
+ * @brief Captura en tres hilos: lector serie, decodificador y salida.
+ */
+
+/**
+ * @class TuberiaCaptura
+ * @brief Separa la lectura del puerto, la decodificación y la escritura en hilos distintos.
+ *
+ * El lector solo llama a read() y publica bloques crudos; el decodificador es el
+ * único hilo que toca LineaDispatcher, ListaDeCarga y RotorDeMapeo; el hilo de
+ * salida escribe el mensaje decodificado. Las etapas se conectan con ColaSpsc y,
+ * cuando una cola está vacía (o la de entrada llena), el hilo duerme en un
+ * EventoEspera hasta que la etapa vecina publique o libere un bloque.
+ *
+ * Si la cola de entrada se llena, el lector espera (la presión se acumula en el
+ * buffer del kernel) y se cuenta como espera. Si la cola de salida se llena, el
+ * decodificador descarta el bloque de salida para no frenar la lectura.
+ */
+class TuberiaCaptura {
+public:
+    /**
+     * @brief Contadores visibles para el operador.
+     */
+    struct Estadisticas {
+        std::uint64_t bytesLeidos;
+        std::uint64_t lecturas;
+        std::uint64_t esperasEntrada;
+        std::uint64_t maxOcupacionEntrada;
+        std::uint64_t bytesEscritos;
+        std::uint64_t bloquesDescartados;
+        std::uint64_t bytesDescartados;
+    };
+
+    /**
+     * @brief Prepara la tubería sobre un descriptor ya abierto.
+     * @param fd Descriptor del puerto serie.
+     * @param dispatcher Dispatcher que decodificará las tramas; se usa sin logger durante la captura.
+     * @param logger Logger para mensajes de estado del hilo principal.
+     * @param salidaFd Descriptor donde se escribe el mensaje decodificado.
+     */
+    TuberiaCaptura(int fd, LineaDispatcher* dispatcher, AuxiliarCli* logger, int salidaFd) noexcept;
+
+    ~TuberiaCaptura();
+
+    TuberiaCaptura(const TuberiaCaptura&) = delete;
+    TuberiaCaptura& operator=(const TuberiaCaptura&) = delete;
+
+    /**
+     * @brief Define un grabador que el hilo lector alimentará con cada bloque leído.
+     * @param grabador Grabador abierto, o nullptr para no grabar.
+     */
+    void setGrabador(GrabadorCaptura* grabador) noexcept;
+
+    /**
+     * @brief Define el registro donde el hilo lector suma bytes, lecturas y fallos.
+     *
+     * El hilo principal atiende SIGUSR2 escribiendo el archivo de métricas.
+     *
+     * @param contadores Registro compartido con el dispatcher, o nullptr.
+     */
+    void setContadores(RegistroContadores* contadores) noexcept;
+
+    /**
+     * @brief Ejecuta las tres etapas hasta que el usuario presione ENTER o se pierda el puerto.
+     * @return true si la captura terminó sin fallas de lectura.
+     */
+    bool ejecutarHastaEnter();
+
+    /**
+     * @brief Obtiene una copia de los contadores actuales.
+     * @return Contadores de las tres etapas.
+     */
+    Estadisticas estadisticas() const noexcept;
+
+    /**
+     * @brief Imprime los contadores mediante el logger.
+     */
+    void imprimirEstadisticas() const;
+
+private:
+    static const std::size_t kBytesPorBloque = 1024;
+    static const std::size_t kBytesPorSalida = 256;
+    static const std::size_t kBloquesEnCola = 256;
+
+    struct BloqueCrudo {
+        std::size_t longitud;
+        char datos[kBytesPorBloque];
+    };
+
+    struct BloqueSalida {
+        std::size_t longitud;
+        char datos[kBytesPorSalida];
+    };
+
+    /**
+     * @brief Adaptador que agrupa los fragmentos decodificados y los encola hacia la salida.
+     */
+    class SalidaEnCola : public SalidaMensaje {
+    public:
+        explicit SalidaEnCola(TuberiaCaptura& tuberia) noexcept;
+        void escribirFragmento(const char* datos, std::size_t longitud) override;
+        void finalizarMensaje() override;
+        void vaciar() noexcept;
+
+    private:
+        TuberiaCaptura& _tuberia;
+        BloqueSalida _actual;
+    };
+
+    int _fd;
+    int _salidaFd;
+    LineaDispatcher* _dispatcher;
+    AuxiliarCli* _logger;
+    GrabadorCaptura* _grabador;
+    RegistroContadores* _contadores;
+    ColaSpsc<BloqueCrudo, kBloquesEnCola>* _entrada;
+    ColaSpsc<BloqueSalida, kBloquesEnCola>* _salida;
+    SalidaEnCola _adaptador;
+    EventoEspera _hayEntrada;
+    EventoEspera _hayEspacioEntrada;
+    EventoEspera _haySalida;
+
+    std::atomic<bool> _detener;
+    std::atomic<bool> _lectorTerminado;
+    std::atomic<bool> _decodificadorTerminado;
+    std::atomic<bool> _falloLectura;
+
+    std::atomic<std::uint64_t> _bytesLeidos;
+    std::atomic<std::uint64_t> _lecturas;
+    std::atomic<std::uint64_t> _esperasEntrada;
+    std::atomic<std::uint64_t> _maxOcupacionEntrada;
+    std::atomic<std::uint64_t> _bytesEscritos;
+    std::atomic<std::uint64_t> _bloquesDescartados;
+    std::atomic<std::uint64_t> _bytesDescartados;
+
+    void leer();
+    void decodificar();
+    void escribir();
+};
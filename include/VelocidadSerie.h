@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * @file VelocidadSerie.h
+ * @brief Baudrates arbitrarios mediante termios2/BOTHER de Linux.
+ *
+ * <asm/termbits.h> redefine struct termios y choca con <termios.h>, por eso esta
+ * configuración vive en su propia unidad de traducción.
+ */
+
+namespace VelocidadSerie {
+
+/**
+ * @brief Aplica un baudrate arbitrario (p. ej. 250000 o 1843200) a un descriptor ya configurado.
+ *
+ * Solo cambia la velocidad de entrada y salida; el resto de la configuración
+ * termios se conserva.
+ *
+ * @param fd Descriptor del puerto serie o pty.
+ * @param baud Baudrate deseado.
+ * @return true si el controlador aceptó la velocidad; false si no hay soporte o falló ioctl().
+ */
+bool aplicarPersonalizada(int fd, unsigned baud) noexcept;
+
+} // namespace VelocidadSerie
@@ -0,0 +1,84 @@
+#include "AnalizadorBinario.h"
+
+#include <cstring>
+
+AnalizadorBinario::AnalizadorBinario() noexcept : _descartados(0)
+{
+    reiniciar();
+}
+
+void AnalizadorBinario::reiniciar() noexcept
+{
+    _estado = Estado::Sincronia;
+    _longitud = 0;
+    _recibidos = 0;
+    _crc = 0;
+}
+
+bool AnalizadorBinario::consumir(const char*& datos, const char* fin, BloqueBinario& salida) noexcept
+{
+    while (datos < fin) {
+        const unsigned char byte = static_cast<unsigned char>(*datos);
+        switch (_estado) {
+        case Estado::Sincronia:
+            ++datos;
+            if (byte == ProtocoloBinario::kSincronia) {
+                _estado = Estado::Longitud;
+            } else {
+                ++_descartados;
+            }
+            break;
+        case Estado::Longitud:
+            ++datos;
+            if (byte == 0) {
+                salida.error = ErrorBinario::Vacio;
+                salida.cuerpo = nullptr;
+                salida.longitud = 0;
+                reiniciar();
+                return true;
+            }
+            _longitud = byte;
+            _recibidos = 0;
+            _estado = Estado::Cuerpo;
+            break;
+        case Estado::Cuerpo: {
+            // El cuerpo se copia por tramos: un bloque partido entre lecturas cuesta dos memcpy.
+            std::size_t tramo = _longitud - _recibidos;
+            const std::size_t disponibles = static_cast<std::size_t>(fin - datos);
+            if (tramo > disponibles) {
+                tramo = disponibles;
+            }
+            std::memcpy(_cuerpo + _recibidos, datos, tramo);
+            _recibidos += tramo;
+            datos += tramo;
+            if (_recibidos == _longitud) {
+                _estado = Estado::CrcAlto;
+            }
+            break;
+        }
+        case Estado::CrcAlto:
+            ++datos;
+            _crc = static_cast<std::uint16_t>(byte << 8);
+            _estado = Estado::CrcBajo;
+            break;
+        case Estado::CrcBajo: {
+            ++datos;
+            _crc = static_cast<std::uint16_t>(_crc | byte);
+            const unsigned char longitud = static_cast<unsigned char>(_longitud);
+            std::uint16_t esperado = ProtocoloBinario::crc16(&longitud, 1);
+            esperado = ProtocoloBinario::crc16(_cuerpo, _longitud, esperado);
+            salida.error = (esperado == _crc) ? ErrorBinario::Ninguno : ErrorBinario::Crc;
+            salida.cuerpo = _cuerpo;
+            salida.longitud = _longitud;
+            reiniciar();
+            return true;
+        }
+        }
+    }
+    return false;
+}
+
+std::uint64_t AnalizadorBinario::bytesDescartados() const noexcept
+{
+    return _descartados;
+}
@@ -0,0 +1,362 @@
+#include "AnalizadorTramas.h"
+
+#include "ProtocoloBinario.h"
+
+#include <climits>
+
+namespace {
+
+const char kInicio[] = "INICIO";
+const std::size_t kLongitudInicio = sizeof(kInicio) - 1;
+// "INICIO-BIN" comienza con "INICIO": el mismo recorrido reconoce ambos marcadores.
+const char* const kInicioBinario = ProtocoloBinario::kMarcador;
+const std::size_t kLongitudInicioBinario = ProtocoloBinario::kLongitudMarcador;
+const char kFin[] = "FIN";
+const std::size_t kLongitudFin = sizeof(kFin) - 1;
+
+/**
+ * @brief Tokens con nombre aceptados en una trama LOAD.
+ */
+struct TokenNombrado {
+    const char* texto;
+    std::size_t longitud;
+    char valor;
+};
+
+const TokenNombrado kTokens[] = {
+    {"Space", 5, ' '}, {"SPACE", 5, ' '},
+    {"Tab", 3, '\t'}, {"TAB", 3, '\t'},
+    {"Comma", 5, ','}, {"COMMA", 5, ','}
+};
+const unsigned kTotalTokens = sizeof(kTokens) / sizeof(kTokens[0]);
+const unsigned kTodosLosTokens = (1u << kTotalTokens) - 1u;
+
+// Deja margen para un dígito más sin desbordar; alcanza para marcas en nanosegundos.
+const long kLimiteAcumulado = LONG_MAX / 10;
+
+char aMayuscula(char c) noexcept
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+bool esEspacio(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool esDigito(char c) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+AnalizadorTramas::AnalizadorTramas() noexcept : _maxLongitud(kLongitudMaximaPorDefecto)
+{
+    reiniciar();
+}
+
+void AnalizadorTramas::reiniciar() noexcept
+{
+    _estado = Estado::Prefijo;
+    _numero = EstadoNumero::Espacios;
+    _longitud = 0;
+    _prefijo = '\0';
+    _posInicio = 0;
+    _esInicio = true;
+    _posFin = 0;
+    _esFin = true;
+    _hayCarga = false;
+    _lonCarga = 0;
+    _primeros[0] = _primeros[1] = _primeros[2] = '\0';
+    _candidatos = kTodosLosTokens;
+    _negativo = false;
+    _valor = 0;
+    _lonLote = 0;
+    _canal = -1;
+    _digitosCanal = 0;
+    _retornoPendiente = false;
+}
+
+void AnalizadorTramas::setLongitudMaxima(std::size_t maximo) noexcept
+{
+    _maxLongitud = maximo;
+}
+
+bool AnalizadorTramas::consumir(char byte, TramaDecodificada& salida) noexcept
+{
+    if (byte == '\n') {
+        return finalizar(salida);
+    }
+    // Solo el '\r' que precede a '\n' es terminador; se retiene hasta ver el byte siguiente.
+    if (_retornoPendiente) {
+        _retornoPendiente = false;
+        procesarByte('\r');
+    }
+    if (byte == '\r') {
+        _retornoPendiente = true;
+        return false;
+    }
+    procesarByte(byte);
+    return false;
+}
+
+bool AnalizadorTramas::finalizar(TramaDecodificada& salida) noexcept
+{
+    const bool hayLinea = _longitud > 0;
+    if (hayLinea) {
+        cerrar(salida);
+    }
+    reiniciar();
+    return hayLinea;
+}
+
+bool AnalizadorTramas::analizarLinea(const char* linea, std::size_t longitud, TramaDecodificada& salida) noexcept
+{
+    reiniciar();
+    if (!linea) {
+        return false;
+    }
+    for (std::size_t i = 0; i < longitud; ++i) {
+        const char byte = linea[i];
+        const bool terminador = byte == '\n' || (byte == '\r' && (i + 1 == longitud || linea[i + 1] == '\n'));
+        if (!terminador) {
+            procesarByte(byte);
+        }
+    }
+    return finalizar(salida);
+}
+
+void AnalizadorTramas::procesarByte(char byte) noexcept
+{
+    ++_longitud;
+
+    if (_esInicio) {
+        if (_posInicio < kLongitudInicioBinario && aMayuscula(byte) == kInicioBinario[_posInicio]) {
+            ++_posInicio;
+        } else {
+            _esInicio = false;
+        }
+    }
+    if (_esFin) {
+        if (_posFin < kLongitudFin && aMayuscula(byte) == kFin[_posFin]) {
+            ++_posFin;
+        } else {
+            _esFin = false;
+        }
+    }
+
+    switch (_estado) {
+    case Estado::Prefijo:
+        if (esDigito(byte) && _canal < 0) {
+            _digitosCanal = byte - '0';
+            _estado = Estado::Canal;
+        } else if (byte != ',') {
+            _prefijo = aMayuscula(byte);
+            _estado = Estado::Tipo;
+        }
+        break;
+    case Estado::Canal:
+        if (esDigito(byte)) {
+            // Satura en vez de desbordar; cerrar() lo reporta como fuera de rango.
+            if (_digitosCanal <= kMaxCanales) {
+                _digitosCanal = _digitosCanal * 10 + (byte - '0');
+            }
+        } else if (byte == ':') {
+            // La trama empieza de nuevo después del prefijo, INICIO incluido.
+            _canal = _digitosCanal;
+            _esInicio = true;
+            _posInicio = 0;
+            _esFin = true;
+            _posFin = 0;
+            _estado = Estado::Prefijo;
+        } else {
+            // Un número sin ':' no es prefijo de canal: la línea tiene un prefijo desconocido.
+            _prefijo = '0';
+            _estado = (byte == ',') ? Estado::AntesDeCarga : Estado::Tipo;
+        }
+        break;
+    case Estado::Tipo:
+        if (byte == ',') {
+            _estado = (_prefijo == 'B') ? Estado::Lote : Estado::AntesDeCarga;
+        }
+        break;
+    case Estado::AntesDeCarga:
+        if (byte == ',') {
+            break;
+        }
+        _hayCarga = true;
+        _estado = Estado::Carga;
+        if (byte != ' ') {
+            avanzarCarga(byte);
+        }
+        break;
+    case Estado::Carga:
+        if (byte == ',') {
+            _estado = Estado::DespuesDeCarga;
+        } else if (byte != ' ' || _lonCarga > 0) {
+            avanzarCarga(byte);
+        }
+        break;
+    case Estado::DespuesDeCarga:
+        break;
+    case Estado::Lote:
+        _hayCarga = true;
+        if (_lonLote < kMaxLote) {
+            _lote[_lonLote] = byte;
+        }
+        ++_lonLote;
+        break;
+    }
+}
+
+void AnalizadorTramas::avanzarCarga(char byte) noexcept
+{
+    if (_lonCarga < sizeof(_primeros)) {
+        _primeros[_lonCarga] = byte;
+    }
+
+    for (unsigned i = 0; i < kTotalTokens; ++i) {
+        const unsigned bit = 1u << i;
+        if ((_candidatos & bit) && (_lonCarga >= kTokens[i].longitud || kTokens[i].texto[_lonCarga] != byte)) {
+            _candidatos &= ~bit;
+        }
+    }
+
+    switch (_numero) {
+    case EstadoNumero::Espacios:
+        if (esEspacio(byte)) {
+            break;
+        }
+        if (byte == '+' || byte == '-') {
+            _negativo = (byte == '-');
+            _numero = EstadoNumero::Signo;
+        } else if (esDigito(byte)) {
+            _valor = byte - '0';
+            _numero = EstadoNumero::Digitos;
+        } else {
+            _numero = EstadoNumero::Invalido;
+        }
+        break;
+    case EstadoNumero::Signo:
+        if (esDigito(byte)) {
+            _valor = byte - '0';
+            _numero = EstadoNumero::Digitos;
+        } else {
+            _numero = EstadoNumero::Invalido;
+        }
+        break;
+    case EstadoNumero::Digitos:
+        if (esDigito(byte)) {
+            if (_valor < kLimiteAcumulado) {
+                _valor = _valor * 10 + (byte - '0');
+            }
+        } else {
+            _numero = EstadoNumero::Terminado;
+        }
+        break;
+    case EstadoNumero::Terminado:
+    case EstadoNumero::Invalido:
+        break;
+    }
+
+    ++_lonCarga;
+}
+
+void AnalizadorTramas::cerrar(TramaDecodificada& salida) const noexcept
+{
+    salida.tipo = TipoTrama::Invalida;
+    salida.error = ErrorTrama::Ninguno;
+    salida.dato = '\0';
+    salida.desplazamiento = 0;
+    salida.marca = 0;
+    salida.lote = nullptr;
+    salida.longitudLote = 0;
+    salida.canal = _canal;
+
+    if (_longitud > _maxLongitud || _lonLote > kMaxLote) {
+        salida.error = ErrorTrama::Desbordada;
+        return;
+    }
+
+    if (_canal >= kMaxCanales) {
+        salida.error = ErrorTrama::CanalInvalido;
+        return;
+    }
+
+    if (_esInicio && _posInicio == kLongitudInicio) {
+        salida.tipo = TipoTrama::Inicio;
+        return;
+    }
+
+    // El modo binario es del enlace completo, no de un canal.
+    if (_esInicio && _posInicio == kLongitudInicioBinario && _canal < 0) {
+        salida.tipo = TipoTrama::InicioBinario;
+        return;
+    }
+
+    if (_esFin && _posFin == kLongitudFin) {
+        salida.tipo = TipoTrama::FinMensaje;
+        return;
+    }
+
+    if (!_hayCarga) {
+        salida.error = ErrorTrama::Incompleta;
+        return;
+    }
+
+    if (_prefijo == 'L') {
+        if (_lonCarga == 3 && _primeros[0] == '\'' && _primeros[2] == '\'') {
+            salida.dato = _primeros[1];
+        } else if (_lonCarga == 1) {
+            salida.dato = _primeros[0];
+        } else {
+            unsigned i = 0;
+            while (i < kTotalTokens && !((_candidatos & (1u << i)) && kTokens[i].longitud == _lonCarga)) {
+                ++i;
+            }
+            if (i == kTotalTokens) {
+                salida.error = ErrorTrama::TokenInvalido;
+                return;
+            }
+            salida.dato = kTokens[i].valor;
+        }
+        salida.tipo = TipoTrama::Carga;
+        return;
+    }
+
+    if (_prefijo == 'M') {
+        if (_numero != EstadoNumero::Digitos && _numero != EstadoNumero::Terminado) {
+            salida.error = ErrorTrama::RotacionInvalida;
+            return;
+        }
+        long valor = _negativo ? -_valor : _valor;
+        if (valor > INT_MAX) {
+            valor = INT_MAX;
+        } else if (valor < INT_MIN) {
+            valor = INT_MIN;
+        }
+        salida.tipo = TipoTrama::Mapa;
+        salida.desplazamiento = static_cast<int>(valor);
+        return;
+    }
+
+    if (_prefijo == 'B') {
+        salida.tipo = TipoTrama::Lote;
+        salida.lote = _lote;
+        salida.longitudLote = _lonLote;
+        return;
+    }
+
+    if (_prefijo == 'T') {
+        if (_negativo || (_numero != EstadoNumero::Digitos && _numero != EstadoNumero::Terminado)) {
+            salida.error = ErrorTrama::TokenInvalido;
+            return;
+        }
+        salida.tipo = TipoTrama::Marca;
+        salida.marca = _valor;
+        return;
+    }
+
+    salida.error = ErrorTrama::PrefijoDesconocido;
+}
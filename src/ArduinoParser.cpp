@@ -1,11 +1,23 @@
 #include "ArduinoParser.h"
 
+#include "AnalizadorTramas.h"
 #include "AuxiliarCli.h"
+#include "GrabadorCaptura.h"
+#include "InstrumentacionEtapas.h"
 #include "LineaDispatcher.h"
+#include "ProtocoloBinario.h"
+#include "RegistroContadores.h"
+#include "TuberiaCaptura.h"
+#include "VelocidadSerie.h"
 
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
+#include <ctime>
 #include <fcntl.h>
+#include <linux/serial.h>
+#include <new>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <termios.h>
@@ -30,11 +42,133 @@ speed_t traducirBaudRate(unsigned baud)
         return B230400;
     case 460800:
         return B460800;
+#ifdef B921600
+    case 921600:
+        return B921600;
+#endif
+#ifdef B1000000
+    case 1000000:
+        return B1000000;
+#endif
+#ifdef B1500000
+    case 1500000:
+        return B1500000;
+#endif
+#ifdef B2000000
+    case 2000000:
+        return B2000000;
+#endif
+#ifdef B3000000
+    case 3000000:
+        return B3000000;
+#endif
+#ifdef B4000000
+    case 4000000:
+        return B4000000;
+#endif
     default:
         return B0;
     }
 }
 
+/**
+ * @brief Baudrates que prueba la detección, de los más comunes a los menos.
+ */
+const unsigned kBaudiosCandidatos[] = {115200, 9600, 57600, 230400, 460800, 921600, 1000000,
+                                       2000000, 500000, 1500000, 3000000, 4000000, 38400, 19200};
+const std::size_t kCantidadCandidatos = sizeof(kBaudiosCandidatos) / sizeof(kBaudiosCandidatos[0]);
+
+// Un candidato se acepta con al menos kMinTramasValidas y como máximo una inválida
+// por cada kProporcionValidas válidas; con kTramasConfirmacion se deja de buscar.
+const unsigned kMinTramasValidas = 4;
+const unsigned kProporcionValidas = 4;
+const unsigned kTramasConfirmacion = 16;
+
+const cc_t kVminRendimiento = 255;
+
+/**
+ * @brief Activa o desactiva ASYNC_LOW_LATENCY en el controlador serie.
+ *
+ * Con la bandera activa, los controladores USB-serie y 8250 entregan cada byte al
+ * tty sin esperar su temporizador de agrupación. Las pty no la soportan.
+ */
+void aplicarBajaLatencia(int fd, bool activar, AuxiliarCli* logger)
+{
+    serial_struct serie {};
+    if (ioctl(fd, TIOCGSERIAL, &serie) != 0) {
+        if (logger) {
+            logger->imprimirLog("STATUS", "El dispositivo no admite ASYNC_LOW_LATENCY; se omite.");
+        }
+        return;
+    }
+    if (activar) {
+        serie.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        serie.flags &= ~ASYNC_LOW_LATENCY;
+    }
+    if (ioctl(fd, TIOCSSERIAL, &serie) != 0 && logger) {
+        logger->imprimirLog("WARNING", "No se pudo cambiar ASYNC_LOW_LATENCY.");
+    }
+}
+
+long milisegundosDesde(const timespec& inicio)
+{
+    timespec ahora {};
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (ahora.tv_sec - inicio.tv_sec) * 1000 + (ahora.tv_nsec - inicio.tv_nsec) / 1000000;
+}
+
+/**
+ * @brief Escucha un descriptor durante @p ms y cuenta las tramas PRT-7 válidas e inválidas.
+ *
+ * La primera línea se descarta porque la escucha puede empezar a mitad de una trama.
+ */
+void contarTramas(int fd, unsigned ms, unsigned& validas, unsigned& invalidas)
+{
+    AnalizadorTramas analizador;
+    TramaDecodificada trama;
+    bool sincronizado = false;
+    char bloque[512];
+    validas = 0;
+    invalidas = 0;
+
+    timespec inicio {};
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    long transcurrido = 0;
+    while (transcurrido < static_cast<long>(ms) && validas < kTramasConfirmacion) {
+        pollfd puerto {fd, POLLIN, 0};
+        const int listo = ::poll(&puerto, 1, static_cast<int>(ms - transcurrido));
+        transcurrido = milisegundosDesde(inicio);
+        if (listo <= 0) {
+            if (listo < 0 && errno != EINTR) {
+                return;
+            }
+            continue;
+        }
+
+        const ssize_t leidos = ::read(fd, bloque, sizeof(bloque));
+        if (leidos <= 0) {
+            if (leidos == 0 || (errno != EAGAIN && errno != EINTR)) {
+                return;
+            }
+            continue;
+        }
+        for (ssize_t i = 0; i < leidos; ++i) {
+            if (!sincronizado) {
+                sincronizado = (bloque[i] == '\n');
+                continue;
+            }
+            if (analizador.consumir(bloque[i], trama)) {
+                if (trama.error == ErrorTrama::Ninguno) {
+                    ++validas;
+                } else {
+                    ++invalidas;
+                }
+            }
+        }
+    }
+}
+
 } // namespace
 
 ArduinoParser::ArduinoParser(AuxiliarCli* logger, LineaDispatcher* target) noexcept
@@ -43,10 +177,27 @@ ArduinoParser::ArduinoParser(AuxiliarCli* logger, LineaDispatcher* target) noexc
     , _baud(115200)
     , _logger(logger)
     , _target(target)
+    , _grabador(nullptr)
+    , _instrumentacion(nullptr)
+    , _contadores(nullptr)
+    , _maxLinea(AnalizadorTramas::kLongitudMaximaPorDefecto)
+    , _modo(ModoLectura::Lineas)
+    , _perfil(PerfilEntrada::Estandar)
+    , _buffer(nullptr)
+    , _capacidad(0)
+    , _usados(0)
+    , _desbordado(false)
+    , _binario(false)
 {
     _customPath[0] = '\0';
 }
 
+ArduinoParser::~ArduinoParser()
+{
+    closePort();
+    delete[] _buffer;
+}
+
 void ArduinoParser::setPreset(Preset p) noexcept
 {
     _preset = p;
@@ -72,11 +223,65 @@ void ArduinoParser::setBaudrate(unsigned baud) noexcept
     _baud = baud;
 }
 
+void ArduinoParser::setLongitudMaximaLinea(std::size_t maximo) noexcept
+{
+    if (maximo == 0) {
+        maximo = 1;
+    }
+    if (maximo != _maxLinea) {
+        _maxLinea = maximo;
+        delete[] _buffer;
+        _buffer = nullptr;
+        _capacidad = 0;
+    }
+}
+
+std::size_t ArduinoParser::getLongitudMaximaLinea() const noexcept
+{
+    return _maxLinea;
+}
+
+void ArduinoParser::setModoLectura(ModoLectura modo) noexcept
+{
+    _modo = modo;
+}
+
+void ArduinoParser::setPerfil(PerfilEntrada perfil) noexcept
+{
+    if (perfil != _perfil) {
+        _perfil = perfil;
+        // El tamaño del bloque de lectura depende del perfil.
+        delete[] _buffer;
+        _buffer = nullptr;
+        _capacidad = 0;
+    }
+}
+
+PerfilEntrada ArduinoParser::getPerfil() const noexcept
+{
+    return _perfil;
+}
+
 void ArduinoParser::setTarget(LineaDispatcher* target) noexcept
 {
     _target = target;
 }
 
+void ArduinoParser::setGrabador(GrabadorCaptura* grabador) noexcept
+{
+    _grabador = grabador;
+}
+
+void ArduinoParser::setInstrumentacion(InstrumentacionEtapas* instrumentacion) noexcept
+{
+    _instrumentacion = instrumentacion;
+}
+
+void ArduinoParser::setContadores(RegistroContadores* contadores) noexcept
+{
+    _contadores = contadores;
+}
+
 Preset ArduinoParser::getPreset() const noexcept
 {
     return _preset;
@@ -87,6 +292,36 @@ unsigned ArduinoParser::getBaudrate() const noexcept
     return _baud;
 }
 
+const char* ArduinoParser::nombrePerfil(PerfilEntrada perfil) noexcept
+{
+    switch (perfil) {
+    case PerfilEntrada::BajaLatencia:
+        return "baja-latencia";
+    case PerfilEntrada::Rendimiento:
+        return "rendimiento";
+    case PerfilEntrada::Estandar:
+    default:
+        return "estandar";
+    }
+}
+
+bool ArduinoParser::interpretarPerfil(const char* nombre, PerfilEntrada& perfil) noexcept
+{
+    if (!nombre) {
+        return false;
+    }
+    if (std::strcmp(nombre, "estandar") == 0) {
+        perfil = PerfilEntrada::Estandar;
+    } else if (std::strcmp(nombre, "baja-latencia") == 0) {
+        perfil = PerfilEntrada::BajaLatencia;
+    } else if (std::strcmp(nombre, "rendimiento") == 0) {
+        perfil = PerfilEntrada::Rendimiento;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 const char* ArduinoParser::defaultPathFor(Preset p) noexcept
 {
     switch (p) {
@@ -118,28 +353,55 @@ bool ArduinoParser::openPort()
     std::strncpy(ruta, predeterminada, sizeof(ruta));
     ruta[sizeof(ruta) - 1] = '\0';
 
-    _fd = ::open(ruta, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    return openPath(ruta);
+}
+
+bool ArduinoParser::openPath(const char* ruta)
+{
+    if (_fd >= 0) {
+        closePort();
+    }
+
+    _fd = abrirDispositivo(ruta, _baud, true, _logger, _perfil);
     if (_fd < 0) {
-        if (_logger) {
-            _logger->imprimirLog("ERROR", "No se pudo abrir el puerto serie.");
-        }
         return false;
     }
 
-    termios opciones {};
-    if (tcgetattr(_fd, &opciones) != 0) {
-        if (_logger) {
-            _logger->imprimirLog("ERROR", "tcgetattr falló al leer la configuración.");
+    if (_logger) {
+        _logger->imprimirLog("STATUS", "Puerto serie abierto correctamente.");
+    }
+
+    return true;
+}
+
+int ArduinoParser::abrirDispositivo(const char* ruta, unsigned baud, bool bloqueante, AuxiliarCli* logger,
+                                    PerfilEntrada perfil)
+{
+    if (!ruta || ruta[0] == '\0') {
+        return -1;
+    }
+
+    const int fd = ::open(ruta, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        if (logger) {
+            logger->imprimirLog("ERROR", "No se pudo abrir el puerto serie.");
         }
-        closePort();
-        return false;
+        return -1;
     }
 
-    speed_t velocidad = traducirBaudRate(_baud);
-    if (velocidad == B0) {
-        if (_logger) {
-            _logger->imprimirLog("WARNING", "Baudrate no soportado, se usará 115200.");
+    termios opciones {};
+    if (tcgetattr(fd, &opciones) != 0) {
+        if (logger) {
+            logger->imprimirLog("ERROR", "tcgetattr falló al leer la configuración.");
         }
+        ::close(fd);
+        return -1;
+    }
+
+    // Las velocidades fuera de la tabla se configuran después con termios2/BOTHER.
+    speed_t velocidad = traducirBaudRate(baud);
+    const bool personalizada = (velocidad == B0);
+    if (personalizada) {
         velocidad = B115200;
     }
 
@@ -156,33 +418,94 @@ bool ArduinoParser::openPort()
     opciones.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
     opciones.c_oflag &= ~OPOST;
 
-    opciones.c_cc[VMIN] = 0;
-    opciones.c_cc[VTIME] = 1;
+    switch (perfil) {
+    case PerfilEntrada::BajaLatencia:
+        opciones.c_cc[VMIN] = 1;
+        opciones.c_cc[VTIME] = 0;
+        bloqueante = false;
+        break;
+    case PerfilEntrada::Rendimiento:
+        // read() vuelve con kVminRendimiento bytes o tras 100 ms sin recibir nada.
+        opciones.c_cc[VMIN] = kVminRendimiento;
+        opciones.c_cc[VTIME] = 1;
+        break;
+    case PerfilEntrada::Estandar:
+    default:
+        opciones.c_cc[VMIN] = 0;
+        opciones.c_cc[VTIME] = 1;
+        break;
+    }
 
-    if (tcsetattr(_fd, TCSANOW, &opciones) != 0) {
-        if (_logger) {
-            _logger->imprimirLog("ERROR", "tcsetattr falló al configurar el puerto.");
+    if (tcsetattr(fd, TCSANOW, &opciones) != 0) {
+        if (logger) {
+            logger->imprimirLog("ERROR", "tcsetattr falló al configurar el puerto.");
         }
-        closePort();
-        return false;
+        ::close(fd);
+        return -1;
+    }
+
+    if (personalizada && !VelocidadSerie::aplicarPersonalizada(fd, baud) && logger) {
+        logger->imprimirLog("WARNING", "Baudrate no soportado por el controlador, se usará 115200.");
+    }
+
+    if (perfil != PerfilEntrada::Estandar) {
+        aplicarBajaLatencia(fd, perfil == PerfilEntrada::BajaLatencia, logger);
     }
 
     int flags = 0;
-    if (ioctl(_fd, TIOCMGET, &flags) != -1) {
+    if (ioctl(fd, TIOCMGET, &flags) != -1) {
         flags |= (TIOCM_DTR | TIOCM_RTS);
-        ioctl(_fd, TIOCMSET, &flags);
-    } else if (_logger) {
-        _logger->imprimirLog("WARNING", "No se pudieron activar DTR/RTS.");
+        ioctl(fd, TIOCMSET, &flags);
+    } else if (logger) {
+        logger->imprimirLog("WARNING", "No se pudieron activar DTR/RTS.");
     }
 
-    int fcntlFlags = fcntl(_fd, F_GETFL, 0);
-    fcntl(_fd, F_SETFL, fcntlFlags & ~O_NONBLOCK);
-
-    if (_logger) {
-        _logger->imprimirLog("STATUS", "Puerto serie abierto correctamente.");
+    if (bloqueante) {
+        int fcntlFlags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, fcntlFlags & ~O_NONBLOCK);
     }
 
-    return true;
+    return fd;
+
+}
+
+unsigned ArduinoParser::detectarBaudrate(const char* ruta, AuxiliarCli* logger, unsigned msPorCandidato)
+{
+    unsigned mejor = 0;
+    unsigned mejorValidas = 0;
+    for (std::size_t i = 0; i < kCantidadCandidatos; ++i) {
+        const unsigned candidato = kBaudiosCandidatos[i];
+        const int fd = abrirDispositivo(ruta, candidato, false, nullptr);
+        if (fd < 0) {
+            if (logger) {
+                logger->imprimirLog("ERROR", "No se pudo abrir el puerto serie para detectar el baudrate.");
+            }
+            return 0;
+        }
+        tcflush(fd, TCIFLUSH);
+
+        unsigned validas = 0;
+        unsigned invalidas = 0;
+        contarTramas(fd, msPorCandidato, validas, invalidas);
+        ::close(fd);
+
+        if (logger) {
+            char mensaje[128];
+            std::snprintf(mensaje, sizeof(mensaje), "%u baudios: %u tramas válidas, %u inválidas.", candidato, validas,
+                          invalidas);
+            logger->imprimirLog("STATUS", mensaje);
+        }
+
+        const bool aceptable = validas >= kMinTramasValidas && invalidas * kProporcionValidas <= validas;
+        if (aceptable && validas > mejorValidas) {
+            mejor = candidato;
+            mejorValidas = validas;
+            if (validas >= kTramasConfirmacion) {
+                break;
+            }
+        }
+    }
+    return mejor;
 }
 
 void ArduinoParser::closePort() noexcept
@@ -209,33 +532,65 @@ bool ArduinoParser::listenUntilEnter()
         _logger->imprimirLog("STATUS", "ENTER detiene la captura.");
     }
 
-    char recibido[256];
-    std::size_t usados = 0;
-    bool overflow = false;
+    if (!prepararBuffer()) {
+        if (_logger) {
+            _logger->imprimirLog("ERROR", "No se pudo reservar el buffer de lectura.");
+        }
+        return false;
+    }
+    _usados = 0;
+    _desbordado = false;
+    _binario = false;
+    if (_target) {
+        _target->setLongitudMaximaLinea(_maxLinea);
+    }
 
     bool continuar = true;
+    bool vigilarEntrada = true;
     while (continuar) {
         fd_set lectura;
         FD_ZERO(&lectura);
         FD_SET(_fd, &lectura);
-        FD_SET(STDIN_FILENO, &lectura);
+        if (vigilarEntrada) {
+            FD_SET(STDIN_FILENO, &lectura);
+        }
 
         const int maxFd = (_fd > STDIN_FILENO) ? _fd : STDIN_FILENO;
-        const int resultado = select(maxFd + 1, &lectura, nullptr, nullptr, nullptr);
+        // Con grabación, select() despierta aunque el puerto calle para vaciar lo pendiente a tiempo.
+        timeval espera {GrabadorCaptura::kIntervaloVaciadoMs / 1000,
+                        (GrabadorCaptura::kIntervaloVaciadoMs % 1000) * 1000};
+        const int resultado = select(maxFd + 1, &lectura, nullptr, nullptr, _grabador ? &espera : nullptr);
+        if (_grabador) {
+            _grabador->vaciarSiVencido();
+        }
         if (resultado < 0) {
             if (errno == EINTR) {
+#if PRT7_INSTRUMENTACION
+                if (_instrumentacion && InstrumentacionEtapas::reporteSolicitado()) {
+                    _instrumentacion->imprimirReporte(_logger);
+                }
+#endif
+                if (_contadores && RegistroContadores::volcadoSolicitado()) {
+                    _contadores->volcar();
+                }
                 continue;
             }
+            if (_contadores) {
+                _contadores->sumar(Contador::ErroresLectura);
+            }
             if (_logger) {
                 _logger->imprimirLog("ERROR", "select() reportó un fallo.");
             }
             return false;
         }
 
-        if (FD_ISSET(STDIN_FILENO, &lectura)) {
+        if (vigilarEntrada && FD_ISSET(STDIN_FILENO, &lectura)) {
             char buffer[32];
             const ssize_t leidos = ::read(STDIN_FILENO, buffer, sizeof(buffer));
-            if (leidos > 0) {
+            if (leidos == 0) {
+                // STDIN cerrado (p. ej. </dev/null): solo la desconexión detiene la captura.
+                vigilarEntrada = false;
+            } else if (leidos > 0) {
                 for (ssize_t i = 0; i < leidos; ++i) {
                     if (buffer[i] == '\n') {
                         continuar = false;
@@ -250,42 +605,13 @@ bool ArduinoParser::listenUntilEnter()
         }
 
         if (FD_ISSET(_fd, &lectura)) {
-            char buffer[64];
-            const ssize_t leidos = ::read(_fd, buffer, sizeof(buffer));
-            if (leidos > 0) {
-                for (ssize_t i = 0; i < leidos; ++i) {
-                    char c = buffer[i];
-                    if (c == '\r') {
-                        continue;
-                    }
-                    if (c == '\n') {
-                        if (usados > 0) {
-                            recibido[usados] = '\0';
-                            if (_target) {
-                                _target->onRawLine(recibido);
-                            }
-                        } else if (overflow && _logger) {
-                            _logger->imprimirLog("WARNING", "Trama descartada por exceder el buffer.");
-                        }
-                        usados = 0;
-                        overflow = false;
-                    } else {
-                        if (usados + 1 < sizeof(recibido)) {
-                            recibido[usados++] = c;
-                        } else {
-                            overflow = true;
-                        }
-                    }
-                }
-            } else if (leidos == 0) {
-                if (_logger) {
-                    _logger->imprimirLog("WARNING", "Desconexión detectada en el puerto serie.");
-                }
-                return false;
-            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                if (_logger) {
-                    _logger->imprimirLog("WARNING", "Fallo al leer del puerto serie.");
-                }
+            // En baja latencia el descriptor no bloquea: se drena todo lo disponible
+            // antes de volver a select(), así un despertar atiende la ráfaga completa.
+            ssize_t leidos = 0;
+            do {
+                leidos = leerPuerto();
+            } while (leidos > 0 && _perfil == PerfilEntrada::BajaLatencia);
+            if (leidos < 0) {
                 return false;
             }
         }
@@ -293,3 +619,194 @@ bool ArduinoParser::listenUntilEnter()
 
     return true;
 }
+
+bool ArduinoParser::listenEnTuberia(int salidaFd)
+{
+    if (_fd < 0 || !_target) {
+        if (_logger) {
+            _logger->imprimirLog("ERROR", "Puerto serie no disponible.");
+        }
+        return false;
+    }
+
+    _target->setLongitudMaximaLinea(_maxLinea);
+    TuberiaCaptura* tuberia = new TuberiaCaptura(_fd, _target, _logger, salidaFd);
+    tuberia->setGrabador(_grabador);
+    tuberia->setContadores(_contadores);
+    const bool exito = tuberia->ejecutarHastaEnter();
+    delete tuberia;
+    return exito;
+}
+
+bool ArduinoParser::alimentar(const char* datos, std::size_t cantidad)
+{
+    if (!datos || cantidad == 0) {
+        return true;
+    }
+    PRT7_INSTRUMENTAR(_instrumentacion, inicioBloque());
+    if (_contadores) {
+        _contadores->sumar(Contador::Lecturas);
+        _contadores->sumar(Contador::BytesLeidos, cantidad);
+    }
+
+    if (_modo == ModoLectura::Flujo) {
+        if (_target) {
+            _target->onRawBytes(datos, cantidad);
+        }
+        return true;
+    }
+
+    if (!prepararBuffer()) {
+        return false;
+    }
+
+    // despacharLineas() deja a lo sumo _maxLinea + 1 bytes, así que siempre queda espacio.
+    while (cantidad > 0) {
+        std::size_t copia = _capacidad - _usados;
+        if (copia > cantidad) {
+            copia = cantidad;
+        }
+        std::memcpy(_buffer + _usados, datos, copia);
+        _usados += copia;
+        datos += copia;
+        cantidad -= copia;
+        despacharLineas();
+    }
+    return true;
+}
+
+ssize_t ArduinoParser::leerPuerto()
+{
+    const ssize_t leidos = ::read(_fd, _buffer + _usados, _capacidad - _usados);
+    if (leidos > 0) {
+        PRT7_INSTRUMENTAR(_instrumentacion, inicioBloque());
+        if (_contadores) {
+            _contadores->sumar(Contador::Lecturas);
+            _contadores->sumar(Contador::BytesLeidos, static_cast<std::uint64_t>(leidos));
+        }
+        if (_grabador) {
+            _grabador->registrar(_buffer + _usados, static_cast<std::size_t>(leidos));
+        }
+        if (_modo == ModoLectura::Flujo) {
+            if (_target) {
+                _target->onRawBytes(_buffer, static_cast<std::size_t>(leidos));
+            }
+        } else {
+            _usados += static_cast<std::size_t>(leidos);
+            despacharLineas();
+        }
+        return leidos;
+    }
+
+    if (leidos == 0) {
+        if (_contadores) {
+            _contadores->sumar(Contador::Desconexiones);
+        }
+        if (_logger) {
+            _logger->imprimirLog("WARNING", "Desconexión detectada en el puerto serie.");
+        }
+        return -1;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return 0;
+    }
+    if (_contadores) {
+        _contadores->sumar(Contador::ErroresLectura);
+    }
+    if (_logger) {
+        _logger->imprimirLog("WARNING", "Fallo al leer del puerto serie.");
+    }
+    return -1;
+}
+
+bool ArduinoParser::prepararBuffer()
+{
+    if (_buffer) {
+        return true;
+    }
+
+    const std::size_t bloque = (_perfil == PerfilEntrada::Rendimiento) ? kBloqueRendimiento : kBloqueLectura;
+    const std::size_t capacidad = _maxLinea + 1 + bloque;
+    _buffer = new (std::nothrow) char[capacidad];
+    if (!_buffer) {
+        return false;
+    }
+    _capacidad = capacidad;
+    return true;
+}
+
+void ArduinoParser::despacharLineas()
+{
+    VistaLinea lote[kMaxLote];
+    std::size_t enLote = 0;
+
+    const char* inicio = _buffer;
+    const char* const fin = _buffer + _usados;
+    while (inicio < fin) {
+        if (_binario) {
+            BloqueBinario bloque;
+            if (_analizadorBinario.consumir(inicio, fin, bloque)) {
+                PRT7_INSTRUMENTAR(_instrumentacion, finDelimitacion());
+                _binario = !_target || _target->onBloqueBinario(bloque);
+            }
+            continue;
+        }
+
+        const char* salto = static_cast<const char*>(std::memchr(inicio, '\n', static_cast<std::size_t>(fin - inicio)));
+        if (!salto) {
+            break;
+        }
+
+        std::size_t longitud = static_cast<std::size_t>(salto - inicio);
+        if (longitud > 0 && inicio[longitud - 1] == '\r') {
+            --longitud;
+        }
+
+        if (_desbordado || longitud > _maxLinea) {
+            if (_contadores) {
+                _contadores->sumar(Contador::InvalidasDesbordada);
+            }
+            if (_logger) {
+                _logger->imprimirLog("WARNING", "Trama descartada por exceder el buffer.");
+            }
+            _desbordado = false;
+        } else if (longitud > 0) {
+            lote[enLote].datos = inicio;
+            lote[enLote].longitud = longitud;
+            if (ProtocoloBinario::esMarcador(inicio, longitud)) {
+                // El marcador se entrega con las líneas previas; lo que sigue ya no son líneas.
+                PRT7_INSTRUMENTAR(_instrumentacion, finDelimitacion());
+                if (_target) {
+                    _target->onRawLines(lote, enLote + 1);
+                }
+                enLote = 0;
+                _binario = true;
+                _analizadorBinario.reiniciar();
+            } else if (++enLote == kMaxLote) {
+                PRT7_INSTRUMENTAR(_instrumentacion, finDelimitacion());
+                if (_target) {
+                    _target->onRawLines(lote, enLote);
+                }
+                enLote = 0;
+            }
+        }
+        inicio = salto + 1;
+    }
+
+    if (enLote > 0 && _target) {
+        PRT7_INSTRUMENTAR(_instrumentacion, finDelimitacion());
+        _target->onRawLines(lote, enLote);
+    }
+
+    std::size_t resto = static_cast<std::size_t>(fin - inicio);
+    // Un '\r' final puede ser el terminador de una línea cuyo '\n' llega en la siguiente lectura:
+    // no cuenta para el límite, igual que cuando ambos llegan juntos.
+    const std::size_t permitido = (resto > 0 && inicio[resto - 1] == '\r') ? _maxLinea + 1 : _maxLinea;
+    if (resto > permitido) {
+        _desbordado = true;
+        resto = 0;
+    } else if (resto > 0 && inicio != _buffer) {
+        std::memmove(_buffer, inicio, resto);
+    }
+    _usados = resto;
+}
@@ -0,0 +1,364 @@
+#include "AuxiliarCli.h"
+
+#include <cstdio>
+#include <new>
+
+namespace {
+
+const std::size_t kBytesPorLote = 64 * 1024;
+const std::size_t kMaxLinea = 512;
+// Tope de cada espera en EventoEspera; los avisos despiertan antes.
+const int kEsperaMaximaMs = 100;
+
+void copiarTipo(char* destino, std::size_t tam, const char* tipo)
+{
+    std::size_t i = 0;
+    for (; tipo && tipo[i] != '\0' && i + 1 < tam; ++i) {
+        destino[i] = tipo[i];
+    }
+    destino[i] = '\0';
+}
+
+void formatearTexto(const RegistroLog& registro, char* destino, std::size_t tam)
+{
+    std::snprintf(destino, tam, "%.*s", static_cast<int>(registro.longitudTexto), registro.texto);
+}
+
+} // namespace
+
+AuxiliarCli::AuxiliarCli() noexcept
+    : _nivel(static_cast<int>(NivelLog::Detalle))
+    , _cola(nullptr)
+    , _asincrono(false)
+    , _detener(false)
+    , _encolados(0)
+    , _escritos(0)
+    , _esperas(0)
+    , _largoBloqueado(false)
+{
+    _candado.clear();
+}
+
+AuxiliarCli::~AuxiliarCli()
+{
+    detenerAsincrono();
+    delete _cola;
+}
+
+void AuxiliarCli::imprimirLog(const char* tipo, const char* msj)
+{
+    if (!tipo || !msj) {
+        return;
+    }
+
+    NivelLog nivel = NivelLog::Status;
+    int color = 37;
+    clasificar(tipo, nivel, color);
+    if (!habilitado(nivel)) {
+        return;
+    }
+
+    const std::size_t longitud = std::strlen(msj);
+    if (longitud > RegistroLog::kMaxTexto) {
+        iniciarLogLargo(tipo);
+        escribirLogLargo(msj, longitud);
+        terminarLogLargo();
+        return;
+    }
+
+    RegistroLog registro;
+    registro.nivel = nivel;
+    registro.color = color;
+    copiarTipo(registro.tipo, sizeof(registro.tipo), tipo);
+    registro.formatear = formatearTexto;
+    registro.longitudTexto = longitud;
+    std::memcpy(registro.texto, msj, longitud);
+    emitir(registro);
+}
+
+bool AuxiliarCli::iniciarLogLargo(const char* tipo)
+{
+    NivelLog nivel = NivelLog::Status;
+    int color = 37;
+    clasificar(tipo, nivel, color);
+    if (!tipo || !habilitado(nivel)) {
+        return false;
+    }
+
+    // No cabe en un registro: se escribe directo con los demás productores detenidos,
+    // después de lo ya encolado, para conservar el orden del modo asíncrono.
+    _largoBloqueado = _asincrono.load(std::memory_order_acquire);
+    if (_largoBloqueado) {
+        while (_candado.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    vaciar();
+    std::cout << "\033[" << color << "m[" << tipo << "] ";
+    return true;
+}
+
+void AuxiliarCli::escribirLogLargo(const char* datos, std::size_t longitud)
+{
+    std::cout.write(datos, static_cast<std::streamsize>(longitud));
+}
+
+void AuxiliarCli::terminarLogLargo()
+{
+    std::cout << "\n\033[0m";
+    std::cout.flush();
+    if (_largoBloqueado) {
+        _largoBloqueado = false;
+        _candado.clear(std::memory_order_release);
+    }
+}
+
+void AuxiliarCli::registrar(NivelLog nivel, const char* tipo, FormateadorLog formatear, long a, long b, long c,
+                            const char* texto, std::size_t longitud)
+{
+    if (!habilitado(nivel) || !formatear) {
+        return;
+    }
+
+    NivelLog nivelEtiqueta = nivel;
+    RegistroLog registro;
+    registro.nivel = nivel;
+    registro.color = 37;
+    clasificar(tipo, nivelEtiqueta, registro.color);
+    copiarTipo(registro.tipo, sizeof(registro.tipo), tipo);
+    registro.formatear = formatear;
+    registro.enteros[0] = a;
+    registro.enteros[1] = b;
+    registro.enteros[2] = c;
+    if (!texto) {
+        longitud = 0;
+    }
+    if (longitud > RegistroLog::kMaxTexto) {
+        longitud = RegistroLog::kMaxTexto;
+    }
+    registro.longitudTexto = longitud;
+    if (longitud > 0) {
+        std::memcpy(registro.texto, texto, longitud);
+    }
+    emitir(registro);
+}
+
+void AuxiliarCli::imprimirCrudo(NivelLog nivel, const char* texto)
+{
+    if (!texto || !habilitado(nivel)) {
+        return;
+    }
+
+    std::size_t longitud = std::strlen(texto);
+    if (longitud > RegistroLog::kMaxTexto) {
+        longitud = RegistroLog::kMaxTexto;
+    }
+
+    RegistroLog registro;
+    registro.nivel = nivel;
+    registro.color = -1;
+    registro.tipo[0] = '\0';
+    registro.formatear = formatearTexto;
+    registro.longitudTexto = longitud;
+    std::memcpy(registro.texto, texto, longitud);
+    emitir(registro);
+}
+
+bool AuxiliarCli::iniciarAsincrono()
+{
+    if (_asincrono.load(std::memory_order_acquire)) {
+        return true;
+    }
+    if (!_cola) {
+        _cola = new (std::nothrow) ColaSpsc<RegistroLog, kRegistrosEnCola>;
+        if (!_cola) {
+            return false;
+        }
+    }
+
+    std::cout.flush();
+    _detener.store(false, std::memory_order_relaxed);
+    _esperas.store(0, std::memory_order_relaxed);
+    _escritor = std::thread(&AuxiliarCli::escribirEnFondo, this);
+    _asincrono.store(true, std::memory_order_release);
+    return true;
+}
+
+void AuxiliarCli::detenerAsincrono()
+{
+    if (!_asincrono.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    while (_candado.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    _asincrono.store(false, std::memory_order_release);
+    _candado.clear(std::memory_order_release);
+
+    _detener.store(true, std::memory_order_release);
+    _hayRegistros.notificar();
+    if (_escritor.joinable()) {
+        _escritor.join();
+    }
+
+    const unsigned long esperas = _esperas.load(std::memory_order_relaxed);
+    if (esperas > 0) {
+        char mensaje[96];
+        std::snprintf(mensaje, sizeof(mensaje), "El log esperó %lu veces por cola llena.", esperas);
+        imprimirLog("WARNING", mensaje);
+    }
+}
+
+void AuxiliarCli::vaciar()
+{
+    if (_asincrono.load(std::memory_order_acquire)) {
+        const unsigned long encolados = _encolados.load(std::memory_order_acquire);
+        while (_escritos.load(std::memory_order_acquire) < encolados) {
+            _progreso.esperar([this, encolados] { return _escritos.load(std::memory_order_acquire) >= encolados; },
+                              kEsperaMaximaMs);
+        }
+    }
+    std::cout.flush();
+}
+
+void AuxiliarCli::emitir(RegistroLog& registro)
+{
+    if (_asincrono.load(std::memory_order_acquire)) {
+        while (_candado.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        if (_asincrono.load(std::memory_order_relaxed)) {
+            RegistroLog* espacio = _cola->espacioLibre();
+            if (!espacio) {
+                _esperas.fetch_add(1, std::memory_order_relaxed);
+                while (!(espacio = _cola->espacioLibre())) {
+                    _progreso.esperar([this] { return _cola->tamano() < kRegistrosEnCola; }, kEsperaMaximaMs);
+                }
+            }
+            *espacio = registro;
+            _cola->publicar();
+            _encolados.fetch_add(1, std::memory_order_release);
+            _hayRegistros.notificar();
+            _candado.clear(std::memory_order_release);
+            return;
+        }
+        _candado.clear(std::memory_order_release);
+    }
+
+    char linea[kMaxLinea];
+    const std::size_t longitud = formatearLinea(registro, linea, sizeof(linea));
+    std::cout.write(linea, static_cast<std::streamsize>(longitud));
+}
+
+void AuxiliarCli::escribirEnFondo()
+{
+    char* lote = new (std::nothrow) char[kBytesPorLote];
+    if (!lote) {
+        return;
+    }
+
+    std::size_t usado = 0;
+    unsigned long pendientes = 0;
+    while (true) {
+        RegistroLog* registro = _cola->frente();
+        if (!registro) {
+            if (usado > 0) {
+                escribirDirecto(lote, usado);
+                usado = 0;
+                _escritos.fetch_add(pendientes, std::memory_order_release);
+                pendientes = 0;
+                _progreso.notificar();
+            }
+            if (_detener.load(std::memory_order_acquire) && !_cola->frente()) {
+                break;
+            }
+            _hayRegistros.esperar([this] { return _cola->tamano() > 0 || _detener.load(std::memory_order_acquire); },
+                                  kEsperaMaximaMs);
+            continue;
+        }
+
+        if (usado + kMaxLinea > kBytesPorLote) {
+            escribirDirecto(lote, usado);
+            usado = 0;
+            _escritos.fetch_add(pendientes, std::memory_order_release);
+            pendientes = 0;
+            _progreso.notificar();
+        }
+        usado += formatearLinea(*registro, lote + usado, kMaxLinea);
+        _cola->liberar();
+        _progreso.notificar();
+        ++pendientes;
+    }
+
+    delete[] lote;
+}
+
+std::size_t AuxiliarCli::formatearLinea(const RegistroLog& registro, char* destino, std::size_t tam)
+{
+    char cuerpo[kMaxLinea - 32];
+    cuerpo[0] = '\0';
+    registro.formatear(registro, cuerpo, sizeof(cuerpo));
+
+    int escritos = 0;
+    if (registro.color < 0) {
+        escritos = std::snprintf(destino, tam, "%s\n", cuerpo);
+    } else {
+        escritos = std::snprintf(destino, tam, "\033[%dm[%s] %s\n\033[0m", registro.color, registro.tipo, cuerpo);
+    }
+    if (escritos < 0) {
+        return 0;
+    }
+    return (static_cast<std::size_t>(escritos) < tam) ? static_cast<std::size_t>(escritos) : tam - 1;
+}
+
+void AuxiliarCli::escribirDirecto(const char* datos, std::size_t longitud)
+{
+    std::cout.write(datos, static_cast<std::streamsize>(longitud));
+    std::cout.flush();
+}
+
+void AuxiliarCli::clasificar(const char* tipo, NivelLog& nivel, int& color)
+{
+    if (!tipo) {
+        return;
+    }
+
+    switch (tipo[0]) {
+    case 'R':
+    case 'E':
+    case 'e':
+        if (std::strcmp(tipo, "RED") == 0 || std::strcmp(tipo, "ERROR") == 0 || std::strcmp(tipo, "error") == 0) {
+            nivel = NivelLog::Error;
+            color = 31;
+        }
+        break;
+    case 'G':
+    case 'S':
+    case 's':
+        if (std::strcmp(tipo, "GREEN") == 0 || std::strcmp(tipo, "SUCCESS") == 0 || std::strcmp(tipo, "success") == 0) {
+            nivel = NivelLog::Success;
+            color = 32;
+        } else if (std::strcmp(tipo, "STATUS") == 0 || std::strcmp(tipo, "status") == 0) {
+            nivel = NivelLog::Status;
+            color = 36;
+        }
+        break;
+    case 'Y':
+    case 'W':
+    case 'w':
+        if (std::strcmp(tipo, "YELLOW") == 0 || std::strcmp(tipo, "WARNING") == 0 || std::strcmp(tipo, "warning") == 0) {
+            nivel = NivelLog::Warning;
+            color = 33;
+        }
+        break;
+    case 'C':
+        if (std::strcmp(tipo, "CYAN") == 0) {
+            nivel = NivelLog::Status;
+            color = 36;
+        }
+        break;
+    default:
+        break;
+    }
+}
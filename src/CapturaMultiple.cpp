@@ -0,0 +1,310 @@
+#include "CapturaMultiple.h"
+
+#include "ArduinoParser.h"
+#include "AuxiliarCli.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+const int kEventosPorEspera = 32;
+const std::size_t kBloqueLectura = 4096;
+
+} // namespace
+
+CapturaMultiple::Dispositivo::Dispositivo() noexcept
+    : fd(-1)
+    , dispatcher(&carga, &rotor, nullptr)
+    , bytes(0)
+    , lecturas(0)
+    , conectado(false)
+{
+    ruta[0] = '\0';
+}
+
+CapturaMultiple::CapturaMultiple(AuxiliarCli* logger, std::size_t hilos) noexcept
+    : _logger(logger)
+    , _baud(115200)
+    , _totalHilos(hilos > 0 ? hilos : 1)
+    , _hilosActivos(0)
+    , _cantidad(0)
+    , _epolls(nullptr)
+    , _eventoParo(-1)
+    , _activa(false)
+{
+    for (std::size_t i = 0; i < kMaxDispositivos; ++i) {
+        _dispositivos[i] = nullptr;
+    }
+}
+
+CapturaMultiple::~CapturaMultiple()
+{
+    detener();
+    for (std::size_t i = 0; i < _cantidad; ++i) {
+        delete _dispositivos[i];
+        _dispositivos[i] = nullptr;
+    }
+    _cantidad = 0;
+}
+
+void CapturaMultiple::setBaudrate(unsigned baud) noexcept
+{
+    _baud = baud;
+}
+
+bool CapturaMultiple::agregarDispositivo(const char* ruta)
+{
+    if (!ruta || ruta[0] == '\0' || _cantidad == kMaxDispositivos || _activa) {
+        return false;
+    }
+
+    Dispositivo* nuevo = new Dispositivo;
+    std::size_t longitud = std::strlen(ruta);
+    if (longitud > kMaxRuta) {
+        longitud = kMaxRuta;
+    }
+    std::memcpy(nuevo->ruta, ruta, longitud);
+    nuevo->ruta[longitud] = '\0';
+    _dispositivos[_cantidad++] = nuevo;
+    return true;
+}
+
+std::size_t CapturaMultiple::totalDispositivos() const noexcept
+{
+    return _cantidad;
+}
+
+bool CapturaMultiple::iniciar()
+{
+    if (_activa || _cantidad == 0) {
+        return false;
+    }
+
+    const std::size_t hilos = (_totalHilos < _cantidad) ? _totalHilos : _cantidad;
+
+    _eventoParo = eventfd(0, EFD_NONBLOCK);
+    if (_eventoParo < 0) {
+        if (_logger) {
+            _logger->imprimirLog("ERROR", "No se pudo crear el evento de paro.");
+        }
+        return false;
+    }
+
+    _epolls = new int[hilos];
+    for (std::size_t h = 0; h < hilos; ++h) {
+        _epolls[h] = epoll_create1(0);
+        epoll_event evento {};
+        evento.events = EPOLLIN;
+        evento.data.ptr = nullptr;
+        if (_epolls[h] < 0 || epoll_ctl(_epolls[h], EPOLL_CTL_ADD, _eventoParo, &evento) != 0) {
+            if (_logger) {
+                _logger->imprimirLog("ERROR", "No se pudo preparar epoll.");
+            }
+            for (std::size_t k = h + 1; k < hilos; ++k) {
+                _epolls[k] = -1;
+            }
+            _hilosActivos = hilos;
+            cerrarDescriptores();
+            return false;
+        }
+    }
+
+    std::size_t abiertos = 0;
+    for (std::size_t i = 0; i < _cantidad; ++i) {
+        Dispositivo* d = _dispositivos[i];
+        d->bytes.store(0, std::memory_order_relaxed);
+        d->lecturas.store(0, std::memory_order_relaxed);
+        d->dispatcher.terminarSesion();
+        d->fd = ArduinoParser::abrirDispositivo(d->ruta, _baud, false, _logger);
+        if (d->fd < 0) {
+            if (_logger) {
+                char mensaje[300];
+                std::snprintf(mensaje, sizeof(mensaje), "Se omite %s.", d->ruta);
+                _logger->imprimirLog("WARNING", mensaje);
+            }
+            continue;
+        }
+
+        epoll_event evento {};
+        evento.events = EPOLLIN;
+        evento.data.ptr = d;
+        if (epoll_ctl(_epolls[i % hilos], EPOLL_CTL_ADD, d->fd, &evento) != 0) {
+            ::close(d->fd);
+            d->fd = -1;
+            continue;
+        }
+        d->conectado.store(true, std::memory_order_relaxed);
+        ++abiertos;
+    }
+
+    _hilosActivos = hilos;
+    if (abiertos == 0) {
+        if (_logger) {
+            _logger->imprimirLog("ERROR", "No se abrió ningún dispositivo.");
+        }
+        cerrarDescriptores();
+        return false;
+    }
+
+    for (std::size_t h = 0; h < hilos; ++h) {
+        _hilos[h] = std::thread(&CapturaMultiple::trabajar, this, h);
+    }
+    _activa = true;
+    return true;
+}
+
+void CapturaMultiple::detener()
+{
+    if (!_activa) {
+        return;
+    }
+
+    const std::uint64_t uno = 1;
+    const ssize_t escritos = ::write(_eventoParo, &uno, sizeof(uno));
+    (void)escritos;
+
+    for (std::size_t h = 0; h < _hilosActivos; ++h) {
+        if (_hilos[h].joinable()) {
+            _hilos[h].join();
+        }
+    }
+
+    cerrarDescriptores();
+    _activa = false;
+}
+
+bool CapturaMultiple::ejecutarHastaEnter()
+{
+    if (!iniciar()) {
+        return false;
+    }
+
+    if (_logger) {
+        char mensaje[160];
+        std::snprintf(mensaje, sizeof(mensaje), "Capturando %zu dispositivos con %zu hilos. ENTER detiene la captura.",
+                      _cantidad, _hilosActivos);
+        _logger->imprimirLog("STATUS", mensaje);
+    }
+
+    const std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+
+    char tecla = '\0';
+    while (tecla != '\n') {
+        const ssize_t leidos = ::read(STDIN_FILENO, &tecla, 1);
+        if (leidos == 0 || (leidos < 0 && errno != EINTR)) {
+            break;
+        }
+    }
+
+    detener();
+
+    const std::chrono::duration<double> duracion = std::chrono::steady_clock::now() - inicio;
+    imprimirReporte(duracion.count());
+    return true;
+}
+
+CapturaMultiple::Estadisticas CapturaMultiple::estadisticas(std::size_t indice) const noexcept
+{
+    Estadisticas resultado {0, 0, false};
+    if (indice >= _cantidad) {
+        return resultado;
+    }
+    const Dispositivo* d = _dispositivos[indice];
+    resultado.bytes = d->bytes.load(std::memory_order_relaxed);
+    resultado.lecturas = d->lecturas.load(std::memory_order_relaxed);
+    resultado.conectado = d->conectado.load(std::memory_order_relaxed);
+    return resultado;
+}
+
+void CapturaMultiple::imprimirReporte(double segundos) const
+{
+    if (!_logger) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < _cantidad; ++i) {
+        const Dispositivo* d = _dispositivos[i];
+        const Estadisticas e = estadisticas(i);
+        const double kbps = (segundos > 0.0) ? static_cast<double>(e.bytes) / 1024.0 / segundos : 0.0;
+
+        char mensaje[400];
+        std::snprintf(mensaje, sizeof(mensaje),
+                      "%s: %llu bytes en %llu lecturas (%.2f KiB/s), %zu tramas en la sesión%s",
+                      d->ruta, static_cast<unsigned long long>(e.bytes), static_cast<unsigned long long>(e.lecturas),
+                      kbps, d->dispatcher.totalProcesado(), e.conectado ? "." : ", desconectado.");
+        _logger->imprimirLog("STATUS", mensaje);
+        d->carga.imprimirMensaje(_logger);
+    }
+}
+
+void CapturaMultiple::trabajar(std::size_t hilo)
+{
+    epoll_event eventos[kEventosPorEspera];
+    char* buffer = new (std::nothrow) char[kBloqueLectura];
+    if (!buffer) {
+        return;
+    }
+
+    bool continuar = true;
+    while (continuar) {
+        const int listos = epoll_wait(_epolls[hilo], eventos, kEventosPorEspera, -1);
+        if (listos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < listos; ++i) {
+            Dispositivo* d = static_cast<Dispositivo*>(eventos[i].data.ptr);
+            if (!d) {
+                continuar = false;
+                break;
+            }
+
+            const ssize_t leidos = ::read(d->fd, buffer, kBloqueLectura);
+            if (leidos > 0) {
+                d->bytes.fetch_add(static_cast<std::uint64_t>(leidos), std::memory_order_relaxed);
+                d->lecturas.fetch_add(1, std::memory_order_relaxed);
+                d->dispatcher.onRawBytes(buffer, static_cast<std::size_t>(leidos));
+            } else if (leidos == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                epoll_ctl(_epolls[hilo], EPOLL_CTL_DEL, d->fd, nullptr);
+                d->conectado.store(false, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    delete[] buffer;
+}
+
+void CapturaMultiple::cerrarDescriptores() noexcept
+{
+    for (std::size_t i = 0; i < _cantidad; ++i) {
+        if (_dispositivos[i]->fd >= 0) {
+            ::close(_dispositivos[i]->fd);
+            _dispositivos[i]->fd = -1;
+        }
+    }
+
+    if (_epolls) {
+        for (std::size_t h = 0; h < _hilosActivos; ++h) {
+            if (_epolls[h] >= 0) {
+                ::close(_epolls[h]);
+            }
+        }
+        delete[] _epolls;
+        _epolls = nullptr;
+    }
+
+    if (_eventoParo >= 0) {
+        ::close(_eventoParo);
+        _eventoParo = -1;
+    }
+}
@@ -0,0 +1,210 @@
+#include "CodificadorBinario.h"
+
+#include "AnalizadorTramas.h"
+
+#include <cstring>
+
+CodificadorBinario::CodificadorBinario(char* destino, std::size_t capacidad) noexcept
+    : _destino(destino)
+    , _capacidad(destino ? capacidad : 0)
+    , _usados(0)
+    , _enBinario(false)
+    , _crcPorTrama(false)
+    , _lonCuerpo(0)
+    , _canal(-1)
+    , _canalBloque(-1)
+{
+}
+
+void CodificadorBinario::setCrcPorTrama(bool activo) noexcept
+{
+    _crcPorTrama = activo;
+}
+
+void CodificadorBinario::setCanal(int canal) noexcept
+{
+    _canal = (canal >= 0 && canal < AnalizadorTramas::kMaxCanales) ? canal : -1;
+}
+
+bool CodificadorBinario::agregarInicio() noexcept
+{
+    if (!hayEspacio()) {
+        return false;
+    }
+    if (!_enBinario) {
+        std::memcpy(_destino + _usados, ProtocoloBinario::kMarcador, ProtocoloBinario::kLongitudMarcador);
+        _usados += ProtocoloBinario::kLongitudMarcador;
+        _destino[_usados++] = '\n';
+        _enBinario = true;
+        // El marcador abre la sesión sin canal; la de un canal necesita además su Inicio.
+        if (_canal < 0) {
+            return true;
+        }
+    }
+    const unsigned char operacion = static_cast<unsigned char>(ProtocoloBinario::Operacion::Inicio);
+    agregarOperacion(&operacion, 1);
+    return true;
+}
+
+bool CodificadorBinario::agregarCarga(char caracter) noexcept
+{
+    if (!_enBinario || !hayEspacio()) {
+        return false;
+    }
+    const unsigned char operacion[2] = {static_cast<unsigned char>(ProtocoloBinario::Operacion::Carga),
+                                        static_cast<unsigned char>(caracter)};
+    agregarOperacion(operacion, sizeof(operacion));
+    return true;
+}
+
+bool CodificadorBinario::agregarMapa(int desplazamiento) noexcept
+{
+    if (!_enBinario || !hayEspacio()) {
+        return false;
+    }
+    unsigned char operacion[1 + ProtocoloBinario::kMaxVarint];
+    operacion[0] = static_cast<unsigned char>(ProtocoloBinario::Operacion::Mapa);
+    const std::size_t longitud = 1 + ProtocoloBinario::escribirVarint(ProtocoloBinario::aZigzag(desplazamiento), operacion + 1);
+    agregarOperacion(operacion, longitud);
+    return true;
+}
+
+bool CodificadorBinario::agregarLote(const char* datos, std::size_t cantidad) noexcept
+{
+    if (!_enBinario || !hayEspacio() || !datos || cantidad == 0 || cantidad > AnalizadorTramas::kMaxLote) {
+        return false;
+    }
+
+    // Operación Canal, operación Lote con su varint y la carga deben caber en un cuerpo.
+    const std::size_t kMaxTramo = ProtocoloBinario::kMaxCuerpo - 3 - 3;
+    unsigned char operacion[ProtocoloBinario::kMaxCuerpo];
+    while (cantidad > 0) {
+        const std::size_t tramo = (cantidad > kMaxTramo) ? kMaxTramo : cantidad;
+        operacion[0] = static_cast<unsigned char>(ProtocoloBinario::Operacion::Lote);
+        std::size_t longitud = 1 + ProtocoloBinario::escribirVarint(tramo, operacion + 1);
+        std::memcpy(operacion + longitud, datos, tramo);
+        longitud += tramo;
+        agregarOperacion(operacion, longitud);
+        datos += tramo;
+        cantidad -= tramo;
+    }
+    return true;
+}
+
+bool CodificadorBinario::agregarMarca(std::uint64_t nanosegundos) noexcept
+{
+    if (!_enBinario || !hayEspacio()) {
+        return false;
+    }
+    unsigned char operacion[1 + ProtocoloBinario::kMaxVarint];
+    operacion[0] = static_cast<unsigned char>(ProtocoloBinario::Operacion::Marca);
+    const std::size_t longitud = 1 + ProtocoloBinario::escribirVarint(nanosegundos, operacion + 1);
+    agregarOperacion(operacion, longitud);
+    return true;
+}
+
+bool CodificadorBinario::agregarFinMensaje() noexcept
+{
+    if (!_enBinario || !hayEspacio()) {
+        return false;
+    }
+    const unsigned char operacion = static_cast<unsigned char>(ProtocoloBinario::Operacion::FinMensaje);
+    agregarOperacion(&operacion, 1);
+    return true;
+}
+
+bool CodificadorBinario::agregar(const TramaDecodificada& trama) noexcept
+{
+    if (trama.error != ErrorTrama::Ninguno) {
+        return false;
+    }
+    setCanal(trama.canal);
+    switch (trama.tipo) {
+    case TipoTrama::Inicio:
+    case TipoTrama::InicioBinario:
+        return agregarInicio();
+    case TipoTrama::Carga:
+        return agregarCarga(trama.dato);
+    case TipoTrama::Mapa:
+        return agregarMapa(trama.desplazamiento);
+    case TipoTrama::Lote:
+        return agregarLote(trama.lote, trama.longitudLote);
+    case TipoTrama::Marca:
+        return agregarMarca(static_cast<std::uint64_t>(trama.marca));
+    case TipoTrama::FinMensaje:
+        return agregarFinMensaje();
+    case TipoTrama::Invalida:
+    default:
+        return false;
+    }
+}
+
+bool CodificadorBinario::agregarFin() noexcept
+{
+    if (!_enBinario || !hayEspacio()) {
+        return false;
+    }
+    const unsigned char operacion = static_cast<unsigned char>(ProtocoloBinario::Operacion::Fin);
+    agregarOperacion(&operacion, 1);
+    cerrarBloque();
+    _enBinario = false;
+    return true;
+}
+
+void CodificadorBinario::cerrarBloque() noexcept
+{
+    if (_lonCuerpo == 0) {
+        return;
+    }
+    const unsigned char longitud = static_cast<unsigned char>(_lonCuerpo);
+    std::uint16_t crc = ProtocoloBinario::crc16(&longitud, 1);
+    crc = ProtocoloBinario::crc16(_cuerpo, _lonCuerpo, crc);
+
+    char* escritura = _destino + _usados;
+    escritura[0] = static_cast<char>(ProtocoloBinario::kSincronia);
+    escritura[1] = static_cast<char>(longitud);
+    std::memcpy(escritura + 2, _cuerpo, _lonCuerpo);
+    escritura[2 + _lonCuerpo] = static_cast<char>(crc >> 8);
+    escritura[3 + _lonCuerpo] = static_cast<char>(crc & 0xFFu);
+    _usados += 4 + _lonCuerpo;
+    _lonCuerpo = 0;
+    _canalBloque = -1;
+}
+
+std::size_t CodificadorBinario::longitud() const noexcept
+{
+    return _usados;
+}
+
+void CodificadorBinario::descartarSalida() noexcept
+{
+    _usados = 0;
+}
+
+bool CodificadorBinario::hayEspacio() const noexcept
+{
+    return _capacidad >= _usados && _capacidad - _usados >= kReservaSalida;
+}
+
+void CodificadorBinario::agregarOperacion(const unsigned char* operacion, std::size_t longitud) noexcept
+{
+    unsigned char canal[1 + ProtocoloBinario::kMaxVarint];
+    canal[0] = static_cast<unsigned char>(ProtocoloBinario::Operacion::Canal);
+    const std::size_t lonCanal = 1 + ProtocoloBinario::escribirVarint(static_cast<std::uint64_t>(_canal + 1), canal + 1);
+
+    const std::size_t extra = (_canal != _canalBloque) ? lonCanal : 0;
+    if (_lonCuerpo + extra + longitud > ProtocoloBinario::kMaxCuerpo) {
+        cerrarBloque();
+    }
+    // Cada bloque empieza sin canal, así que tras cerrar puede hacer falta la operación Canal.
+    if (_canal != _canalBloque) {
+        std::memcpy(_cuerpo + _lonCuerpo, canal, lonCanal);
+        _lonCuerpo += lonCanal;
+        _canalBloque = _canal;
+    }
+    std::memcpy(_cuerpo + _lonCuerpo, operacion, longitud);
+    _lonCuerpo += longitud;
+    if (_crcPorTrama) {
+        cerrarBloque();
+    }
+}
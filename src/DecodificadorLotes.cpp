@@ -0,0 +1,144 @@
+#include "DecodificadorLotes.h"
+
+#include "AuxiliarCli.h"
+#include "RegistroContadores.h"
+#include "SalidaDescriptor.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+DecodificadorLotes::DecodificadorLotes(AuxiliarCli* logger) noexcept
+    : _logger(logger)
+    , _dispatcher(&_carga, &_rotor, nullptr)
+    , _contadores(nullptr)
+    , _bytes(0)
+{
+}
+
+void DecodificadorLotes::setContadores(RegistroContadores* contadores) noexcept
+{
+    _contadores = contadores;
+    _dispatcher.setContadores(contadores);
+}
+
+bool DecodificadorLotes::decodificarArchivo(const char* ruta, int salidaFd)
+{
+    if (!ruta || ruta[0] == '\0') {
+        error("Ruta de entrada vacía.");
+        return false;
+    }
+
+    if (std::strcmp(ruta, "-") == 0) {
+        return decodificarDescriptor(STDIN_FILENO, salidaFd);
+    }
+
+    const int fd = ::open(ruta, O_RDONLY);
+    if (fd < 0) {
+        error("No se pudo abrir el archivo de tramas.");
+        return false;
+    }
+    const bool exito = decodificarDescriptor(fd, salidaFd);
+    ::close(fd);
+    return exito;
+}
+
+bool DecodificadorLotes::decodificarDescriptor(int entradaFd, int salidaFd)
+{
+    SalidaDescriptor salida(salidaFd);
+    _dispatcher.terminarSesion();
+    _dispatcher.setSalida(&salida);
+    _bytes = 0;
+
+    struct stat info {};
+    bool exito = false;
+    if (fstat(entradaFd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        exito = leerProyectado(entradaFd, static_cast<std::size_t>(info.st_size));
+    } else {
+        exito = leerEnBloques(entradaFd);
+    }
+
+    // Una última línea sin '\n' también es una trama.
+    const char salto = '\n';
+    _dispatcher.onRawBytes(&salto, 1);
+    _dispatcher.terminarSesion();
+    _dispatcher.setSalida(nullptr);
+
+    if (!salida.vaciar()) {
+        error("No se pudo escribir la salida.");
+        return false;
+    }
+    return exito;
+}
+
+std::uint64_t DecodificadorLotes::bytesProcesados() const noexcept
+{
+    return _bytes;
+}
+
+bool DecodificadorLotes::leerProyectado(int entradaFd, std::size_t tamano)
+{
+    void* mapa = ::mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, entradaFd, 0);
+    if (mapa == MAP_FAILED) {
+        return leerEnBloques(entradaFd);
+    }
+    ::madvise(mapa, tamano, MADV_SEQUENTIAL);
+
+    _dispatcher.onRawBytes(static_cast<const char*>(mapa), tamano);
+    _bytes = tamano;
+    if (_contadores) {
+        _contadores->sumar(Contador::Lecturas);
+        _contadores->sumar(Contador::BytesLeidos, tamano);
+    }
+
+    ::munmap(mapa, tamano);
+    return true;
+}
+
+bool DecodificadorLotes::leerEnBloques(int entradaFd)
+{
+    char* bloque = new (std::nothrow) char[kBloqueLectura];
+    if (!bloque) {
+        error("No se pudo reservar el buffer de lectura.");
+        return false;
+    }
+
+    bool exito = true;
+    while (true) {
+        const ssize_t leidos = ::read(entradaFd, bloque, kBloqueLectura);
+        if (leidos > 0) {
+            _dispatcher.onRawBytes(bloque, static_cast<std::size_t>(leidos));
+            _bytes += static_cast<std::uint64_t>(leidos);
+            if (_contadores) {
+                _contadores->sumar(Contador::Lecturas);
+                _contadores->sumar(Contador::BytesLeidos, static_cast<std::uint64_t>(leidos));
+            }
+        } else if (leidos == 0) {
+            break;
+        } else if (errno != EINTR) {
+            if (_contadores) {
+                _contadores->sumar(Contador::ErroresLectura);
+            }
+            error("Fallo al leer la entrada.");
+            exito = false;
+            break;
+        }
+    }
+
+    delete[] bloque;
+    return exito;
+}
+
+void DecodificadorLotes::error(const char* mensaje) const
+{
+    if (_logger) {
+        _logger->imprimirLog("ERROR", mensaje);
+    } else {
+        std::fprintf(stderr, "[ERROR] %s\n", mensaje);
+    }
+}
@@ -0,0 +1,338 @@
+#include "DecodificadorParalelo.h"
+
+#include "AnalizadorTramas.h"
+#include "AuxiliarCli.h"
+#include "DecodificadorLotes.h"
+#include "LineaDispatcher.h"
+#include "ListaDeCarga.h"
+#include "RegistroContadores.h"
+#include "RotorDeMapeo.h"
+#include "SalidaMemoria.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const int kLetras = 26;
+
+bool escribirTodo(int fd, const char* datos, std::size_t longitud)
+{
+    while (longitud > 0) {
+        const ssize_t n = ::write(fd, datos, longitud);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        datos += n;
+        longitud -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Rango de líneas completas con su resumen, su estado de entrada y su decodificador.
+ */
+struct DecodificadorParalelo::Tramo {
+    const char* inicio = nullptr;
+    std::size_t longitud = 0;
+    bool ultimo = false;
+
+    // Resumen del paso 1.
+    bool hayInicio = false;
+    int suma = 0;
+    bool secuencial = false;
+    bool cambiaMensaje = false;  // hubo INICIO, FIN o carga
+    bool mensajeAbierto = false; // el último de ellos dejó un mensaje abierto
+
+    // Estado de entrada calculado por el barrido de prefijos.
+    bool activa = false;
+    int desplazamiento = 0;
+    bool mensajeEnCurso = false;
+
+    ListaDeCarga carga;
+    RotorDeMapeo rotor;
+    LineaDispatcher dispatcher;
+    RegistroContadores contadores;
+    SalidaMemoria salida;
+};
+
+DecodificadorParalelo::DecodificadorParalelo(std::size_t hilos, AuxiliarCli* logger) noexcept
+    : _logger(logger)
+    , _contadores(nullptr)
+    , _hilos(hilos)
+    , _tramos(0)
+{
+    if (_hilos == 0) {
+        _hilos = std::thread::hardware_concurrency();
+    }
+    if (_hilos == 0) {
+        _hilos = 1;
+    }
+    if (_hilos > kMaxHilos) {
+        _hilos = kMaxHilos;
+    }
+}
+
+void DecodificadorParalelo::setContadores(RegistroContadores* contadores) noexcept
+{
+    _contadores = contadores;
+}
+
+bool DecodificadorParalelo::decodificarArchivo(const char* ruta, int salidaFd)
+{
+    if (!ruta || ruta[0] == '\0') {
+        error("Ruta de entrada vacía.");
+        return false;
+    }
+
+    if (std::strcmp(ruta, "-") == 0) {
+        return decodificarDescriptor(STDIN_FILENO, salidaFd);
+    }
+
+    const int fd = ::open(ruta, O_RDONLY);
+    if (fd < 0) {
+        error("No se pudo abrir el archivo de tramas.");
+        return false;
+    }
+    const bool exito = decodificarDescriptor(fd, salidaFd);
+    ::close(fd);
+    return exito;
+}
+
+bool DecodificadorParalelo::decodificarDescriptor(int entradaFd, int salidaFd)
+{
+    struct stat info {};
+    void* mapa = MAP_FAILED;
+    std::size_t tamano = 0;
+    if (fstat(entradaFd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        tamano = static_cast<std::size_t>(info.st_size);
+        mapa = ::mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, entradaFd, 0);
+    }
+
+    if (mapa == MAP_FAILED) {
+        // Una tubería no se puede cortar en tramos sin leerla entera antes.
+        _tramos = 1;
+        DecodificadorLotes secuencial(_logger);
+        secuencial.setContadores(_contadores);
+        return secuencial.decodificarDescriptor(entradaFd, salidaFd);
+    }
+    ::madvise(mapa, tamano, MADV_WILLNEED);
+
+    if (_contadores) {
+        _contadores->sumar(Contador::Lecturas);
+        _contadores->sumar(Contador::BytesLeidos, tamano);
+    }
+    const bool exito = decodificarMemoria(static_cast<const char*>(mapa), tamano, salidaFd);
+    ::munmap(mapa, tamano);
+    return exito;
+}
+
+bool DecodificadorParalelo::decodificarMemoria(const char* datos, std::size_t longitud, int salidaFd)
+{
+    if (!datos) {
+        longitud = 0;
+    }
+    std::size_t cantidad = longitud / kMinTramo;
+    if (cantidad > _hilos) {
+        cantidad = _hilos;
+    }
+    if (cantidad == 0) {
+        cantidad = 1;
+    }
+
+    Tramo* tramos = new (std::nothrow) Tramo[cantidad];
+    if (!tramos) {
+        error("No se pudieron reservar los tramos de decodificación.");
+        return false;
+    }
+
+    // Cada corte avanza hasta el siguiente '\n' para que ningún tramo empiece a mitad de línea.
+    std::size_t desde = 0;
+    for (std::size_t i = 0; i < cantidad; ++i) {
+        std::size_t hasta = longitud;
+        if (i + 1 < cantidad) {
+            hasta = longitud / cantidad * (i + 1);
+            if (hasta < desde) {
+                hasta = desde;
+            }
+            const void* salto = std::memchr(datos + hasta, '\n', longitud - hasta);
+            hasta = salto ? static_cast<std::size_t>(static_cast<const char*>(salto) - datos) + 1 : longitud;
+        }
+        tramos[i].inicio = datos + desde;
+        tramos[i].longitud = hasta - desde;
+        tramos[i].ultimo = (i + 1 == cantidad);
+        desde = hasta;
+    }
+
+    if (cantidad > 1) {
+        ejecutar(&DecodificadorParalelo::resumir, tramos, cantidad);
+
+        bool secuencial = false;
+        for (std::size_t i = 0; i < cantidad; ++i) {
+            secuencial = secuencial || tramos[i].secuencial;
+        }
+        if (secuencial) {
+            delete[] tramos;
+            cantidad = 1;
+            tramos = new (std::nothrow) Tramo[1];
+            if (!tramos) {
+                error("No se pudieron reservar los tramos de decodificación.");
+                return false;
+            }
+            tramos[0].inicio = datos;
+            tramos[0].longitud = longitud;
+            tramos[0].ultimo = true;
+        }
+    }
+
+    // Barrido de prefijos: un INICIO reinicia la suma; sin sesión, los MAP no cuentan.
+    bool activa = false;
+    int desplazamiento = 0;
+    bool mensajeEnCurso = false;
+    for (std::size_t i = 0; i < cantidad; ++i) {
+        tramos[i].activa = activa;
+        tramos[i].desplazamiento = desplazamiento;
+        tramos[i].mensajeEnCurso = mensajeEnCurso;
+        if (tramos[i].cambiaMensaje) {
+            mensajeEnCurso = tramos[i].mensajeAbierto;
+        }
+        if (tramos[i].hayInicio) {
+            activa = true;
+            desplazamiento = tramos[i].suma;
+        } else if (activa) {
+            desplazamiento = (desplazamiento + tramos[i].suma) % kLetras;
+        }
+    }
+
+    ejecutar(&DecodificadorParalelo::decodificar, tramos, cantidad);
+
+    bool exito = true;
+    for (std::size_t i = 0; i < cantidad; ++i) {
+        const Tramo& tramo = tramos[i];
+        if (tramo.salida.huboError()) {
+            error("No se pudo reservar la salida de un tramo.");
+            exito = false;
+        }
+        if (exito && !escribirTodo(salidaFd, tramo.salida.datos(), tramo.salida.longitud())) {
+            error("No se pudo escribir la salida.");
+            exito = false;
+        }
+        if (_contadores) {
+            for (std::size_t c = 0; c < RegistroContadores::kContadores; ++c) {
+                const std::uint64_t valor = tramo.contadores.valor(static_cast<Contador>(c));
+                if (valor > 0) {
+                    _contadores->sumar(static_cast<Contador>(c), valor);
+                }
+            }
+        }
+    }
+
+    _tramos = cantidad;
+    delete[] tramos;
+    return exito;
+}
+
+std::size_t DecodificadorParalelo::tramosUsados() const noexcept
+{
+    return _tramos;
+}
+
+void DecodificadorParalelo::resumir(Tramo* tramo)
+{
+    AnalizadorTramas analizador;
+    TramaDecodificada trama;
+    const char* const fin = tramo->inicio + tramo->longitud;
+    for (const char* p = tramo->inicio; p <= fin; ++p) {
+        const bool completa = (p < fin) ? analizador.consumir(*p, trama) : tramo->ultimo && analizador.finalizar(trama);
+        if (!completa) {
+            continue;
+        }
+        if (trama.canal >= 0 || trama.error == ErrorTrama::CanalInvalido || trama.tipo == TipoTrama::InicioBinario) {
+            tramo->secuencial = true;
+            return;
+        }
+        // Mismo orden que LineaDispatcher::aplicarTrama: INICIO gana a cualquier error.
+        if (trama.tipo == TipoTrama::Inicio) {
+            tramo->hayInicio = true;
+            tramo->suma = 0;
+            tramo->cambiaMensaje = true;
+            tramo->mensajeAbierto = true;
+        } else if (trama.error != ErrorTrama::Ninguno) {
+            continue;
+        } else if (trama.tipo == TipoTrama::Mapa) {
+            tramo->suma = (tramo->suma + trama.desplazamiento % kLetras + kLetras) % kLetras;
+        } else if (trama.tipo == TipoTrama::Carga || trama.tipo == TipoTrama::Lote || trama.tipo == TipoTrama::FinMensaje) {
+            tramo->cambiaMensaje = true;
+            tramo->mensajeAbierto = trama.tipo != TipoTrama::FinMensaje;
+        }
+    }
+}
+
+void DecodificadorParalelo::decodificar(Tramo* tramo)
+{
+    LineaDispatcher& dispatcher = tramo->dispatcher;
+    dispatcher.setComponentes(&tramo->carga, &tramo->rotor);
+
+    if (tramo->activa) {
+        // Continúa la sesión del tramo anterior; se prepara antes de conectar contadores y salida
+        // para no contarla dos veces ni volver a escribir lo ya decodificado de ella.
+        dispatcher.iniciarSesion(nullptr, true);
+        tramo->rotor.rotar(tramo->desplazamiento);
+        if (!tramo->mensajeEnCurso) {
+            const char fin[] = "FIN\n";
+            dispatcher.onRawBytes(fin, sizeof(fin) - 1);
+        }
+    }
+    dispatcher.setContadores(&tramo->contadores);
+    dispatcher.setSalida(&tramo->salida);
+    dispatcher.onRawBytes(tramo->inicio, tramo->longitud);
+
+    if (tramo->ultimo) {
+        const char salto = '\n';
+        dispatcher.onRawBytes(&salto, 1);
+        dispatcher.terminarSesion();
+    }
+    dispatcher.setSalida(nullptr);
+}
+
+void DecodificadorParalelo::ejecutar(void (*tarea)(Tramo*), Tramo* tramos, std::size_t cantidad)
+{
+    std::thread* hilos = (cantidad > 1) ? new (std::nothrow) std::thread[cantidad - 1] : nullptr;
+    std::size_t lanzados = 0;
+    if (hilos) {
+        for (; lanzados < cantidad - 1; ++lanzados) {
+            hilos[lanzados] = std::thread(tarea, &tramos[lanzados + 1]);
+        }
+    }
+
+    // El hilo llamador toma el primer tramo y los que no se pudieron lanzar.
+    tarea(&tramos[0]);
+    for (std::size_t i = lanzados + 1; i < cantidad; ++i) {
+        tarea(&tramos[i]);
+    }
+    for (std::size_t i = 0; i < lanzados; ++i) {
+        hilos[i].join();
+    }
+    delete[] hilos;
+}
+
+void DecodificadorParalelo::error(const char* mensaje) const
+{
+    if (_logger) {
+        _logger->imprimirLog("ERROR", mensaje);
+    } else {
+        std::fprintf(stderr, "[ERROR] %s\n", mensaje);
+    }
+}
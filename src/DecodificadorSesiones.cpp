@@ -0,0 +1,320 @@
+#include "DecodificadorSesiones.h"
+
+#include "ArduinoParser.h"
+#include "AuxiliarCli.h"
+#include "LineaDispatcher.h"
+#include "ListaDeCarga.h"
+#include "RegistroContadores.h"
+#include "RotorDeMapeo.h"
+#include "SalidaDescriptor.h"
+#include "SalidaMemoria.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @brief Estado de decodificación de un hilo; se reutiliza de una sesión a la siguiente.
+ */
+struct DecodificadorSesiones::Trabajador {
+    ListaDeCarga carga;
+    RotorDeMapeo rotor;
+    LineaDispatcher dispatcher;
+    ArduinoParser parser;
+    RegistroContadores contadores;
+    bool captura;
+
+    Trabajador() noexcept
+        : dispatcher(&carga, &rotor, nullptr)
+        , parser(nullptr, &dispatcher)
+        , captura(false)
+    {
+        parser.setContadores(&contadores);
+        dispatcher.setContadores(&contadores);
+    }
+
+    static void entregar(void* contexto, const char* datos, std::size_t longitud)
+    {
+        Trabajador* trabajador = static_cast<Trabajador*>(contexto);
+        if (trabajador->captura) {
+            trabajador->parser.alimentar(datos, longitud);
+        } else {
+            trabajador->dispatcher.onRawBytes(datos, longitud);
+        }
+    }
+};
+
+/**
+ * @brief Salida de una sesión decodificada a la espera de escribirse en orden.
+ */
+struct DecodificadorSesiones::Ranura {
+    SalidaMemoria salida;
+    std::atomic<bool> lista {false};
+    bool exito = true;
+};
+
+DecodificadorSesiones::DecodificadorSesiones(std::size_t hilos, AuxiliarCli* logger) noexcept
+    : _logger(logger)
+    , _contadores(nullptr)
+    , _hilos(hilos)
+    , _fuente(nullptr)
+    , _tamano(0)
+    , _reutilizado(false)
+    , _ranuras(nullptr)
+    , _regiones(0)
+    , _siguiente(0)
+    , _escritas(0)
+{
+    if (_hilos == 0) {
+        _hilos = std::thread::hardware_concurrency();
+    }
+    if (_hilos == 0) {
+        _hilos = 1;
+    }
+}
+
+DecodificadorSesiones::~DecodificadorSesiones()
+{
+    cerrar();
+}
+
+void DecodificadorSesiones::setContadores(RegistroContadores* contadores) noexcept
+{
+    _contadores = contadores;
+}
+
+bool DecodificadorSesiones::abrir(const char* ruta, bool reconstruir)
+{
+    cerrar();
+    const int fd = ruta ? ::open(ruta, O_RDONLY) : -1;
+    if (fd < 0) {
+        error("No se pudo abrir el archivo de tramas.");
+        return false;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        error("Solo se pueden indexar archivos regulares.");
+        return false;
+    }
+    _tamano = static_cast<std::size_t>(info.st_size);
+    if (_tamano > 0) {
+        void* mapa = ::mmap(nullptr, _tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa == MAP_FAILED) {
+            ::close(fd);
+            _tamano = 0;
+            error("No se pudo proyectar el archivo en memoria.");
+            return false;
+        }
+        _fuente = static_cast<const char*>(mapa);
+    }
+    ::close(fd);
+
+    char rutaIndice[4096];
+    const bool hayRuta = IndiceSesiones::rutaIndice(ruta, rutaIndice, sizeof(rutaIndice));
+    _reutilizado = hayRuta && !reconstruir && _indice.cargar(rutaIndice, _tamano);
+    if (_reutilizado) {
+        return true;
+    }
+
+    if (_fuente) {
+        ::madvise(const_cast<char*>(_fuente), _tamano, MADV_SEQUENTIAL);
+    }
+    if (!_indice.construir(_fuente, _tamano)) {
+        error("La captura está truncada o dañada; no se pudo indexar.");
+        cerrar();
+        return false;
+    }
+    // Sin permiso de escritura junto a la fuente el índice solo vive en memoria.
+    if (hayRuta) {
+        _indice.guardar(rutaIndice);
+    }
+    return true;
+}
+
+void DecodificadorSesiones::cerrar() noexcept
+{
+    if (_fuente) {
+        ::munmap(const_cast<char*>(_fuente), _tamano);
+    }
+    _fuente = nullptr;
+    _tamano = 0;
+    _reutilizado = false;
+}
+
+const IndiceSesiones& DecodificadorSesiones::indice() const noexcept
+{
+    return _indice;
+}
+
+bool DecodificadorSesiones::indiceReutilizado() const noexcept
+{
+    return _reutilizado;
+}
+
+bool DecodificadorSesiones::decodificarSesion(std::size_t n, int salidaFd)
+{
+    if (n >= _indice.sesiones()) {
+        error("La sesión pedida no existe en el índice.");
+        return false;
+    }
+    if (!_indice.independientes()) {
+        error("La fuente usa canales o el modo binario; sus sesiones no se pueden decodificar por separado.");
+        return false;
+    }
+
+    SalidaDescriptor salida(salidaFd);
+    Trabajador trabajador;
+    trabajador.captura = _indice.formato() == FormatoFuente::Captura;
+    const bool decodificada = decodificarRegion(n + 1, trabajador, salida);
+    sumarContadores(trabajador);
+    if (!salida.vaciar()) {
+        error("No se pudo escribir la salida.");
+        return false;
+    }
+    return decodificada;
+}
+
+bool DecodificadorSesiones::decodificarTodas(int salidaFd)
+{
+    SalidaDescriptor salida(salidaFd);
+    const bool captura = _indice.formato() == FormatoFuente::Captura;
+
+    if (!_indice.independientes() || _hilos == 1 || _indice.sesiones() == 0) {
+        Trabajador trabajador;
+        trabajador.captura = captura;
+        const bool decodificada = decodificarRango(_indice.inicioDatos(), nullptr, trabajador, salida);
+        sumarContadores(trabajador);
+        if (!salida.vaciar()) {
+            error("No se pudo escribir la salida.");
+            return false;
+        }
+        return decodificada;
+    }
+
+    // Región 0: lo anterior al primer INICIO (sin salida, pero cuenta tramas); región k: la sesión k - 1.
+    _regiones = _indice.sesiones() + 1;
+    // Más hilos que sesiones solo esperarían sin trabajo.
+    const std::size_t totalHilos = (_hilos < _indice.sesiones()) ? _hilos : _indice.sesiones();
+    _ranuras = new (std::nothrow) Ranura[kVentana];
+    Trabajador* trabajadores = new (std::nothrow) Trabajador[totalHilos];
+    std::thread* hilos = new (std::nothrow) std::thread[totalHilos];
+    if (!_ranuras || !trabajadores || !hilos) {
+        delete[] _ranuras;
+        _ranuras = nullptr;
+        delete[] trabajadores;
+        delete[] hilos;
+        error("No se pudo reservar el grupo de hilos.");
+        return false;
+    }
+    _siguiente.store(0, std::memory_order_relaxed);
+    _escritas.store(0, std::memory_order_relaxed);
+    for (std::size_t h = 0; h < totalHilos; ++h) {
+        trabajadores[h].captura = captura;
+        hilos[h] = std::thread(&DecodificadorSesiones::trabajar, this, &trabajadores[h]);
+    }
+
+    bool exito = true;
+    for (std::size_t region = 0; region < _regiones; ++region) {
+        Ranura& ranura = _ranuras[region % kVentana];
+        while (!ranura.lista.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        if (ranura.salida.huboError()) {
+            error("No se pudo reservar la salida de una sesión.");
+            exito = false;
+        }
+        exito = ranura.exito && exito;
+        if (ranura.salida.longitud() > 0) {
+            salida.escribirFragmento(ranura.salida.datos(), ranura.salida.longitud());
+        }
+        ranura.lista.store(false, std::memory_order_relaxed);
+        _escritas.store(region + 1, std::memory_order_release);
+    }
+
+    for (std::size_t h = 0; h < totalHilos; ++h) {
+        hilos[h].join();
+        sumarContadores(trabajadores[h]);
+    }
+    delete[] trabajadores;
+    delete[] hilos;
+    delete[] _ranuras;
+    _ranuras = nullptr;
+
+    if (!salida.vaciar()) {
+        error("No se pudo escribir la salida.");
+        return false;
+    }
+    if (!exito) {
+        error("La captura está truncada o dañada.");
+    }
+    return exito;
+}
+
+void DecodificadorSesiones::trabajar(Trabajador* trabajador)
+{
+    while (true) {
+        const std::size_t region = _siguiente.fetch_add(1, std::memory_order_relaxed);
+        if (region >= _regiones) {
+            return;
+        }
+        // No adelantarse más de kVentana sesiones a la escritura: la ranura aún estaría ocupada.
+        while (region >= _escritas.load(std::memory_order_acquire) + kVentana) {
+            std::this_thread::yield();
+        }
+        Ranura& ranura = _ranuras[region % kVentana];
+        ranura.salida.reiniciar();
+        ranura.exito = decodificarRegion(region, *trabajador, ranura.salida);
+        ranura.lista.store(true, std::memory_order_release);
+    }
+}
+
+bool DecodificadorSesiones::decodificarRegion(std::size_t region, Trabajador& trabajador, SalidaMensaje& salida) const
+{
+    const PosicionFuente desde = (region == 0) ? _indice.inicioDatos() : _indice.sesion(region - 1).posicion;
+    const PosicionFuente* hasta = (region < _indice.sesiones()) ? &_indice.sesion(region).posicion : nullptr;
+    return decodificarRango(desde, hasta, trabajador, salida);
+}
+
+bool DecodificadorSesiones::decodificarRango(const PosicionFuente& desde, const PosicionFuente* hasta,
+                                             Trabajador& trabajador, SalidaMensaje& salida) const
+{
+    LineaDispatcher& dispatcher = trabajador.dispatcher;
+    dispatcher.setSalida(&salida);
+    const bool recorrido = _indice.recorrer(_fuente, _tamano, desde, hasta, &Trabajador::entregar, &trabajador);
+    if (!hasta && !trabajador.captura) {
+        // Como en DecodificadorLotes, una última línea sin '\n' también es una trama.
+        const char salto = '\n';
+        dispatcher.onRawBytes(&salto, 1);
+    }
+    dispatcher.terminarSesion();
+    dispatcher.setSalida(nullptr);
+    return recorrido;
+}
+
+void DecodificadorSesiones::sumarContadores(const Trabajador& trabajador) const
+{
+    if (!_contadores) {
+        return;
+    }
+    for (std::size_t c = 0; c < RegistroContadores::kContadores; ++c) {
+        const std::uint64_t valor = trabajador.contadores.valor(static_cast<Contador>(c));
+        if (valor > 0) {
+            _contadores->sumar(static_cast<Contador>(c), valor);
+        }
+    }
+}
+
+void DecodificadorSesiones::error(const char* mensaje) const
+{
+    if (_logger) {
+        _logger->imprimirLog("ERROR", mensaje);
+    } else {
+        std::fprintf(stderr, "[ERROR] %s\n", mensaje);
+    }
+}
@@ -0,0 +1,118 @@
+#include "DestinoMensajes.h"
+
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const char kPrefijoUnix[] = "unix:";
+const char kPrefijoTcp[] = "tcp:";
+
+bool empiezaCon(const char* texto, const char* prefijo) noexcept
+{
+    return std::strncmp(texto, prefijo, std::strlen(prefijo)) == 0;
+}
+
+int conectarUnix(const char* ruta) noexcept
+{
+    sockaddr_un direccion {};
+    direccion.sun_family = AF_UNIX;
+    const std::size_t longitud = std::strlen(ruta);
+    if (longitud == 0 || longitud >= sizeof(direccion.sun_path)) {
+        return -1;
+    }
+    std::memcpy(direccion.sun_path, ruta, longitud + 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&direccion), sizeof(direccion)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int conectarTcp(const char* destino) noexcept
+{
+    // El último ':' separa el puerto, así "tcp:::1:9000" también funciona con IPv6.
+    const char* separador = std::strrchr(destino, ':');
+    if (!separador || separador == destino || separador[1] == '\0') {
+        return -1;
+    }
+    char host[256];
+    const std::size_t longitudHost = static_cast<std::size_t>(separador - destino);
+    if (longitudHost >= sizeof(host)) {
+        return -1;
+    }
+    std::memcpy(host, destino, longitudHost);
+    host[longitudHost] = '\0';
+
+    addrinfo pista {};
+    pista.ai_family = AF_UNSPEC;
+    pista.ai_socktype = SOCK_STREAM;
+    addrinfo* direcciones = nullptr;
+    if (::getaddrinfo(host, separador + 1, &pista, &direcciones) != 0) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (const addrinfo* d = direcciones; d && fd < 0; d = d->ai_next) {
+        fd = ::socket(d->ai_family, d->ai_socktype | SOCK_CLOEXEC, d->ai_protocol);
+        if (fd >= 0 && ::connect(fd, d->ai_addr, d->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(direcciones);
+    return fd;
+}
+
+} // namespace
+
+namespace DestinoMensajes {
+
+TipoDestino clasificar(const char* especificacion) noexcept
+{
+    if (!especificacion) {
+        return TipoDestino::Archivo;
+    }
+    if (empiezaCon(especificacion, kPrefijoUnix)) {
+        return TipoDestino::SocketUnix;
+    }
+    if (empiezaCon(especificacion, kPrefijoTcp)) {
+        return TipoDestino::SocketTcp;
+    }
+    return TipoDestino::Archivo;
+}
+
+int abrir(const char* especificacion) noexcept
+{
+    if (!especificacion || especificacion[0] == '\0') {
+        return -1;
+    }
+
+    int fd = -1;
+    switch (clasificar(especificacion)) {
+    case TipoDestino::Archivo:
+        return ::open(especificacion, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    case TipoDestino::SocketUnix:
+        fd = conectarUnix(especificacion + sizeof(kPrefijoUnix) - 1);
+        break;
+    case TipoDestino::SocketTcp:
+        fd = conectarTcp(especificacion + sizeof(kPrefijoTcp) - 1);
+        break;
+    }
+    if (fd >= 0) {
+        std::signal(SIGPIPE, SIG_IGN);
+    }
+    return fd;
+}
+
+} // namespace DestinoMensajes
@@ -0,0 +1,32 @@
+#include "EventoEspera.h"
+
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "El futex necesita una palabra de 32 bits.");
+
+EventoEspera::EventoEspera() noexcept
+    : _secuencia(0)
+    , _esperando(0)
+{
+}
+
+void EventoEspera::dormir(std::uint32_t secuencia, int maxMs) noexcept
+{
+    timespec espera {};
+    espera.tv_sec = maxMs / 1000;
+    espera.tv_nsec = static_cast<long>(maxMs % 1000) * 1000000L;
+    // Si otro hilo ya avanzó la secuencia, el kernel regresa de inmediato (EAGAIN).
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&_secuencia), FUTEX_WAIT_PRIVATE, secuencia,
+              maxMs < 0 ? nullptr : &espera, nullptr, 0);
+}
+
+void EventoEspera::despertar() noexcept
+{
+    _secuencia.fetch_add(1, std::memory_order_release);
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&_secuencia), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr,
+              nullptr, 0);
+}
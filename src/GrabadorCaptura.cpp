@@ -0,0 +1,260 @@
+#include "GrabadorCaptura.h"
+
+#include "ProtocoloBinario.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::uint64_t microsegundosMonotonicos() noexcept
+{
+    timespec ahora {};
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return static_cast<std::uint64_t>(ahora.tv_sec) * 1000000u + static_cast<std::uint64_t>(ahora.tv_nsec) / 1000u;
+}
+
+} // namespace
+
+bool FormatoCaptura::leerRegistro(const unsigned char* fuente, std::size_t tamano, std::size_t& pos,
+                                  Registro& registro) noexcept
+{
+    if (pos >= tamano) {
+        return false;
+    }
+    const unsigned char tipo = fuente[pos];
+    if (tipo != kSegmento && tipo != kDatos) {
+        return false;
+    }
+    std::size_t cursor = pos + 1;
+    std::uint64_t valor = 0;
+    std::size_t usados = ProtocoloBinario::leerVarint(fuente + cursor, tamano - cursor, valor);
+    if (usados == 0) {
+        return false;
+    }
+    cursor += usados;
+
+    registro.tipo = tipo;
+    registro.valor = valor;
+    if (tipo == kSegmento) {
+        registro.datos = cursor;
+        registro.longitud = 0;
+        pos = cursor;
+        return true;
+    }
+    usados = ProtocoloBinario::leerVarint(fuente + cursor, tamano - cursor, valor);
+    if (usados == 0 || valor > tamano - cursor - usados) {
+        return false;
+    }
+    registro.datos = cursor + usados;
+    registro.longitud = static_cast<std::size_t>(valor);
+    pos = registro.datos + registro.longitud;
+    return true;
+}
+
+GrabadorCaptura::GrabadorCaptura() noexcept
+    : _fd(-1)
+    , _buffer(nullptr)
+    , _usados(0)
+    , _ultimoUs(0)
+    , _ultimoVaciadoUs(0)
+    , _bytes(0)
+    , _descartados(0)
+    , _error(false)
+{
+}
+
+GrabadorCaptura::~GrabadorCaptura()
+{
+    cerrar();
+}
+
+bool GrabadorCaptura::abrir(const char* ruta, unsigned baud)
+{
+    cerrar();
+    if (!ruta || ruta[0] == '\0') {
+        return false;
+    }
+
+    if (!_buffer) {
+        _buffer = new (std::nothrow) char[kCapacidad];
+        if (!_buffer) {
+            return false;
+        }
+    }
+
+    _fd = ::open(ruta, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        return false;
+    }
+
+    struct stat info {};
+    if (fstat(_fd, &info) != 0) {
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    // Solo se agrega a una captura existente: cualquier otro archivo quedaría mezclado con registros binarios.
+    if (info.st_size > 0) {
+        char firma[sizeof(FormatoCaptura::kFirma)];
+        if (!S_ISREG(info.st_mode) || ::pread(_fd, firma, sizeof(firma), 0) != static_cast<ssize_t>(sizeof(firma))
+            || std::memcmp(firma, FormatoCaptura::kFirma, sizeof(firma)) != 0) {
+            ::close(_fd);
+            _fd = -1;
+            return false;
+        }
+    }
+
+    _descartados = 0;
+    if (info.st_size > 0 && !truncarIncompleto(static_cast<std::size_t>(info.st_size))) {
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    _usados = 0;
+    _bytes = 0;
+    _error = false;
+    if (info.st_size == 0) {
+        agregar(FormatoCaptura::kFirma, sizeof(FormatoCaptura::kFirma));
+    }
+    agregar(&FormatoCaptura::kSegmento, 1);
+    agregarVarint(baud);
+    _ultimoUs = microsegundosMonotonicos();
+    _ultimoVaciadoUs = _ultimoUs;
+    return true;
+}
+
+bool GrabadorCaptura::cerrar() noexcept
+{
+    if (_fd < 0) {
+        delete[] _buffer;
+        _buffer = nullptr;
+        return !_error;
+    }
+
+    vaciar();
+    ::close(_fd);
+    _fd = -1;
+    delete[] _buffer;
+    _buffer = nullptr;
+    return !_error;
+}
+
+bool GrabadorCaptura::activo() const noexcept
+{
+    return _fd >= 0;
+}
+
+void GrabadorCaptura::registrar(const char* datos, std::size_t longitud) noexcept
+{
+    if (_fd < 0 || !datos || longitud == 0) {
+        return;
+    }
+
+    const std::uint64_t ahora = microsegundosMonotonicos();
+    agregar(&FormatoCaptura::kDatos, 1);
+    agregarVarint(ahora - _ultimoUs);
+    agregarVarint(longitud);
+    agregar(datos, longitud);
+    _ultimoUs = ahora;
+    _bytes += longitud;
+    if (ahora - _ultimoVaciadoUs >= static_cast<std::uint64_t>(kIntervaloVaciadoMs) * 1000u) {
+        vaciar();
+    }
+}
+
+void GrabadorCaptura::vaciarSiVencido() noexcept
+{
+    if (_fd < 0 || _usados == 0) {
+        return;
+    }
+    if (microsegundosMonotonicos() - _ultimoVaciadoUs >= static_cast<std::uint64_t>(kIntervaloVaciadoMs) * 1000u) {
+        vaciar();
+    }
+}
+
+std::uint64_t GrabadorCaptura::bytesGrabados() const noexcept
+{
+    return _bytes;
+}
+
+std::uint64_t GrabadorCaptura::bytesDescartados() const noexcept
+{
+    return _descartados;
+}
+
+void GrabadorCaptura::agregar(const void* datos, std::size_t longitud) noexcept
+{
+    const char* origen = static_cast<const char*>(datos);
+    while (longitud > 0) {
+        if (_usados == kCapacidad && !vaciar()) {
+            return;
+        }
+        std::size_t copia = kCapacidad - _usados;
+        if (copia > longitud) {
+            copia = longitud;
+        }
+        std::memcpy(_buffer + _usados, origen, copia);
+        _usados += copia;
+        origen += copia;
+        longitud -= copia;
+    }
+}
+
+void GrabadorCaptura::agregarVarint(std::uint64_t valor) noexcept
+{
+    unsigned char codificado[ProtocoloBinario::kMaxVarint];
+    agregar(codificado, ProtocoloBinario::escribirVarint(valor, codificado));
+}
+
+bool GrabadorCaptura::vaciar() noexcept
+{
+    std::size_t enviados = 0;
+    while (enviados < _usados) {
+        const ssize_t escritos = ::write(_fd, _buffer + enviados, _usados - enviados);
+        if (escritos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _error = true;
+            break;
+        }
+        enviados += static_cast<std::size_t>(escritos);
+    }
+    _usados = 0;
+    _ultimoVaciadoUs = microsegundosMonotonicos();
+    return !_error;
+}
+
+bool GrabadorCaptura::truncarIncompleto(std::size_t tamano) noexcept
+{
+    void* mapa = ::mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if (mapa == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(mapa, tamano, MADV_SEQUENTIAL);
+
+    const unsigned char* const bytes = static_cast<const unsigned char*>(mapa);
+    std::size_t pos = sizeof(FormatoCaptura::kFirma);
+    FormatoCaptura::Registro registro {};
+    while (FormatoCaptura::leerRegistro(bytes, tamano, pos, registro)) {
+    }
+    ::munmap(mapa, tamano);
+
+    // Lo que sigue al último registro completo es la cola de una escritura cortada.
+    if (pos < tamano) {
+        if (::ftruncate(_fd, static_cast<off_t>(pos)) != 0) {
+            return false;
+        }
+        _descartados = tamano - pos;
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+#include "HistogramaLatencia.h"
+
+#include <cstring>
+
+HistogramaLatencia::HistogramaLatencia() noexcept
+{
+    reiniciar();
+}
+
+void HistogramaLatencia::reiniciar() noexcept
+{
+    std::memset(_cuentas, 0, sizeof(_cuentas));
+    _cantidad = 0;
+    _suma = 0;
+    _minimo = UINT64_MAX;
+    _maximo = 0;
+}
+
+void HistogramaLatencia::registrar(std::uint64_t valor) noexcept
+{
+    ++_cuentas[indice(valor)];
+    ++_cantidad;
+    _suma += valor;
+    if (valor < _minimo) {
+        _minimo = valor;
+    }
+    if (valor > _maximo) {
+        _maximo = valor;
+    }
+}
+
+void HistogramaLatencia::combinar(const HistogramaLatencia& otro) noexcept
+{
+    for (std::size_t i = 0; i < kCubetas; ++i) {
+        _cuentas[i] += otro._cuentas[i];
+    }
+    _cantidad += otro._cantidad;
+    _suma += otro._suma;
+    if (otro._minimo < _minimo) {
+        _minimo = otro._minimo;
+    }
+    if (otro._maximo > _maximo) {
+        _maximo = otro._maximo;
+    }
+}
+
+std::uint64_t HistogramaLatencia::percentil(double fraccion) const noexcept
+{
+    if (_cantidad == 0) {
+        return 0;
+    }
+    if (fraccion <= 0.0) {
+        return _minimo;
+    }
+
+    std::uint64_t objetivo = static_cast<std::uint64_t>(fraccion * static_cast<double>(_cantidad) + 0.999999);
+    if (objetivo == 0) {
+        objetivo = 1;
+    }
+    if (objetivo >= _cantidad) {
+        return _maximo;
+    }
+
+    std::uint64_t acumulado = 0;
+    for (std::size_t i = 0; i < kCubetas; ++i) {
+        acumulado += _cuentas[i];
+        if (acumulado >= objetivo) {
+            const std::uint64_t cota = cotaSuperior(i);
+            return (cota < _maximo) ? cota : _maximo;
+        }
+    }
+    return _maximo;
+}
+
+std::uint64_t HistogramaLatencia::cantidad() const noexcept
+{
+    return _cantidad;
+}
+
+std::uint64_t HistogramaLatencia::minimo() const noexcept
+{
+    return _cantidad ? _minimo : 0;
+}
+
+std::uint64_t HistogramaLatencia::maximo() const noexcept
+{
+    return _maximo;
+}
+
+double HistogramaLatencia::promedio() const noexcept
+{
+    return _cantidad ? static_cast<double>(_suma) / static_cast<double>(_cantidad) : 0.0;
+}
+
+std::size_t HistogramaLatencia::indice(std::uint64_t valor) noexcept
+{
+    if (valor < kSubcubetas) {
+        return static_cast<std::size_t>(valor);
+    }
+    const unsigned magnitud = 63u - static_cast<unsigned>(__builtin_clzll(valor));
+    const unsigned sub = static_cast<unsigned>(valor >> (magnitud - kBitsSubcubeta)) & (kSubcubetas - 1);
+    return (magnitud - kBitsSubcubeta + 1) * kSubcubetas + sub;
+}
+
+std::uint64_t HistogramaLatencia::cotaSuperior(std::size_t indice) noexcept
+{
+    if (indice < kSubcubetas) {
+        return indice;
+    }
+    const unsigned magnitud = static_cast<unsigned>(indice / kSubcubetas) + kBitsSubcubeta - 1;
+    const std::uint64_t sub = indice % kSubcubetas;
+    const unsigned paso = magnitud - kBitsSubcubeta;
+    const std::uint64_t base = (std::uint64_t {1} << magnitud) | (sub << paso);
+    return base + ((std::uint64_t {1} << paso) - 1);
+}
@@ -0,0 +1,330 @@
+#include "IndiceSesiones.h"
+
+#include "AnalizadorTramas.h"
+#include "GrabadorCaptura.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool esCaptura(const char* fuente, std::size_t tamano) noexcept
+{
+    return tamano >= sizeof(FormatoCaptura::kFirma)
+        && std::memcmp(fuente, FormatoCaptura::kFirma, sizeof(FormatoCaptura::kFirma)) == 0;
+}
+
+void escribirU64(unsigned char* destino, std::uint64_t valor) noexcept
+{
+    for (int i = 0; i < 8; ++i) {
+        destino[i] = static_cast<unsigned char>(valor >> (8 * i));
+    }
+}
+
+std::uint64_t leerU64(const unsigned char* origen) noexcept
+{
+    std::uint64_t valor = 0;
+    for (int i = 7; i >= 0; --i) {
+        valor = (valor << 8) | origen[i];
+    }
+    return valor;
+}
+
+/**
+ * @brief Sigue la línea en curso mientras se recorre el flujo y anota los INICIO.
+ */
+struct Escaneo {
+    AnalizadorTramas analizador;
+    TramaDecodificada trama;
+    EntradaSesion linea {};
+    std::uint64_t instanteUs = 0;
+    std::uint32_t segmento = 0;
+    bool lineaNueva = true;
+    bool detenido = false;
+};
+
+} // namespace
+
+IndiceSesiones::IndiceSesiones() noexcept
+    : _entradas(nullptr)
+    , _cantidad(0)
+    , _capacidad(0)
+    , _tamanoFuente(0)
+    , _formato(FormatoFuente::Texto)
+    , _independientes(true)
+{
+}
+
+IndiceSesiones::~IndiceSesiones()
+{
+    delete[] _entradas;
+}
+
+bool IndiceSesiones::construir(const char* fuente, std::size_t tamano)
+{
+    limpiar();
+    _tamanoFuente = tamano;
+    _formato = esCaptura(fuente, tamano) ? FormatoFuente::Captura : FormatoFuente::Texto;
+
+    Escaneo escaneo;
+    bool exito = true;
+    // Revisa una trama completa; false si ya no tiene sentido seguir.
+    auto revisar = [&]() -> bool {
+        const TramaDecodificada& trama = escaneo.trama;
+        if (trama.canal >= 0 || trama.error == ErrorTrama::CanalInvalido || trama.tipo == TipoTrama::InicioBinario) {
+            _independientes = false;
+            return false;
+        }
+        if (trama.tipo == TipoTrama::Inicio && !agregar(escaneo.linea)) {
+            exito = false;
+            return false;
+        }
+        return true;
+    };
+    // Recorre un tramo de datos; posicion(i) da la posición en la fuente del byte i.
+    auto escanear = [&](const char* datos, std::size_t longitud, auto posicion) {
+        for (std::size_t i = 0; i < longitud && !escaneo.detenido; ++i) {
+            if (escaneo.lineaNueva) {
+                escaneo.linea = EntradaSesion {posicion(i), escaneo.instanteUs, escaneo.segmento};
+                escaneo.lineaNueva = false;
+            }
+            if (escaneo.analizador.consumir(datos[i], escaneo.trama)) {
+                escaneo.detenido = !revisar();
+            }
+            escaneo.lineaNueva = (datos[i] == '\n');
+        }
+    };
+
+    if (_formato == FormatoFuente::Texto) {
+        escanear(fuente, tamano, [](std::size_t i) { return PosicionFuente {i, 0}; });
+        // Como en DecodificadorLotes, una última línea sin '\n' también es una trama.
+        if (!escaneo.detenido && escaneo.analizador.finalizar(escaneo.trama)) {
+            revisar();
+        }
+        return exito;
+    }
+
+    const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(fuente);
+    std::size_t pos = sizeof(FormatoCaptura::kFirma);
+    bool enSegmento = false;
+    while (pos < tamano && !escaneo.detenido) {
+        const std::size_t inicio = pos;
+        FormatoCaptura::Registro registro {};
+        if (!FormatoCaptura::leerRegistro(bytes, tamano, pos, registro) || (registro.tipo == FormatoCaptura::kDatos && !enSegmento)) {
+            return false;
+        }
+        if (registro.tipo == FormatoCaptura::kSegmento) {
+            if (enSegmento) {
+                ++escaneo.segmento;
+            }
+            escaneo.instanteUs = 0;
+            enSegmento = true;
+            continue;
+        }
+        escaneo.instanteUs += registro.valor;
+        escanear(fuente + registro.datos, registro.longitud,
+                 [inicio](std::size_t i) { return PosicionFuente {inicio, i}; });
+    }
+    return exito;
+}
+
+bool IndiceSesiones::guardar(const char* ruta) const
+{
+    if (!ruta || ruta[0] == '\0') {
+        return false;
+    }
+    char temporal[4096];
+    if (std::snprintf(temporal, sizeof(temporal), "%s.tmp", ruta) >= static_cast<int>(sizeof(temporal))) {
+        return false;
+    }
+    const int fd = ::open(temporal, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    unsigned char cabecera[FormatoIndice::kCabecera] = {};
+    std::memcpy(cabecera, FormatoIndice::kFirma, sizeof(FormatoIndice::kFirma));
+    escribirU64(cabecera + 8, _tamanoFuente);
+    escribirU64(cabecera + 16, _cantidad);
+    cabecera[24] = static_cast<unsigned char>(_formato);
+    cabecera[25] = _independientes ? 1 : 0;
+
+    bool exito = ::write(fd, cabecera, sizeof(cabecera)) == static_cast<ssize_t>(sizeof(cabecera));
+    unsigned char bloque[FormatoIndice::kEntrada * 128];
+    std::size_t enBloque = 0;
+    for (std::size_t i = 0; i < _cantidad && exito; ++i) {
+        unsigned char* entrada = bloque + enBloque * FormatoIndice::kEntrada;
+        std::memset(entrada, 0, FormatoIndice::kEntrada);
+        escribirU64(entrada, _entradas[i].posicion.registro);
+        escribirU64(entrada + 8, _entradas[i].posicion.dentro);
+        escribirU64(entrada + 16, _entradas[i].instanteUs);
+        escribirU64(entrada + 24, _entradas[i].segmento);
+        if (++enBloque == 128 || i + 1 == _cantidad) {
+            const std::size_t bytes = enBloque * FormatoIndice::kEntrada;
+            exito = ::write(fd, bloque, bytes) == static_cast<ssize_t>(bytes);
+            enBloque = 0;
+        }
+    }
+    exito = (::close(fd) == 0) && exito;
+    if (!exito) {
+        ::unlink(temporal);
+        return false;
+    }
+    return ::rename(temporal, ruta) == 0;
+}
+
+bool IndiceSesiones::cargar(const char* ruta, std::uint64_t tamanoFuente)
+{
+    limpiar();
+    const int fd = ruta ? ::open(ruta, O_RDONLY) : -1;
+    if (fd < 0) {
+        return false;
+    }
+
+    unsigned char cabecera[FormatoIndice::kCabecera];
+    struct stat info {};
+    bool valido = ::read(fd, cabecera, sizeof(cabecera)) == static_cast<ssize_t>(sizeof(cabecera))
+        && std::memcmp(cabecera, FormatoIndice::kFirma, sizeof(FormatoIndice::kFirma)) == 0
+        && leerU64(cabecera + 8) == tamanoFuente && cabecera[24] <= static_cast<unsigned char>(FormatoFuente::Captura)
+        && fstat(fd, &info) == 0;
+    const std::uint64_t cantidad = valido ? leerU64(cabecera + 16) : 0;
+    valido = valido
+        && static_cast<std::uint64_t>(info.st_size) == FormatoIndice::kCabecera + cantidad * FormatoIndice::kEntrada;
+
+    unsigned char bloque[FormatoIndice::kEntrada * 128];
+    for (std::uint64_t i = 0; valido && i < cantidad;) {
+        std::size_t enBloque = static_cast<std::size_t>((cantidad - i < 128) ? cantidad - i : 128);
+        const std::size_t bytes = enBloque * FormatoIndice::kEntrada;
+        valido = ::read(fd, bloque, bytes) == static_cast<ssize_t>(bytes);
+        for (std::size_t j = 0; valido && j < enBloque; ++j, ++i) {
+            const unsigned char* entrada = bloque + j * FormatoIndice::kEntrada;
+            EntradaSesion sesion {};
+            sesion.posicion.registro = leerU64(entrada);
+            sesion.posicion.dentro = leerU64(entrada + 8);
+            sesion.instanteUs = leerU64(entrada + 16);
+            sesion.segmento = static_cast<std::uint32_t>(leerU64(entrada + 24));
+            valido = sesion.posicion.registro < tamanoFuente && agregar(sesion);
+        }
+    }
+    ::close(fd);
+
+    if (!valido) {
+        limpiar();
+        return false;
+    }
+    _tamanoFuente = tamanoFuente;
+    _formato = static_cast<FormatoFuente>(cabecera[24]);
+    _independientes = cabecera[25] != 0;
+    return true;
+}
+
+std::size_t IndiceSesiones::sesiones() const noexcept
+{
+    return _cantidad;
+}
+
+const EntradaSesion& IndiceSesiones::sesion(std::size_t n) const noexcept
+{
+    return _entradas[n];
+}
+
+FormatoFuente IndiceSesiones::formato() const noexcept
+{
+    return _formato;
+}
+
+bool IndiceSesiones::independientes() const noexcept
+{
+    return _independientes;
+}
+
+PosicionFuente IndiceSesiones::inicioDatos() const noexcept
+{
+    const std::uint64_t inicio = (_formato == FormatoFuente::Captura) ? sizeof(FormatoCaptura::kFirma) : 0;
+    return PosicionFuente {inicio, 0};
+}
+
+bool IndiceSesiones::recorrer(const char* fuente, std::size_t tamano, const PosicionFuente& desde,
+                              const PosicionFuente* hasta, EntregaDatos entrega, void* contexto) const
+{
+    if (!fuente || !entrega || desde.registro > tamano) {
+        return false;
+    }
+
+    if (_formato == FormatoFuente::Texto) {
+        std::size_t fin = hasta ? static_cast<std::size_t>(hasta->registro) : tamano;
+        if (fin > tamano) {
+            fin = tamano;
+        }
+        if (fin > desde.registro) {
+            entrega(contexto, fuente + desde.registro, fin - static_cast<std::size_t>(desde.registro));
+        }
+        return true;
+    }
+
+    const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(fuente);
+    std::size_t pos = static_cast<std::size_t>(desde.registro);
+    while (pos < tamano) {
+        const std::size_t inicio = pos;
+        FormatoCaptura::Registro registro {};
+        if (!FormatoCaptura::leerRegistro(bytes, tamano, pos, registro)) {
+            return false;
+        }
+        if (registro.tipo != FormatoCaptura::kDatos) {
+            continue;
+        }
+        std::size_t a = (inicio == desde.registro) ? static_cast<std::size_t>(desde.dentro) : 0;
+        std::size_t b = registro.longitud;
+        const bool ultimo = hasta && inicio == hasta->registro;
+        if (ultimo && hasta->dentro < b) {
+            b = static_cast<std::size_t>(hasta->dentro);
+        }
+        if (b > a) {
+            entrega(contexto, fuente + registro.datos + a, b - a);
+        }
+        if (ultimo) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool IndiceSesiones::rutaIndice(const char* fuente, char* destino, std::size_t capacidad) noexcept
+{
+    if (!fuente || !destino || capacidad == 0) {
+        return false;
+    }
+    const int escritos = std::snprintf(destino, capacidad, "%s.idx", fuente);
+    return escritos > 0 && static_cast<std::size_t>(escritos) < capacidad;
+}
+
+bool IndiceSesiones::agregar(const EntradaSesion& entrada) noexcept
+{
+    if (_cantidad == _capacidad) {
+        const std::size_t capacidad = _capacidad ? _capacidad * 2 : 256;
+        EntradaSesion* entradas = new (std::nothrow) EntradaSesion[capacidad];
+        if (!entradas) {
+            return false;
+        }
+        if (_cantidad > 0) {
+            std::memcpy(entradas, _entradas, _cantidad * sizeof(EntradaSesion));
+        }
+        delete[] _entradas;
+        _entradas = entradas;
+        _capacidad = capacidad;
+    }
+    _entradas[_cantidad++] = entrada;
+    return true;
+}
+
+void IndiceSesiones::limpiar() noexcept
+{
+    _cantidad = 0;
+    _tamanoFuente = 0;
+    _formato = FormatoFuente::Texto;
+    _independientes = true;
+}
@@ -0,0 +1,136 @@
+#include "InstrumentacionEtapas.h"
+
+#include "AuxiliarCli.h"
+#include "MedidorLatencia.h"
+
+#include <csignal>
+#include <cstdio>
+
+namespace {
+
+volatile std::sig_atomic_t gReportePendiente = 0;
+
+extern "C" void solicitarReporte(int)
+{
+    gReportePendiente = 1;
+}
+
+} // namespace
+
+InstrumentacionEtapas::InstrumentacionEtapas() noexcept
+{
+    reiniciar();
+}
+
+void InstrumentacionEtapas::reiniciar() noexcept
+{
+    for (std::size_t i = 0; i < kEtapas; ++i) {
+        _histogramas[i].reiniciar();
+    }
+    _lecturaNs = 0;
+    _delimitacionNs = 0;
+    _anteriorNs = 0;
+}
+
+void InstrumentacionEtapas::inicioBloque() noexcept
+{
+    _lecturaNs = MedidorLatencia::ahoraNs();
+    // En modo flujo no hay delimitación previa: las tramas parten de la lectura.
+    _delimitacionNs = _lecturaNs;
+}
+
+void InstrumentacionEtapas::finDelimitacion() noexcept
+{
+    _delimitacionNs = MedidorLatencia::ahoraNs();
+}
+
+void InstrumentacionEtapas::inicioTrama() noexcept
+{
+    _histogramas[static_cast<std::size_t>(EtapaTrama::Delimitacion)].registrar(_delimitacionNs - _lecturaNs);
+    _anteriorNs = _delimitacionNs;
+    marcar(EtapaTrama::Espera);
+}
+
+void InstrumentacionEtapas::marcar(EtapaTrama etapa) noexcept
+{
+    const std::uint64_t ahora = MedidorLatencia::ahoraNs();
+    _histogramas[static_cast<std::size_t>(etapa)].registrar(ahora - _anteriorNs);
+    _anteriorNs = ahora;
+}
+
+void InstrumentacionEtapas::finTrama() noexcept
+{
+    _histogramas[static_cast<std::size_t>(EtapaTrama::Total)].registrar(MedidorLatencia::ahoraNs() - _lecturaNs);
+}
+
+const HistogramaLatencia& InstrumentacionEtapas::histograma(EtapaTrama etapa) const noexcept
+{
+    return _histogramas[static_cast<std::size_t>(etapa)];
+}
+
+void InstrumentacionEtapas::imprimirReporte(AuxiliarCli* logger) const
+{
+    char linea[160];
+    std::snprintf(linea, sizeof(linea), "%-13s %10s %10s %10s %10s %10s", "Etapa (ns)", "tramas", "p50", "p99",
+                  "p99.9", "max");
+    if (logger) {
+        logger->imprimirLog("STATUS", "Latencia por etapa:");
+        logger->imprimirCrudo(NivelLog::Status, linea);
+    } else {
+        std::fprintf(stderr, "%s\n", linea);
+    }
+
+    for (std::size_t i = 0; i < kEtapas; ++i) {
+        const HistogramaLatencia& h = _histogramas[i];
+        std::snprintf(linea, sizeof(linea), "%-13s %10llu %10llu %10llu %10llu %10llu",
+                      nombreEtapa(static_cast<EtapaTrama>(i)), static_cast<unsigned long long>(h.cantidad()),
+                      static_cast<unsigned long long>(h.percentil(0.50)),
+                      static_cast<unsigned long long>(h.percentil(0.99)),
+                      static_cast<unsigned long long>(h.percentil(0.999)), static_cast<unsigned long long>(h.maximo()));
+        if (logger) {
+            logger->imprimirCrudo(NivelLog::Status, linea);
+        } else {
+            std::fprintf(stderr, "%s\n", linea);
+        }
+    }
+}
+
+void InstrumentacionEtapas::instalarSenalReporte() noexcept
+{
+    struct sigaction accion {};
+    accion.sa_handler = solicitarReporte;
+    sigemptyset(&accion.sa_mask);
+    // Sin SA_RESTART: select() vuelve con EINTR y el bucle atiende la solicitud.
+    accion.sa_flags = 0;
+    sigaction(SIGUSR1, &accion, nullptr);
+}
+
+bool InstrumentacionEtapas::reporteSolicitado() noexcept
+{
+    if (!gReportePendiente) {
+        return false;
+    }
+    gReportePendiente = 0;
+    return true;
+}
+
+const char* InstrumentacionEtapas::nombreEtapa(EtapaTrama etapa) noexcept
+{
+    switch (etapa) {
+    case EtapaTrama::Delimitacion:
+        return "delimitacion";
+    case EtapaTrama::Espera:
+        return "espera";
+    case EtapaTrama::Analisis:
+        return "analisis";
+    case EtapaTrama::Mapeo:
+        return "mapeo";
+    case EtapaTrama::Insercion:
+        return "insercion";
+    case EtapaTrama::Salida:
+        return "salida";
+    case EtapaTrama::Total:
+        return "total";
+    }
+    return "?";
+}
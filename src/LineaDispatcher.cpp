@@ -1,23 +1,130 @@
 #include "LineaDispatcher.h"
 
 #include "AuxiliarCli.h"
+#include "InstrumentacionEtapas.h"
 #include "ListaDeCarga.h"
+#include "MedidorLatencia.h"
+#include "ProtocoloBinario.h"
+#include "RegistroContadores.h"
 #include "RotorDeMapeo.h"
+#include "SalidaMensaje.h"
 #include "TramaLoad.h"
+#include "TramaLote.h"
 #include "TramaMap.h"
 
 #include <cctype>
+#include <climits>
 #include <cstdio>
 #include <cstring>
-#include <iostream>
+#include <new>
+
+namespace {
+
+void describirCaracter(char caracter, char* destino, std::size_t tam)
+{
+    if (!destino || tam == 0) {
+        return;
+    }
+
+    if (caracter == '\t') {
+        std::snprintf(destino, tam, "'\\t'");
+        return;
+    }
+    if (caracter == '\n') {
+        std::snprintf(destino, tam, "'\\n'");
+        return;
+    }
+    if (caracter == '\r') {
+        std::snprintf(destino, tam, "'\\r'");
+        return;
+    }
+
+    if (std::isprint(static_cast<unsigned char>(caracter)) || caracter == ' ') {
+        std::snprintf(destino, tam, "'%c'", caracter);
+    } else {
+        std::snprintf(destino, tam, "0x%02X", static_cast<unsigned int>(static_cast<unsigned char>(caracter)));
+    }
+}
+
+// Formateadores diferidos: se ejecutan en el hilo del logger, no en el de decodificación.
+
+void formatearTramaTexto(const RegistroLog& r, char* destino, std::size_t tam)
+{
+    std::snprintf(destino, tam, "Trama recibida: [%.*s]", static_cast<int>(r.longitudTexto), r.texto);
+}
+
+void formatearTramaCarga(const RegistroLog& r, char* destino, std::size_t tam)
+{
+    char descripcion[32];
+    describirCaracter(static_cast<char>(r.enteros[0]), descripcion, sizeof(descripcion));
+    std::snprintf(destino, tam, "Trama recibida: [L,%s]", descripcion);
+}
+
+void formatearTramaMapa(const RegistroLog& r, char* destino, std::size_t tam)
+{
+    std::snprintf(destino, tam, "Trama recibida: [M,%ld]", r.enteros[0]);
+}
+
+void formatearTramaLote(const RegistroLog& r, char* destino, std::size_t tam)
+{
+    std::snprintf(destino, tam, "Trama recibida: [B,%.*s]", static_cast<int>(r.longitudTexto), r.texto);
+}
+
+void formatearFragmento(const RegistroLog& r, char* destino, std::size_t tam)
+{
+    char origen[32];
+    char decodificado[32];
+    describirCaracter(static_cast<char>(r.enteros[0]), origen, sizeof(origen));
+    describirCaracter(static_cast<char>(r.enteros[1]), decodificado, sizeof(decodificado));
+    std::snprintf(destino, tam, " -> Procesando... -> Fragmento %s decodificado como %s.", origen, decodificado);
+}
+
+void formatearAvanceMensaje(const RegistroLog& r, char* destino, std::size_t tam)
+{
+    std::snprintf(destino, tam, " Mensaje: +\"%.*s\" (%ld caracteres)", static_cast<int>(r.longitudTexto), r.texto,
+                  r.enteros[0]);
+}
+
+void formatearRotacion(const RegistroLog& r, char* destino, std::size_t tam)
+{
+    const long desplazamiento = r.enteros[0];
+    const char signo = (desplazamiento >= 0) ? '+' : '-';
+    const long magnitud = (desplazamiento >= 0) ? desplazamiento : -desplazamiento;
+    std::snprintf(destino, tam, " -> Procesando... -> ROTANDO ROTOR %c%ld. (Ahora 'A' se mapea a '%c')", signo, magnitud,
+                  static_cast<char>(r.enteros[1]));
+}
+
+} // namespace
+
+/**
+ * @brief Entrada de la tabla de canales: la lista del canal y su sesión guardada.
+ */
+struct LineaDispatcher::Canal {
+    ListaDeCarga carga;
+    EstadoSesion estado;
+};
 
 LineaDispatcher::LineaDispatcher(ListaDeCarga* carga, RotorDeMapeo* rotor, AuxiliarCli* logger) noexcept
     : _carga(carga)
     , _rotor(rotor)
     , _logger(logger)
+    , _salida(nullptr)
+    , _medidor(nullptr)
+    , _instrumentacion(nullptr)
+    , _contadores(nullptr)
     , _procesadas(0)
     , _sesionActiva(false)
+    , _mensajeAbierto(false)
+    , _binario(false)
+    , _base {nullptr, 0, 0, false, false}
+    , _canales(nullptr)
+    , _canalActual(-1)
+{
+}
+
+LineaDispatcher::~LineaDispatcher()
 {
+    delete[] _canales;
 }
 
 void LineaDispatcher::setLogger(AuxiliarCli* logger) noexcept
@@ -25,8 +132,36 @@ void LineaDispatcher::setLogger(AuxiliarCli* logger) noexcept
     _logger = logger;
 }
 
+AuxiliarCli* LineaDispatcher::getLogger() const noexcept
+{
+    return _logger;
+}
+
+void LineaDispatcher::setSalida(SalidaMensaje* salida) noexcept
+{
+    _salida = salida;
+}
+
+void LineaDispatcher::setMedidor(MedidorLatencia* medidor) noexcept
+{
+    _medidor = medidor;
+}
+
+void LineaDispatcher::setInstrumentacion(InstrumentacionEtapas* instrumentacion) noexcept
+{
+    _instrumentacion = instrumentacion;
+}
+
+void LineaDispatcher::setContadores(RegistroContadores* contadores) noexcept
+{
+    _contadores = contadores;
+}
+
 void LineaDispatcher::setComponentes(ListaDeCarga* carga, RotorDeMapeo* rotor) noexcept
 {
+    if (_canalActual >= 0) {
+        cambiarCanal(-1);
+    }
     _carga = carga;
     _rotor = rotor;
     _sesionActiva = false;
@@ -35,6 +170,18 @@ void LineaDispatcher::setComponentes(ListaDeCarga* carga, RotorDeMapeo* rotor) n
 
 void LineaDispatcher::iniciarSesion(const char* motivo, bool limpiar)
 {
+    if (_canalActual >= 0) {
+        cambiarCanal(-1);
+    }
+    abrirSesion(motivo, limpiar);
+}
+
+void LineaDispatcher::abrirSesion(const char* motivo, bool limpiar)
+{
+    if (_sesionActiva && limpiar) {
+        cerrarMensaje();
+    }
+
     if (limpiar) {
         if (_carga) {
             _carga->limpiar();
@@ -45,21 +192,146 @@ void LineaDispatcher::iniciarSesion(const char* motivo, bool limpiar)
     }
     _procesadas = 0;
     _sesionActiva = true;
+    _mensajeAbierto = true;
+    contar(Contador::SesionesIniciadas);
 
     if (_logger && motivo) {
         char mensaje[160];
-        std::snprintf(mensaje, sizeof(mensaje), "Secuencia %s detectada. Reiniciando estructuras.", motivo);
+        if (_canalActual >= 0) {
+            std::snprintf(mensaje, sizeof(mensaje), "Secuencia %s detectada en el canal %d. Reiniciando estructuras.",
+                          motivo, _canalActual);
+        } else {
+            std::snprintf(mensaje, sizeof(mensaje), "Secuencia %s detectada. Reiniciando estructuras.", motivo);
+        }
         _logger->imprimirLog("STATUS", mensaje);
         registrarSaltoLinea();
     }
 }
 
-void LineaDispatcher::terminarSesion() noexcept
+void LineaDispatcher::terminarSesion()
 {
+    if (_canales) {
+        for (int i = 0; i < AnalizadorTramas::kMaxCanales; ++i) {
+            if (i != _canalActual && !_canales[i].estado.activa) {
+                continue;
+            }
+            cambiarCanal(i);
+            if (_sesionActiva) {
+                cerrarMensaje();
+            }
+            _sesionActiva = false;
+            _procesadas = 0;
+        }
+        cambiarCanal(-1);
+    }
+
+    if (_sesionActiva) {
+        cerrarMensaje();
+    }
     _sesionActiva = false;
+    _binario = false;
     _procesadas = 0;
 }
 
+void LineaDispatcher::reportarMensaje() const
+{
+    if (!_carga || !_logger) {
+        return;
+    }
+    if (_canalActual >= 0) {
+        char titulo[64];
+        std::snprintf(titulo, sizeof(titulo), "Mensaje ensamblado del canal %d:", _canalActual);
+        _logger->imprimirLog("SUCCESS", titulo);
+    } else {
+        _logger->imprimirLog("SUCCESS", "Mensaje ensamblado:");
+    }
+    _carga->imprimirMensaje(_logger);
+    registrarSaltoLinea();
+}
+
+void LineaDispatcher::cerrarMensaje()
+{
+    contar(Contador::SesionesTerminadas);
+    emitirMensaje();
+}
+
+void LineaDispatcher::emitirMensaje()
+{
+    // Tras un FIN sin caracteres nuevos no hay mensaje que cerrar: no se escribe una línea vacía.
+    if (!_mensajeAbierto) {
+        return;
+    }
+    _mensajeAbierto = false;
+    reportarMensaje();
+    if (_canales) {
+        // Con canales en uso los mensajes se retienen en su lista y salen completos, con prefijo si es de un canal.
+        if (_salida && _canalActual >= 0) {
+            char prefijo[16];
+            const int longitud = std::snprintf(prefijo, sizeof(prefijo), "%d:", _canalActual);
+            _salida->escribirFragmento(prefijo, static_cast<std::size_t>(longitud));
+        }
+        char bloque[256];
+        while (entregarPendiente(bloque, sizeof(bloque)) > 0) {
+        }
+    }
+    if (_salida) {
+        _salida->finalizarMensaje();
+    }
+}
+
+bool LineaDispatcher::cambiarCanal(int canal)
+{
+    if (canal >= 0 && !_canales) {
+        _canales = new (std::nothrow) Canal[AnalizadorTramas::kMaxCanales];
+        if (!_canales) {
+            log("ERROR", "No se pudo reservar la tabla de canales.");
+            return false;
+        }
+        for (int i = 0; i < AnalizadorTramas::kMaxCanales; ++i) {
+            _canales[i].estado = EstadoSesion {&_canales[i].carga, 0, 0, false, false};
+        }
+        // La sesión sin canal deja de escribir al vuelo: lo ya escrito queda como una línea propia
+        // para que no se mezcle con los mensajes de los canales.
+        if (_canalActual < 0 && _sesionActiva && _salida && _carga && _carga->tamano() > 0) {
+            _salida->finalizarMensaje();
+        }
+    }
+
+    EstadoSesion& saliente = (_canalActual < 0) ? _base : _canales[_canalActual].estado;
+    saliente.carga = _carga;
+    saliente.desplazamiento = _rotor ? _rotor->getDesplazamiento() : 0;
+    saliente.procesadas = _procesadas;
+    saliente.activa = _sesionActiva;
+    saliente.mensajeAbierto = _mensajeAbierto;
+
+    const EstadoSesion& entrante = (canal < 0) ? _base : _canales[canal].estado;
+    _carga = entrante.carga;
+    if (_rotor) {
+        // Con el motor por tabla basta con mover la fila vigente: cambiar de canal es O(1).
+        _rotor->rotar(entrante.desplazamiento - _rotor->getDesplazamiento());
+    }
+    _procesadas = entrante.procesadas;
+    _sesionActiva = entrante.activa;
+    _mensajeAbierto = entrante.mensajeAbierto;
+    _canalActual = canal;
+    return true;
+}
+
+std::size_t LineaDispatcher::entregarPendiente(char* destino, std::size_t capacidad)
+{
+    if (!_carga) {
+        return 0;
+    }
+    const std::size_t cantidad = _carga->extraerPendiente(destino, capacidad);
+    if (_contadores) {
+        _contadores->sumar(Contador::CaracteresDecodificados, cantidad);
+    }
+    if (_salida && cantidad > 0) {
+        _salida->escribirFragmento(destino, cantidad);
+    }
+    return cantidad;
+}
+
 bool LineaDispatcher::sesionActiva() const noexcept
 {
     return _sesionActiva;
@@ -75,182 +347,412 @@ void LineaDispatcher::onRawLine(const char* linea)
     if (!linea || linea[0] == '\0') {
         return;
     }
+    onRawLine(linea, std::strlen(linea));
+}
 
-    char buffer[128];
-    const std::size_t limite = sizeof(buffer) - 1;
-    std::size_t longitud = std::strlen(linea);
-    if (longitud > limite) {
-        longitud = limite;
+void LineaDispatcher::onRawLines(const VistaLinea* lineas, std::size_t cantidad)
+{
+    if (!lineas) {
+        return;
+    }
+    for (std::size_t i = 0; i < cantidad; ++i) {
+        onRawLine(lineas[i].datos, lineas[i].longitud);
+    }
+}
+
+void LineaDispatcher::onRawLine(const char* linea, std::size_t longitud)
+{
+    if (!linea) {
+        return;
     }
-    std::memcpy(buffer, linea, longitud);
-    buffer[longitud] = '\0';
 
-    while (longitud > 0 && (buffer[longitud - 1] == '\r' || buffer[longitud - 1] == '\n')) {
-        buffer[--longitud] = '\0';
+    while (longitud > 0 && (linea[longitud - 1] == '\r' || linea[longitud - 1] == '\n')) {
+        --longitud;
     }
 
-    if (longitud == 0) {
+    PRT7_INSTRUMENTAR(_instrumentacion, inicioTrama());
+    TramaDecodificada trama;
+    if (!_analizador.analizarLinea(linea, longitud, trama)) {
         return;
     }
+    PRT7_INSTRUMENTAR(_instrumentacion, marcar(EtapaTrama::Analisis));
+    aplicarTrama(trama, linea, longitud);
+    PRT7_INSTRUMENTAR(_instrumentacion, finTrama());
+}
+
+void LineaDispatcher::onRawBytes(const char* datos, std::size_t cantidad)
+{
+    if (!datos) {
+        return;
+    }
+
+    TramaDecodificada trama;
+    BloqueBinario bloque;
+    const char* const fin = datos + cantidad;
+    while (datos < fin) {
+        if (_binario) {
+            if (_analizadorBinario.consumir(datos, fin, bloque)) {
+                onBloqueBinario(bloque);
+            }
+            continue;
+        }
+        if (_analizadorFlujo.consumir(*datos++, trama)) {
+            // En modo flujo el análisis ocurre byte a byte y queda dentro de la espera.
+            PRT7_INSTRUMENTAR(_instrumentacion, inicioTrama());
+            aplicarTrama(trama, nullptr, 0);
+            PRT7_INSTRUMENTAR(_instrumentacion, finTrama());
+        }
+    }
+}
+
+bool LineaDispatcher::onBloqueBinario(const BloqueBinario& bloque)
+{
+    if (bloque.error == ErrorBinario::Crc) {
+        contar(Contador::InvalidasCrc);
+        log("WARNING", "Bloque binario descartado por CRC inválido.");
+        return true;
+    }
+    if (bloque.error == ErrorBinario::Vacio) {
+        contar(Contador::InvalidasIncompleta);
+        log("WARNING", "Bloque binario vacío recibido.");
+        return true;
+    }
+
+    const unsigned char* p = bloque.cuerpo;
+    const unsigned char* const fin = bloque.cuerpo + bloque.longitud;
+    TramaDecodificada trama;
+    int canal = -1; // la operación Canal solo rige hasta el final del bloque
+    while (p < fin) {
+        const ProtocoloBinario::Operacion operacion = static_cast<ProtocoloBinario::Operacion>(*p++);
+        if (operacion == ProtocoloBinario::Operacion::Fin) {
+            // Lo que quede en el bloque después de Fin se ignora.
+            _binario = false;
+            return false;
+        }
+        if (operacion == ProtocoloBinario::Operacion::Canal) {
+            // Un canal válido solo afecta a las operaciones siguientes: no es una trama y no se mide.
+            std::uint64_t numero = 0;
+            const std::size_t leidos = ProtocoloBinario::leerVarint(p, static_cast<std::size_t>(fin - p), numero);
+            if (leidos != 0 && numero <= static_cast<std::uint64_t>(AnalizadorTramas::kMaxCanales)) {
+                p += leidos;
+                canal = static_cast<int>(numero) - 1;
+                continue;
+            }
+        }
+        PRT7_INSTRUMENTAR(_instrumentacion, inicioTrama());
+
+        trama.tipo = TipoTrama::Invalida;
+        trama.error = ErrorTrama::Ninguno;
+        trama.dato = '\0';
+        trama.desplazamiento = 0;
+        trama.marca = 0;
+        trama.lote = nullptr;
+        trama.longitudLote = 0;
+        trama.canal = canal;
+
+        const std::size_t restantes = static_cast<std::size_t>(fin - p);
+        std::uint64_t valor = 0;
+        std::size_t usados = 0;
+        switch (operacion) {
+        case ProtocoloBinario::Operacion::Inicio:
+            trama.tipo = TipoTrama::Inicio;
+            break;
+        case ProtocoloBinario::Operacion::Carga:
+            if (restantes == 0) {
+                trama.error = ErrorTrama::Incompleta;
+                break;
+            }
+            trama.tipo = TipoTrama::Carga;
+            trama.dato = static_cast<char>(*p++);
+            break;
+        case ProtocoloBinario::Operacion::Mapa: {
+            usados = ProtocoloBinario::leerVarint(p, restantes, valor);
+            if (usados == 0) {
+                trama.error = ErrorTrama::RotacionInvalida;
+                break;
+            }
+            p += usados;
+            std::int64_t desplazamiento = ProtocoloBinario::desdeZigzag(valor);
+            if (desplazamiento > INT_MAX) {
+                desplazamiento = INT_MAX;
+            } else if (desplazamiento < INT_MIN) {
+                desplazamiento = INT_MIN;
+            }
+            trama.tipo = TipoTrama::Mapa;
+            trama.desplazamiento = static_cast<int>(desplazamiento);
+            break;
+        }
+        case ProtocoloBinario::Operacion::Lote:
+            usados = ProtocoloBinario::leerVarint(p, restantes, valor);
+            if (usados == 0 || valor == 0 || valor > restantes - usados) {
+                trama.error = ErrorTrama::Incompleta;
+                break;
+            }
+            p += usados;
+            trama.tipo = TipoTrama::Lote;
+            trama.lote = reinterpret_cast<const char*>(p);
+            trama.longitudLote = static_cast<std::size_t>(valor);
+            p += valor;
+            break;
+        case ProtocoloBinario::Operacion::FinMensaje:
+            trama.tipo = TipoTrama::FinMensaje;
+            break;
+        case ProtocoloBinario::Operacion::Marca:
+            usados = ProtocoloBinario::leerVarint(p, restantes, valor);
+            if (usados == 0 || valor > static_cast<std::uint64_t>(LONG_MAX)) {
+                trama.error = ErrorTrama::TokenInvalido;
+                break;
+            }
+            p += usados;
+            trama.tipo = TipoTrama::Marca;
+            trama.marca = static_cast<long>(valor);
+            break;
+        case ProtocoloBinario::Operacion::Canal:
+            // Los canales válidos se atendieron antes del switch.
+            trama.error = ErrorTrama::CanalInvalido;
+            break;
+        default:
+            trama.error = ErrorTrama::PrefijoDesconocido;
+            break;
+        }
+        PRT7_INSTRUMENTAR(_instrumentacion, marcar(EtapaTrama::Analisis));
+
+        aplicarTrama(trama, nullptr, 0);
+        PRT7_INSTRUMENTAR(_instrumentacion, finTrama());
+        if (trama.error != ErrorTrama::Ninguno) {
+            // Sin separadores no hay forma de saber dónde empieza la siguiente operación.
+            break;
+        }
+    }
+    return true;
+}
 
-    char mayus[128];
-    std::size_t idx = 0;
-    for (; idx < longitud && idx < sizeof(mayus) - 1; ++idx) {
-        mayus[idx] = static_cast<char>(std::toupper(static_cast<unsigned char>(buffer[idx])));
+void LineaDispatcher::setLongitudMaximaLinea(std::size_t maximo) noexcept
+{
+    _analizador.setLongitudMaxima(maximo);
+    _analizadorFlujo.setLongitudMaxima(maximo);
+}
+
+void LineaDispatcher::aplicarTrama(const TramaDecodificada& trama, const char* texto, std::size_t longitud)
+{
+    if (_medidor) {
+        _medidor->contarTrama();
     }
-    mayus[idx] = '\0';
 
-    if (std::strcmp(mayus, "INICIO") == 0) {
-        iniciarSesion("INICIO", true);
+    if (trama.error == ErrorTrama::CanalInvalido) {
+        contar(Contador::InvalidasCanal);
+        log("WARNING", "Canal fuera de rango.");
+        return;
+    }
+    if (trama.canal != _canalActual && !cambiarCanal(trama.canal)) {
         return;
     }
 
-    if (!_sesionActiva) {
-        log("WARNING", "Se ignora la trama porque no se ha recibido INICIO.");
+    if (trama.tipo == TipoTrama::Marca) {
+        contar(Contador::TramasMarca);
+        if (_medidor) {
+            _medidor->registrarMarca(static_cast<std::uint64_t>(trama.marca));
+        }
         return;
     }
 
-    if (_logger) {
-        char mensaje[160];
-        std::snprintf(mensaje, sizeof(mensaje), "Trama recibida: [%s]", buffer);
-        _logger->imprimirLog("STATUS", mensaje);
+    if (trama.tipo == TipoTrama::Inicio) {
+        contar(Contador::TramasInicio);
+        abrirSesion("INICIO", true);
+        return;
     }
 
-    char* tipo = std::strtok(buffer, ",");
-    char* payload = std::strtok(nullptr, ",");
+    if (trama.tipo == TipoTrama::InicioBinario) {
+        contar(Contador::TramasInicio);
+        abrirSesion(ProtocoloBinario::kMarcador, true);
+        _binario = true;
+        _analizadorBinario.reiniciar();
+        return;
+    }
 
-    if (!tipo || !payload) {
-        log("WARNING", "Trama incompleta recibida.");
+    if (trama.error == ErrorTrama::Desbordada) {
+        contar(Contador::InvalidasDesbordada);
+        log("WARNING", "Trama descartada por exceder el buffer.");
         return;
     }
 
-    while (*payload == ' ') {
-        ++payload;
+    if (!_sesionActiva) {
+        contar(Contador::InvalidasSinInicio);
+        log("WARNING", "Se ignora la trama porque no se ha recibido INICIO.");
+        return;
+    }
+
+    if (trama.tipo == TipoTrama::FinMensaje) {
+        contar(Contador::TramasFin);
+        ++_procesadas;
+        emitirMensaje();
+        if (_carga) {
+            _carga->limpiar();
+        }
+        return;
+    }
+
+    if (_logger && _logger->habilitado(NivelLog::Detalle)) {
+        if (texto) {
+            _logger->registrar(NivelLog::Detalle, "STATUS", formatearTramaTexto, 0, 0, 0, texto, longitud);
+        } else if (trama.tipo == TipoTrama::Carga) {
+            _logger->registrar(NivelLog::Detalle, "STATUS", formatearTramaCarga, trama.dato);
+        } else if (trama.tipo == TipoTrama::Mapa) {
+            _logger->registrar(NivelLog::Detalle, "STATUS", formatearTramaMapa, trama.desplazamiento);
+        } else if (trama.tipo == TipoTrama::Lote) {
+            _logger->registrar(NivelLog::Detalle, "STATUS", formatearTramaLote, 0, 0, 0, trama.lote, trama.longitudLote);
+        }
     }
 
-    const char prefijo = static_cast<char>(std::toupper(static_cast<unsigned char>(tipo[0])));
     bool exito = false;
-    if (prefijo == 'L') {
-        exito = procesarCarga(payload);
-    } else if (prefijo == 'M') {
-        exito = procesarMapa(payload);
-    } else {
+    Contador contador = Contador::TramasCarga;
+    switch (trama.error) {
+    case ErrorTrama::Ninguno:
+        // Sobrecarga resuelta en compilación: cada tipo de trama tiene su propio procesar().
+        switch (trama.tipo) {
+        case TipoTrama::Carga:
+            exito = procesar(TramaLoad(trama.dato));
+            break;
+        case TipoTrama::Lote:
+            exito = procesar(TramaLote(trama.lote, trama.longitudLote));
+            contador = Contador::TramasLote;
+            break;
+        case TipoTrama::Mapa:
+            exito = procesar(TramaMap(trama.desplazamiento));
+            contador = Contador::TramasMapa;
+            break;
+        default:
+            // Un tipo nuevo sin su caso aquí se descarta a la vista en lugar de aplicarse como otro.
+            contar(Contador::InvalidasSinManejador);
+            log("WARNING", "Tipo de trama sin manejador.");
+            break;
+        }
+        break;
+    case ErrorTrama::Incompleta:
+        contar(Contador::InvalidasIncompleta);
+        log("WARNING", "Trama incompleta recibida.");
+        break;
+    case ErrorTrama::PrefijoDesconocido:
+        contar(Contador::InvalidasPrefijo);
         log("WARNING", "Prefijo de trama desconocido.");
+        break;
+    case ErrorTrama::TokenInvalido:
+        contar(Contador::InvalidasToken);
+        if (_carga && _rotor) {
+            log("WARNING", "Token de carga inválido.");
+        } else {
+            log("WARNING", "Componentes no configurados para procesar LOAD.");
+        }
+        break;
+    case ErrorTrama::RotacionInvalida:
+        contar(Contador::InvalidasRotacion);
+        if (_rotor) {
+            log("WARNING", "Valor de rotación inválido.");
+        } else {
+            log("WARNING", "Rotor no configurado para procesar MAP.");
+        }
+        break;
+    case ErrorTrama::Desbordada:
+    case ErrorTrama::CanalInvalido:
+        break;
     }
 
     if (exito) {
         ++_procesadas;
+        contar(contador);
     }
 }
 
-bool LineaDispatcher::procesarCarga(char* payload)
+void LineaDispatcher::revisarDesborde()
 {
-    if (!_carga || !_rotor) {
-        log("WARNING", "Componentes no configurados para procesar LOAD.");
-        return false;
+    const std::size_t fallos = _carga->tomarFallosDesborde();
+    if (fallos == 0) {
+        return;
     }
+    if (_contadores) {
+        _contadores->sumar(Contador::DesbordesFallidos, fallos);
+    }
+    log("WARNING", "No se pudo pasar a disco el inicio de la sesión; el mensaje supera --limite-lista en memoria.");
+}
 
-    bool valido = false;
-    const char dato = interpretarTokenCarga(payload, valido);
-    if (!valido) {
-        log("WARNING", "Token de carga inválido.");
+bool LineaDispatcher::procesar(const TramaLoad& trama)
+{
+    if (!_carga || !_rotor) {
+        log("WARNING", "Componentes no configurados para procesar LOAD.");
         return false;
     }
 
-    const char decodificado = _rotor->getMapeo(dato);
-
-    TramaLoad trama(dato);
-    trama.procesar(_carga, _rotor);
-
-    char origen[32];
-    char destino[32];
-    describirCaracter(dato, origen, sizeof(origen));
-    describirCaracter(decodificado, destino, sizeof(destino));
+    const char decodificado = trama.aplicar(*_carga, *_rotor);
+    _mensajeAbierto = true;
+    revisarDesborde();
+    PRT7_INSTRUMENTAR(_instrumentacion, marcar(EtapaTrama::Insercion));
 
-    char detalle[192];
-    std::snprintf(detalle, sizeof(detalle), " -> Procesando... -> Fragmento %s decodificado como %s.", origen, destino);
-    log("STATUS", detalle);
+    char nuevos[32];
+    const std::size_t cantidadNuevos = !_canales ? entregarPendiente(nuevos, sizeof(nuevos)) : 0;
+    PRT7_INSTRUMENTAR(_instrumentacion, marcar(EtapaTrama::Salida));
 
-    char ensamblado[768];
-    if (_carga) {
-        _carga->copiarMensaje(ensamblado, sizeof(ensamblado));
-    } else {
-        ensamblado[0] = '\0';
+    if (_logger && _logger->habilitado(NivelLog::Detalle)) {
+        _logger->registrar(NivelLog::Detalle, "STATUS", formatearFragmento, trama.dato(), decodificado);
+        _logger->registrar(NivelLog::Detalle, "STATUS", formatearAvanceMensaje, static_cast<long>(_carga->tamano()), 0, 0,
+                           nuevos, cantidadNuevos);
+        registrarSaltoLinea();
     }
 
-    char mensaje[800];
-    std::snprintf(mensaje, sizeof(mensaje), " Mensaje: %s", ensamblado);
-    log("STATUS", mensaje);
-    registrarSaltoLinea();
-
     return true;
 }
 
-bool LineaDispatcher::procesarMapa(char* payload)
+bool LineaDispatcher::procesar(const TramaLote& trama)
 {
-    if (!_rotor) {
-        log("WARNING", "Rotor no configurado para procesar MAP.");
+    if (!_carga || !_rotor) {
+        log("WARNING", "Componentes no configurados para procesar LOAD.");
         return false;
     }
 
-    char* fin = nullptr;
-    const long desplazamiento = std::strtol(payload, &fin, 10);
-    if (fin == payload) {
-        log("WARNING", "Valor de rotación inválido.");
-        return false;
+    trama.aplicar(*_carga, *_rotor);
+    _mensajeAbierto = true;
+    revisarDesborde();
+    PRT7_INSTRUMENTAR(_instrumentacion, marcar(EtapaTrama::Insercion));
+
+    char nuevos[AnalizadorTramas::kMaxLote + 1];
+    std::size_t cantidadNuevos = 0;
+    while (!_canales && (cantidadNuevos = entregarPendiente(nuevos, sizeof(nuevos))) > 0) {
+        if (_logger && _logger->habilitado(NivelLog::Detalle)) {
+            _logger->registrar(NivelLog::Detalle, "STATUS", formatearAvanceMensaje, static_cast<long>(_carga->tamano()),
+                               0, 0, nuevos, cantidadNuevos);
+        }
     }
+    PRT7_INSTRUMENTAR(_instrumentacion, marcar(EtapaTrama::Salida));
 
-    TramaMap trama(static_cast<int>(desplazamiento));
-    trama.procesar(nullptr, _rotor);
-
-    const int desplazamientoInt = static_cast<int>(desplazamiento);
-    const char signo = (desplazamientoInt >= 0) ? '+' : '-';
-    const int magnitud = (desplazamientoInt >= 0) ? desplazamientoInt : -desplazamientoInt;
-    const char mapeo = _rotor->getMapeo('A');
-
-    char mensaje[192];
-    std::snprintf(mensaje, sizeof(mensaje), " -> Procesando... -> ROTANDO ROTOR %c%d. (Ahora 'A' se mapea a '%c')",
-                  signo, magnitud, mapeo);
-    log("STATUS", mensaje);
-    registrarSaltoLinea();
+    if (_logger && _logger->habilitado(NivelLog::Detalle)) {
+        registrarSaltoLinea();
+    }
 
     return true;
 }
 
-char LineaDispatcher::interpretarTokenCarga(const char* payload, bool& valido)
+bool LineaDispatcher::procesar(const TramaMap& trama)
 {
-    valido = false;
-    if (!payload) {
-        return '\0';
-    }
-
-    if (payload[0] == '\'' && payload[2] == '\'' && payload[3] == '\0') {
-        valido = true;
-        return payload[1];
+    if (!_rotor) {
+        log("WARNING", "Rotor no configurado para procesar MAP.");
+        return false;
     }
 
-    const std::size_t longitud = std::strlen(payload);
-    if (longitud == 1) {
-        valido = true;
-        return payload[0];
-    }
+    const int posicion = trama.aplicar(*_rotor);
+    PRT7_INSTRUMENTAR(_instrumentacion, marcar(EtapaTrama::Mapeo));
 
-    if (std::strcmp(payload, "Space") == 0 || std::strcmp(payload, "SPACE") == 0) {
-        valido = true;
-        return ' ';
+    if (_logger && _logger->habilitado(NivelLog::Detalle)) {
+        _logger->registrar(NivelLog::Detalle, "STATUS", formatearRotacion, trama.desplazamiento(), 'A' + posicion);
+        registrarSaltoLinea();
     }
 
-    if (std::strcmp(payload, "Tab") == 0 || std::strcmp(payload, "TAB") == 0) {
-        valido = true;
-        return '\t';
-    }
+    return true;
+}
 
-    if (std::strcmp(payload, "Comma") == 0 || std::strcmp(payload, "COMMA") == 0) {
-        valido = true;
-        return ',';
+void LineaDispatcher::contar(Contador contador) noexcept
+{
+    if (_contadores) {
+        _contadores->sumar(contador);
     }
-
-    return '\0';
 }
 
 void LineaDispatcher::log(const char* tipo, const char* mensaje) const
@@ -260,33 +762,9 @@ void LineaDispatcher::log(const char* tipo, const char* mensaje) const
     }
 }
 
-void LineaDispatcher::describirCaracter(char caracter, char* destino, std::size_t tam)
-{
-    if (!destino || tam == 0) {
-        return;
-    }
-
-    if (caracter == '\t') {
-        std::snprintf(destino, tam, "'\\t'");
-        return;
-    }
-    if (caracter == '\n') {
-        std::snprintf(destino, tam, "'\\n'");
-        return;
-    }
-    if (caracter == '\r') {
-        std::snprintf(destino, tam, "'\\r'");
-        return;
-    }
-
-    if (std::isprint(static_cast<unsigned char>(caracter)) || caracter == ' ') {
-        std::snprintf(destino, tam, "'%c'", caracter);
-    } else {
-        std::snprintf(destino, tam, "0x%02X", static_cast<unsigned int>(static_cast<unsigned char>(caracter)));
-    }
-}
-
 void LineaDispatcher::registrarSaltoLinea() const
 {
-    std::cout << '\n';
+    if (_logger) {
+        _logger->imprimirCrudo(NivelLog::Detalle, "");
+    }
 }
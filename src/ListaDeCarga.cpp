@@ -2,19 +2,121 @@
 
 #include "AuxiliarCli.h"
 
+#include <cerrno>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
-ListaDeCarga::ListaDeCarga() noexcept : _cabeza(nullptr), _cola(nullptr), _cantidad(0) {}
+namespace {
+
+void entregarAlLog(void* contexto, const char* datos, std::size_t longitud)
+{
+    static_cast<AuxiliarCli*>(contexto)->escribirLogLargo(datos, longitud);
+}
+
+void entregarASalidaEstandar(void*, const char* datos, std::size_t longitud)
+{
+    std::fwrite(datos, 1, longitud, stdout);
+}
+
+} // namespace
+
+std::size_t ListaDeCarga::_limitePorDefecto = 0;
+const char* ListaDeCarga::_directorioPorDefecto = nullptr;
+
+ListaDeCarga::ListaDeCarga() noexcept
+    : _cabeza(nullptr)
+    , _cola(nullptr)
+    , _cantidad(0)
+    , _ultimoEntregado(nullptr)
+    , _entregados(0)
+    , _primerBloque(nullptr)
+    , _bloqueActual(nullptr)
+    , _usadosEnBloque(0)
+    , _bloquesEnUso(0)
+    , _limiteBloques(0)
+    , _directorio(nullptr)
+    , _fdDesborde(-1)
+    , _segmento(nullptr)
+    , _inicioSegmento(0)
+    , _tamanoArchivo(0)
+    , _desbordados(0)
+    , _bloquesHastaReintento(0)
+    , _fallosDesborde(0)
+{
+    setDesborde(_limitePorDefecto, _directorioPorDefecto);
+}
 
 ListaDeCarga::~ListaDeCarga()
 {
-    limpiar();
+    cerrarDesborde();
+    Bloque* actual = _primerBloque;
+    while (actual) {
+        Bloque* siguiente = actual->siguiente;
+        delete actual;
+        actual = siguiente;
+    }
+    _primerBloque = nullptr;
+    _bloqueActual = nullptr;
+}
+
+ListaDeCarga::Nodo* ListaDeCarga::reservarNodos(std::size_t& cantidad)
+{
+    if (!_bloqueActual) {
+        if (!_primerBloque) {
+            _primerBloque = new Bloque;
+            _primerBloque->siguiente = nullptr;
+        }
+        _bloqueActual = _primerBloque;
+        _usadosEnBloque = 0;
+        _bloquesEnUso = 1;
+    } else if (_usadosEnBloque == kNodosPorBloque) {
+        // En el límite, el bloque más antiguo pasa a disco y queda libre al final de la cadena.
+        // Tras un fallo se reintenta más adelante y, si funciona, se recupera todo el exceso.
+        if (_limiteBloques > 0 && _bloquesEnUso >= _limiteBloques) {
+            if (_bloquesHastaReintento > 0) {
+                --_bloquesHastaReintento;
+            } else {
+                bool desbordado = desbordarBloque();
+                while (desbordado && _bloquesEnUso >= _limiteBloques) {
+                    desbordado = desbordarBloque();
+                }
+                if (!desbordado) {
+                    ++_fallosDesborde;
+                    _bloquesHastaReintento = kBloquesEntreReintentos;
+                }
+            }
+        }
+        if (!_bloqueActual->siguiente) {
+            Bloque* nuevo = new Bloque;
+            nuevo->siguiente = nullptr;
+            _bloqueActual->siguiente = nuevo;
+        }
+        _bloqueActual = _bloqueActual->siguiente;
+        _usadosEnBloque = 0;
+        ++_bloquesEnUso;
+    }
+
+    // Solo se entregan nodos contiguos del bloque actual; el resto se pide en otra llamada.
+    const std::size_t libres = kNodosPorBloque - _usadosEnBloque;
+    if (cantidad > libres) {
+        cantidad = libres;
+    }
+    Nodo* tramo = &_bloqueActual->nodos[_usadosEnBloque];
+    _usadosEnBloque += cantidad;
+    return tramo;
 }
 
 void ListaDeCarga::insertarAlFinal(char dato)
 {
-    Nodo* nuevo = new Nodo{dato, _cola, nullptr};
+    std::size_t cantidad = 1;
+    Nodo* nuevo = reservarNodos(cantidad);
+    nuevo->dato = dato;
+    nuevo->previo = _cola;
+    nuevo->siguiente = nullptr;
     if (_cola) {
         _cola->siguiente = nuevo;
     } else {
@@ -24,17 +126,200 @@ void ListaDeCarga::insertarAlFinal(char dato)
     ++_cantidad;
 }
 
-void ListaDeCarga::limpiar() noexcept
+void ListaDeCarga::insertarVarios(const char* datos, std::size_t cantidad)
 {
-    Nodo* actual = _cabeza;
-    while (actual) {
-        Nodo* siguiente = actual->siguiente;
-        delete actual;
-        actual = siguiente;
+    if (!datos) {
+        return;
+    }
+
+    while (cantidad > 0) {
+        std::size_t tramo = cantidad;
+        Nodo* nodos = reservarNodos(tramo);
+
+        Nodo* previo = _cola;
+        for (std::size_t i = 0; i < tramo; ++i) {
+            nodos[i].dato = datos[i];
+            nodos[i].previo = previo;
+            nodos[i].siguiente = &nodos[i] + 1;
+            previo = &nodos[i];
+        }
+        nodos[tramo - 1].siguiente = nullptr;
+
+        if (_cola) {
+            _cola->siguiente = nodos;
+        } else {
+            _cabeza = nodos;
+        }
+        _cola = &nodos[tramo - 1];
+        _cantidad += tramo;
+
+        datos += tramo;
+        cantidad -= tramo;
     }
+}
+
+void ListaDeCarga::limpiar() noexcept
+{
+    _bloqueActual = nullptr;
+    _usadosEnBloque = 0;
     _cabeza = nullptr;
     _cola = nullptr;
     _cantidad = 0;
+    _ultimoEntregado = nullptr;
+    _entregados = 0;
+    _bloquesEnUso = 0;
+    _bloquesHastaReintento = 0;
+    // El archivo conserva su tamaño: la siguiente sesión lo sobrescribe desde el principio.
+    _desbordados = 0;
+}
+
+void ListaDeCarga::setDesborde(std::size_t limiteResidente, const char* directorio) noexcept
+{
+    _directorio = directorio;
+    _limiteBloques = limiteResidente / sizeof(Bloque);
+    if (limiteResidente > 0 && _limiteBloques < 2) {
+        _limiteBloques = 2;
+    }
+}
+
+void ListaDeCarga::setDesbordePorDefecto(std::size_t limiteResidente, const char* directorio) noexcept
+{
+    _limitePorDefecto = limiteResidente;
+    _directorioPorDefecto = directorio;
+}
+
+std::size_t ListaDeCarga::desbordados() const noexcept
+{
+    return _desbordados;
+}
+
+std::size_t ListaDeCarga::tomarFallosDesborde() noexcept
+{
+    const std::size_t fallos = _fallosDesborde;
+    _fallosDesborde = 0;
+    return fallos;
+}
+
+bool ListaDeCarga::desbordarBloque() noexcept
+{
+    Bloque* antiguo = _primerBloque;
+    if (!antiguo || antiguo == _bloqueActual) {
+        return false;
+    }
+
+    if (_fdDesborde < 0) {
+        const char* directorio = _directorio;
+        if (!directorio || directorio[0] == '\0') {
+            directorio = std::getenv("TMPDIR");
+        }
+        if (!directorio || directorio[0] == '\0') {
+            directorio = "/tmp";
+        }
+        char plantilla[4096];
+        const int longitud = std::snprintf(plantilla, sizeof(plantilla), "%s/prt7-lista-XXXXXX", directorio);
+        if (longitud < 0 || static_cast<std::size_t>(longitud) >= sizeof(plantilla)) {
+            return false;
+        }
+        _fdDesborde = ::mkostemp(plantilla, O_CLOEXEC);
+        if (_fdDesborde < 0) {
+            return false;
+        }
+        ::unlink(plantilla);
+    }
+
+    if (!_segmento || _desbordados < _inicioSegmento || _desbordados >= _inicioSegmento + kSegmentoDesborde) {
+        if (!proyectarSegmento(_desbordados)) {
+            return false;
+        }
+    }
+    char* destino = _segmento + (_desbordados - _inicioSegmento);
+    for (std::size_t i = 0; i < kNodosPorBloque; ++i) {
+        destino[i] = antiguo->nodos[i].dato;
+    }
+    _desbordados += kNodosPorBloque;
+
+    // Los nodos se reservan en orden: el bloque más antiguo es siempre el principio del mensaje.
+    if (_entregados <= _desbordados) {
+        _ultimoEntregado = nullptr;
+    }
+    _primerBloque = antiguo->siguiente;
+    _cabeza = &_primerBloque->nodos[0];
+    _cabeza->previo = nullptr;
+
+    Bloque* ultimo = _bloqueActual;
+    while (ultimo->siguiente) {
+        ultimo = ultimo->siguiente;
+    }
+    ultimo->siguiente = antiguo;
+    antiguo->siguiente = nullptr;
+    --_bloquesEnUso;
+    return true;
+}
+
+bool ListaDeCarga::proyectarSegmento(std::size_t desplazamiento) noexcept
+{
+    const std::size_t inicio = desplazamiento / kSegmentoDesborde * kSegmentoDesborde;
+    const std::size_t fin = inicio + kSegmentoDesborde;
+    // Se reserva el espacio antes de proyectar: escribir en una página sin respaldo en disco daría SIGBUS.
+    if (_tamanoArchivo < fin) {
+        if (::posix_fallocate(_fdDesborde, static_cast<off_t>(_tamanoArchivo),
+                              static_cast<off_t>(fin - _tamanoArchivo)) != 0) {
+            return false;
+        }
+        _tamanoArchivo = fin;
+    }
+
+    // El segmento anterior se suelta: sus páginas quedan en el archivo y dejan de contar como memoria propia.
+    if (_segmento) {
+        ::munmap(_segmento, kSegmentoDesborde);
+        _segmento = nullptr;
+    }
+    void* mapa = ::mmap(nullptr, kSegmentoDesborde, PROT_READ | PROT_WRITE, MAP_SHARED, _fdDesborde,
+                        static_cast<off_t>(inicio));
+    if (mapa == MAP_FAILED) {
+        return false;
+    }
+    _segmento = static_cast<char*>(mapa);
+    _inicioSegmento = inicio;
+    return true;
+}
+
+std::size_t ListaDeCarga::leerDesbordado(std::size_t desde, char* destino, std::size_t cantidad) const noexcept
+{
+    if (desde >= _desbordados) {
+        return 0;
+    }
+    if (cantidad > _desbordados - desde) {
+        cantidad = _desbordados - desde;
+    }
+
+    // La proyección es MAP_SHARED: pread() ve lo escrito en ella aunque no se haya sincronizado.
+    std::size_t leidos = 0;
+    while (leidos < cantidad) {
+        const ssize_t n = ::pread(_fdDesborde, destino + leidos, cantidad - leidos, static_cast<off_t>(desde + leidos));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        leidos += static_cast<std::size_t>(n);
+    }
+    return leidos;
+}
+
+void ListaDeCarga::cerrarDesborde() noexcept
+{
+    if (_segmento) {
+        ::munmap(_segmento, kSegmentoDesborde);
+        _segmento = nullptr;
+    }
+    if (_fdDesborde >= 0) {
+        ::close(_fdDesborde);
+        _fdDesborde = -1;
+    }
+    _tamanoArchivo = 0;
+    _desbordados = 0;
 }
 
 bool ListaDeCarga::estaVacia() const noexcept
@@ -48,8 +333,8 @@ void ListaDeCarga::copiarMensaje(char* destino, std::size_t capacidad) const
         return;
     }
 
-    std::size_t usado = 0;
-    Nodo* actual = _cabeza;
+    std::size_t usado = leerDesbordado(0, destino, capacidad - 1);
+    Nodo* actual = (usado == _desbordados) ? _cabeza : nullptr;
     while (actual && usado + 1 < capacidad) {
         destino[usado++] = actual->dato;
         actual = actual->siguiente;
@@ -57,34 +342,95 @@ void ListaDeCarga::copiarMensaje(char* destino, std::size_t capacidad) const
     destino[usado] = '\0';
 }
 
-void ListaDeCarga::imprimirMensaje(AuxiliarCli* logger) const
+void ListaDeCarga::recorrerMensaje(EntregaDatos entrega, void* contexto) const
 {
-    const std::size_t longitud = _cantidad + 1;
-    char bufferPequeno[256];
-    char* destino = bufferPequeno;
-
-    if (longitud > sizeof(bufferPequeno)) {
-        destino = new char[longitud];
+    if (!entrega) {
+        return;
     }
 
-    copiarMensaje(destino, longitud);
+    char tramo[4096];
+    for (std::size_t desde = 0; desde < _desbordados;) {
+        const std::size_t leidos = leerDesbordado(desde, tramo, sizeof(tramo));
+        if (leidos == 0) {
+            return;
+        }
+        entrega(contexto, tramo, leidos);
+        desde += leidos;
+    }
 
-    if (logger) {
-        if (destino[0] == '\0') {
-            logger->imprimirLog("WARNING", "No se ensamblaron datos.");
-        } else {
-            logger->imprimirLog("STATUS", destino);
+    std::size_t usado = 0;
+    for (const Nodo* actual = _cabeza; actual; actual = actual->siguiente) {
+        tramo[usado++] = actual->dato;
+        if (usado == sizeof(tramo)) {
+            entrega(contexto, tramo, usado);
+            usado = 0;
         }
-    } else {
-        if (destino[0] == '\0') {
-            std::puts("Mensaje ensamblado: <vacio>");
+    }
+    if (usado > 0) {
+        entrega(contexto, tramo, usado);
+    }
+}
+
+std::size_t ListaDeCarga::extraerPendiente(char* destino, std::size_t capacidad)
+{
+    if (!destino || capacidad == 0) {
+        return 0;
+    }
+
+    // Lo pendiente que ya pasó a disco sale primero; los nodos siguen donde termina el archivo.
+    std::size_t usado = leerDesbordado(_entregados, destino, capacidad - 1);
+    _entregados += usado;
+    Nodo* actual = nullptr;
+    if (_entregados >= _desbordados) {
+        actual = _ultimoEntregado ? _ultimoEntregado->siguiente : _cabeza;
+    }
+    std::size_t deNodos = 0;
+    while (actual && usado + 1 < capacidad) {
+        destino[usado++] = actual->dato;
+        _ultimoEntregado = actual;
+        actual = actual->siguiente;
+        ++deNodos;
+    }
+    destino[usado] = '\0';
+    _entregados += deNodos;
+    return usado;
+}
+
+std::size_t ListaDeCarga::pendientes() const noexcept
+{
+    return _cantidad - _entregados;
+}
+
+void ListaDeCarga::imprimirMensaje(AuxiliarCli* logger) const
+{
+    char bufferPequeno[256];
+    if (_cantidad < sizeof(bufferPequeno)) {
+        copiarMensaje(bufferPequeno, sizeof(bufferPequeno));
+        if (logger) {
+            if (bufferPequeno[0] == '\0') {
+                logger->imprimirLog("WARNING", "No se ensamblaron datos.");
+            } else {
+                logger->imprimirLog("STATUS", bufferPequeno);
+            }
         } else {
-            std::puts(destino);
+            if (bufferPequeno[0] == '\0') {
+                std::puts("Mensaje ensamblado: <vacio>");
+            } else {
+                std::puts(bufferPequeno);
+            }
         }
+        return;
     }
 
-    if (destino != bufferPequeno) {
-        delete[] destino;
+    // Un mensaje largo sale por tramos: reunirlo anularía el límite de memoria del desborde.
+    if (logger) {
+        if (logger->iniciarLogLargo("STATUS")) {
+            recorrerMensaje(entregarAlLog, logger);
+            logger->terminarLogLargo();
+        }
+    } else {
+        recorrerMensaje(entregarASalidaEstandar, nullptr);
+        std::putchar('\n');
     }
 }
 
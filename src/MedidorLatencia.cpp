@@ -0,0 +1,81 @@
+#include "MedidorLatencia.h"
+
+#include <ctime>
+
+MedidorLatencia::MedidorLatencia() noexcept
+{
+    reiniciar();
+}
+
+void MedidorLatencia::reiniciar() noexcept
+{
+    _histograma.reiniciar();
+    _tramas = 0;
+    _primeraNs = 0;
+    _ultimaNs = 0;
+    _marcasAdelantadas = 0;
+}
+
+void MedidorLatencia::contarTrama() noexcept
+{
+    const std::uint64_t ahora = ahoraNs();
+    if (_tramas == 0) {
+        _primeraNs = ahora;
+    }
+    _ultimaNs = ahora;
+    ++_tramas;
+}
+
+void MedidorLatencia::registrarMarca(std::uint64_t enviadoNs) noexcept
+{
+    const std::uint64_t ahora = ahoraNs();
+    if (enviadoNs > ahora) {
+        // Marca de otro equipo o de un reloj distinto: no se puede comparar.
+        ++_marcasAdelantadas;
+        return;
+    }
+    _histograma.registrar(ahora - enviadoNs);
+}
+
+const HistogramaLatencia& MedidorLatencia::histograma() const noexcept
+{
+    return _histograma;
+}
+
+double MedidorLatencia::tramasPorSegundo() const noexcept
+{
+    if (_tramas < 2 || _ultimaNs <= _primeraNs) {
+        return 0.0;
+    }
+    return static_cast<double>(_tramas - 1) * 1e9 / static_cast<double>(_ultimaNs - _primeraNs);
+}
+
+void MedidorLatencia::imprimirReporte(std::FILE* destino) const
+{
+    const double segundos = (_ultimaNs > _primeraNs) ? (_ultimaNs - _primeraNs) / 1e9 : 0.0;
+    std::fprintf(destino, "Tramas: %llu en %.3f s (%.0f tramas/s sostenidas)\n",
+                 static_cast<unsigned long long>(_tramas), segundos, tramasPorSegundo());
+
+    if (_histograma.cantidad() == 0) {
+        std::fprintf(destino, "Sin marcas T,<ns>: no hay datos de latencia.\n");
+        return;
+    }
+    std::fprintf(destino,
+                 "Latencia (us) sobre %llu marcas: min %.1f  p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f  "
+                 "prom %.1f\n",
+                 static_cast<unsigned long long>(_histograma.cantidad()), _histograma.minimo() / 1e3,
+                 _histograma.percentil(0.50) / 1e3, _histograma.percentil(0.90) / 1e3,
+                 _histograma.percentil(0.99) / 1e3, _histograma.percentil(0.999) / 1e3, _histograma.maximo() / 1e3,
+                 _histograma.promedio() / 1e3);
+    if (_marcasAdelantadas > 0) {
+        std::fprintf(destino, "Marcas ignoradas por venir de un reloj adelantado: %llu\n",
+                     static_cast<unsigned long long>(_marcasAdelantadas));
+    }
+}
+
+std::uint64_t MedidorLatencia::ahoraNs() noexcept
+{
+    timespec ahora {};
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return static_cast<std::uint64_t>(ahora.tv_sec) * 1000000000u + static_cast<std::uint64_t>(ahora.tv_nsec);
+}
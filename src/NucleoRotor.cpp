@@ -0,0 +1,175 @@
+#include "NucleoRotor.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PRT7_NUCLEO_X86 1
+#include <immintrin.h>
+#else
+#define PRT7_NUCLEO_X86 0
+#endif
+
+namespace {
+
+const int kLetras = 26;
+
+using FuncionNucleo = void (*)(const char*, char*, std::size_t, int);
+
+void decodificarEscalar(const char* entrada, char* salida, std::size_t cantidad, int desplazamiento) noexcept
+{
+    for (std::size_t i = 0; i < cantidad; ++i) {
+        const unsigned char c = static_cast<unsigned char>(entrada[i]);
+        if (static_cast<unsigned>(c - 'A') < static_cast<unsigned>(kLetras)) {
+            int t = c + desplazamiento;
+            if (t > 'Z') {
+                t -= kLetras;
+            }
+            salida[i] = static_cast<char>(t);
+        } else {
+            salida[i] = static_cast<char>(c);
+        }
+    }
+}
+
+#if PRT7_NUCLEO_X86
+
+// Por carril: letra = 'A' <= v <= 'Z' (comparación con signo, así los bytes >= 0x80
+// quedan fuera); t = v + d, menos 26 si pasó de 'Z'; resultado = letra ? t : v.
+
+__attribute__((target("sse2"))) void decodificarSse2(const char* entrada, char* salida, std::size_t cantidad,
+                                                     int desplazamiento) noexcept
+{
+    const __m128i antesDeA = _mm_set1_epi8('A' - 1);
+    const __m128i despuesDeZ = _mm_set1_epi8('Z' + 1);
+    const __m128i ultima = _mm_set1_epi8('Z');
+    const __m128i vuelta = _mm_set1_epi8(kLetras);
+    const __m128i suma = _mm_set1_epi8(static_cast<char>(desplazamiento));
+
+    std::size_t i = 0;
+    for (; i + 16 <= cantidad; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(entrada + i));
+        const __m128i letra = _mm_and_si128(_mm_cmpgt_epi8(v, antesDeA), _mm_cmplt_epi8(v, despuesDeZ));
+        __m128i t = _mm_add_epi8(v, suma);
+        t = _mm_sub_epi8(t, _mm_and_si128(_mm_cmpgt_epi8(t, ultima), vuelta));
+        const __m128i r = _mm_or_si128(_mm_and_si128(letra, t), _mm_andnot_si128(letra, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i), r);
+    }
+    decodificarEscalar(entrada + i, salida + i, cantidad - i, desplazamiento);
+}
+
+__attribute__((target("avx2"))) void decodificarAvx2(const char* entrada, char* salida, std::size_t cantidad,
+                                                     int desplazamiento) noexcept
+{
+    const __m256i antesDeA = _mm256_set1_epi8('A' - 1);
+    const __m256i ultima = _mm256_set1_epi8('Z');
+    const __m256i vuelta = _mm256_set1_epi8(kLetras);
+    const __m256i suma = _mm256_set1_epi8(static_cast<char>(desplazamiento));
+
+    std::size_t i = 0;
+    for (; i + 32 <= cantidad; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(entrada + i));
+        // AVX2 no tiene cmplt: "no mayor que 'Z'" con andnot, y la mezcla en una sola instrucción.
+        const __m256i letra = _mm256_andnot_si256(_mm256_cmpgt_epi8(v, ultima), _mm256_cmpgt_epi8(v, antesDeA));
+        __m256i t = _mm256_add_epi8(v, suma);
+        t = _mm256_sub_epi8(t, _mm256_and_si256(_mm256_cmpgt_epi8(t, ultima), vuelta));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i), _mm256_blendv_epi8(v, t, letra));
+    }
+    // Los menos de 32 restantes aprovechan todavía un paso de 16 bytes.
+    decodificarSse2(entrada + i, salida + i, cantidad - i, desplazamiento);
+}
+
+#endif
+
+ImplementacionNucleo detectar() noexcept
+{
+#if PRT7_NUCLEO_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ImplementacionNucleo::Avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return ImplementacionNucleo::Sse2;
+    }
+#endif
+    return ImplementacionNucleo::Escalar;
+}
+
+FuncionNucleo funcion(ImplementacionNucleo implementacion) noexcept
+{
+#if PRT7_NUCLEO_X86
+    if (implementacion == ImplementacionNucleo::Avx2) {
+        return decodificarAvx2;
+    }
+    if (implementacion == ImplementacionNucleo::Sse2) {
+        return decodificarSse2;
+    }
+#else
+    (void)implementacion;
+#endif
+    return decodificarEscalar;
+}
+
+/**
+ * @brief Variante y función elegidas una sola vez, al primer uso.
+ */
+struct Seleccion {
+    ImplementacionNucleo implementacion;
+    FuncionNucleo funcion;
+
+    Seleccion() noexcept : implementacion(detectar()), funcion(::funcion(implementacion)) {}
+};
+
+const Seleccion& seleccion() noexcept
+{
+    static const Seleccion elegida;
+    return elegida;
+}
+
+} // namespace
+
+namespace NucleoRotor {
+
+void decodificar(const char* entrada, char* salida, std::size_t cantidad, int desplazamiento) noexcept
+{
+    seleccion().funcion(entrada, salida, cantidad, desplazamiento);
+}
+
+void decodificarCon(ImplementacionNucleo implementacion, const char* entrada, char* salida, std::size_t cantidad,
+                    int desplazamiento) noexcept
+{
+    if (!disponible(implementacion)) {
+        implementacion = ImplementacionNucleo::Escalar;
+    }
+    funcion(implementacion)(entrada, salida, cantidad, desplazamiento);
+}
+
+bool disponible(ImplementacionNucleo implementacion) noexcept
+{
+    switch (implementacion) {
+    case ImplementacionNucleo::Escalar:
+        return true;
+    case ImplementacionNucleo::Sse2:
+        return seleccion().implementacion != ImplementacionNucleo::Escalar;
+    case ImplementacionNucleo::Avx2:
+        return seleccion().implementacion == ImplementacionNucleo::Avx2;
+    }
+    return false;
+}
+
+ImplementacionNucleo activa() noexcept
+{
+    return seleccion().implementacion;
+}
+
+const char* nombre(ImplementacionNucleo implementacion) noexcept
+{
+    switch (implementacion) {
+    case ImplementacionNucleo::Escalar:
+        return "escalar";
+    case ImplementacionNucleo::Sse2:
+        return "sse2";
+    case ImplementacionNucleo::Avx2:
+        return "avx2";
+    }
+    return "desconocida";
+}
+
+} // namespace NucleoRotor
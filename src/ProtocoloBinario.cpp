@@ -0,0 +1,81 @@
+#include "ProtocoloBinario.h"
+
+namespace ProtocoloBinario {
+
+namespace {
+
+struct TablaCrc {
+    std::uint16_t valores[256];
+};
+
+constexpr TablaCrc construirTabla()
+{
+    TablaCrc tabla {};
+    for (unsigned i = 0; i < 256; ++i) {
+        std::uint16_t crc = static_cast<std::uint16_t>(i << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = static_cast<std::uint16_t>((crc & 0x8000u) ? (crc << 1) ^ 0x1021u : crc << 1);
+        }
+        tabla.valores[i] = crc;
+    }
+    return tabla;
+}
+
+// Se calcula en compilación: un byte por consulta en lugar de ocho desplazamientos.
+constexpr TablaCrc kTablaCrc = construirTabla();
+
+} // namespace
+
+std::uint16_t crc16(const unsigned char* datos, std::size_t cantidad, std::uint16_t crc) noexcept
+{
+    for (std::size_t i = 0; i < cantidad; ++i) {
+        crc = static_cast<std::uint16_t>((crc << 8) ^ kTablaCrc.valores[((crc >> 8) ^ datos[i]) & 0xFFu]);
+    }
+    return crc;
+}
+
+std::size_t escribirVarint(std::uint64_t valor, unsigned char* destino) noexcept
+{
+    std::size_t escritos = 0;
+    while (valor >= 0x80u) {
+        destino[escritos++] = static_cast<unsigned char>(valor | 0x80u);
+        valor >>= 7;
+    }
+    destino[escritos++] = static_cast<unsigned char>(valor);
+    return escritos;
+}
+
+std::size_t leerVarint(const unsigned char* datos, std::size_t cantidad, std::uint64_t& valor) noexcept
+{
+    valor = 0;
+    for (std::size_t i = 0; i < cantidad && i < kMaxVarint; ++i) {
+        // El décimo byte solo aporta el bit 63; cualquier otro bit excede 64 bits.
+        if (i == kMaxVarint - 1 && (datos[i] & 0x7Eu) != 0) {
+            return 0;
+        }
+        valor |= static_cast<std::uint64_t>(datos[i] & 0x7Fu) << (7 * i);
+        if ((datos[i] & 0x80u) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+bool esMarcador(const char* linea, std::size_t longitud) noexcept
+{
+    if (!linea || longitud != kLongitudMarcador) {
+        return false;
+    }
+    for (std::size_t i = 0; i < longitud; ++i) {
+        char c = linea[i];
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        if (c != kMarcador[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace ProtocoloBinario
@@ -0,0 +1,170 @@
+#include "RegistroContadores.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Descripción de un contador: familia, etiquetas y ayuda.
+ */
+struct DescripcionContador {
+    const char* familia;
+    const char* etiquetas;
+    const char* ayuda;
+};
+
+const DescripcionContador kDescripciones[RegistroContadores::kContadores] = {
+    {"prt7_bytes_leidos_total", "", "Bytes recibidos del puerto, de una captura o de un archivo."},
+    {"prt7_lecturas_total", "", "Bloques de bytes entregados al decodificador."},
+    {"prt7_errores_lectura_total", "", "Fallos de lectura de la entrada."},
+    {"prt7_desconexiones_total", "", "Desconexiones detectadas en el puerto."},
+    {"prt7_tramas_total", "tipo=\"inicio\"", "Tramas reconocidas por tipo."},
+    {"prt7_tramas_total", "tipo=\"carga\"", nullptr},
+    {"prt7_tramas_total", "tipo=\"mapa\"", nullptr},
+    {"prt7_tramas_total", "tipo=\"marca\"", nullptr},
+    {"prt7_tramas_total", "tipo=\"lote\"", nullptr},
+    {"prt7_tramas_total", "tipo=\"fin\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"desbordada\"", "Tramas descartadas por motivo."},
+    {"prt7_tramas_invalidas_total", "motivo=\"incompleta\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"prefijo_desconocido\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"token_invalido\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"rotacion_invalida\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"sin_inicio\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"crc\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"canal_invalido\"", nullptr},
+    {"prt7_tramas_invalidas_total", "motivo=\"sin_manejador\"", nullptr},
+    {"prt7_sesiones_iniciadas_total", "", "Sesiones abiertas (INICIO o inicio manual)."},
+    {"prt7_sesiones_terminadas_total", "", "Sesiones cerradas con mensaje reportado."},
+    {"prt7_caracteres_decodificados_total", "", "Caracteres insertados en la lista de carga."},
+    {"prt7_lista_desbordes_fallidos_total", "", "Intentos fallidos de pasar a disco el inicio de una sesión (--limite-lista)."},
+};
+
+volatile std::sig_atomic_t gVolcadoPendiente = 0;
+
+extern "C" void solicitarVolcado(int)
+{
+    gVolcadoPendiente = 1;
+}
+
+} // namespace
+
+RegistroContadores::RegistroContadores() noexcept
+{
+    for (std::size_t i = 0; i < kContadores; ++i) {
+        _valores[i].store(0, std::memory_order_relaxed);
+    }
+    _ruta[0] = '\0';
+}
+
+std::uint64_t RegistroContadores::valor(Contador contador) const noexcept
+{
+    return _valores[static_cast<std::size_t>(contador)].load(std::memory_order_relaxed);
+}
+
+void RegistroContadores::setRutaVolcado(const char* ruta) noexcept
+{
+    if (!ruta) {
+        _ruta[0] = '\0';
+        return;
+    }
+    std::size_t longitud = std::strlen(ruta);
+    if (longitud > kMaxRuta) {
+        longitud = kMaxRuta;
+    }
+    std::memcpy(_ruta, ruta, longitud);
+    _ruta[longitud] = '\0';
+}
+
+const char* RegistroContadores::getRutaVolcado() const noexcept
+{
+    return _ruta;
+}
+
+std::size_t RegistroContadores::formatear(char* destino, std::size_t capacidad) const noexcept
+{
+    if (!destino || capacidad == 0) {
+        return 0;
+    }
+
+    std::size_t usados = 0;
+    for (std::size_t i = 0; i < kContadores; ++i) {
+        const DescripcionContador& d = kDescripciones[i];
+        int escritos = 0;
+        if (d.ayuda) {
+            escritos = std::snprintf(destino + usados, capacidad - usados, "# HELP %s %s\n# TYPE %s counter\n",
+                                     d.familia, d.ayuda, d.familia);
+            if (escritos < 0 || static_cast<std::size_t>(escritos) >= capacidad - usados) {
+                return 0;
+            }
+            usados += static_cast<std::size_t>(escritos);
+        }
+
+        const unsigned long long valor = _valores[i].load(std::memory_order_relaxed);
+        if (d.etiquetas[0] != '\0') {
+            escritos = std::snprintf(destino + usados, capacidad - usados, "%s{%s} %llu\n", d.familia, d.etiquetas, valor);
+        } else {
+            escritos = std::snprintf(destino + usados, capacidad - usados, "%s %llu\n", d.familia, valor);
+        }
+        if (escritos < 0 || static_cast<std::size_t>(escritos) >= capacidad - usados) {
+            return 0;
+        }
+        usados += static_cast<std::size_t>(escritos);
+    }
+    return usados;
+}
+
+bool RegistroContadores::volcar() const noexcept
+{
+    if (_ruta[0] == '\0') {
+        return false;
+    }
+
+    char texto[4096];
+    const std::size_t longitud = formatear(texto, sizeof(texto));
+    if (longitud == 0) {
+        return false;
+    }
+
+    char temporal[kMaxRuta + 8];
+    std::snprintf(temporal, sizeof(temporal), "%s.tmp", _ruta);
+    const int fd = ::open(temporal, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::size_t enviados = 0;
+    while (enviados < longitud) {
+        const ssize_t n = ::write(fd, texto + enviados, longitud - enviados);
+        if (n <= 0) {
+            ::close(fd);
+            ::unlink(temporal);
+            return false;
+        }
+        enviados += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    return ::rename(temporal, _ruta) == 0;
+}
+
+void RegistroContadores::instalarSenalVolcado() noexcept
+{
+    struct sigaction accion {};
+    accion.sa_handler = solicitarVolcado;
+    sigemptyset(&accion.sa_mask);
+    // Sin SA_RESTART: la espera del bucle de captura vuelve con EINTR y atiende el volcado.
+    accion.sa_flags = 0;
+    sigaction(SIGUSR2, &accion, nullptr);
+}
+
+bool RegistroContadores::volcadoSolicitado() noexcept
+{
+    if (!gVolcadoPendiente) {
+        return false;
+    }
+    gVolcadoPendiente = 0;
+    return true;
+}
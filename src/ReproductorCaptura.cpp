@@ -0,0 +1,277 @@
+#include "ReproductorCaptura.h"
+
+#include "ArduinoParser.h"
+#include "AuxiliarCli.h"
+#include "GrabadorCaptura.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Sin esperas entre bloques, STDIN se revisa cada tantos bloques para no pagar un ppoll() por bloque.
+const std::uint64_t kRegistrosPorRevision = 256;
+
+std::uint64_t nanosegundosMonotonicos() noexcept
+{
+    timespec ahora {};
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return static_cast<std::uint64_t>(ahora.tv_sec) * 1000000000u + static_cast<std::uint64_t>(ahora.tv_nsec);
+}
+
+/**
+ * @brief Busca desde @p pos un registro 'S' creíble para retomar tras un tramo dañado.
+ *
+ * Un byte 'S' también aparece dentro de los datos, así que se exige un baudrate distinto
+ * de cero y que tras el segmento venga otro registro válido o el final del archivo.
+ * @return true con @p pos en el byte de tipo del segmento encontrado.
+ */
+bool buscarSegmento(const unsigned char* datos, std::size_t tamano, std::size_t& pos) noexcept
+{
+    while (pos < tamano) {
+        const void* marca = std::memchr(datos + pos, FormatoCaptura::kSegmento, tamano - pos);
+        if (!marca) {
+            return false;
+        }
+        const std::size_t candidato = static_cast<std::size_t>(static_cast<const unsigned char*>(marca) - datos);
+        std::size_t siguiente = candidato;
+        FormatoCaptura::Registro registro {};
+        if (FormatoCaptura::leerRegistro(datos, tamano, siguiente, registro) && registro.valor != 0
+            && (siguiente == tamano || FormatoCaptura::leerRegistro(datos, tamano, siguiente, registro))) {
+            pos = candidato;
+            return true;
+        }
+        pos = candidato + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+ReproductorCaptura::ReproductorCaptura(ArduinoParser* destino, AuxiliarCli* logger) noexcept
+    : _destino(destino)
+    , _logger(logger)
+    , _ritmo(RitmoReproduccion::Original)
+    , _detenerConEnter(false)
+    , _stats {}
+{
+}
+
+void ReproductorCaptura::setRitmo(RitmoReproduccion ritmo) noexcept
+{
+    _ritmo = ritmo;
+}
+
+void ReproductorCaptura::setDetenerConEnter(bool detener) noexcept
+{
+    _detenerConEnter = detener;
+}
+
+bool ReproductorCaptura::reproducir(const char* ruta)
+{
+    _stats = Estadisticas {};
+    if (!_destino) {
+        error("No hay parser de destino para la reproducción.");
+        return false;
+    }
+    if (!ruta || ruta[0] == '\0') {
+        error("Ruta de captura vacía.");
+        return false;
+    }
+
+    const int fd = ::open(ruta, O_RDONLY);
+    if (fd < 0) {
+        error("No se pudo abrir el archivo de captura.");
+        return false;
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size < static_cast<off_t>(sizeof(FormatoCaptura::kFirma))) {
+        ::close(fd);
+        error("El archivo de captura está vacío o no es un archivo regular.");
+        return false;
+    }
+
+    const std::size_t tamano = static_cast<std::size_t>(info.st_size);
+    void* mapa = ::mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapa == MAP_FAILED) {
+        error("No se pudo proyectar el archivo de captura.");
+        return false;
+    }
+    ::madvise(mapa, tamano, MADV_SEQUENTIAL);
+
+    const std::uint64_t inicio = nanosegundosMonotonicos();
+    const bool exito = recorrer(static_cast<const unsigned char*>(mapa), tamano);
+    _stats.duracionRealUs = (nanosegundosMonotonicos() - inicio) / 1000u;
+
+    ::munmap(mapa, tamano);
+    return exito;
+}
+
+ReproductorCaptura::Estadisticas ReproductorCaptura::estadisticas() const noexcept
+{
+    return _stats;
+}
+
+void ReproductorCaptura::imprimirEstadisticas() const
+{
+    if (!_logger) {
+        return;
+    }
+
+    const std::uint64_t retrasoMedio = _stats.registros ? _stats.retrasoTotalUs / _stats.registros : 0;
+    char linea[256];
+    std::snprintf(linea, sizeof(linea),
+                  "Reproducción: %llu segmento(s), %llu bloques, %llu bytes en %.3f s (original %.3f s).",
+                  static_cast<unsigned long long>(_stats.segmentos), static_cast<unsigned long long>(_stats.registros),
+                  static_cast<unsigned long long>(_stats.bytes), _stats.duracionRealUs / 1e6,
+                  _stats.duracionOriginalUs / 1e6);
+    _logger->imprimirLog("STATUS", linea);
+    if (_ritmo == RitmoReproduccion::Original) {
+        std::snprintf(linea, sizeof(linea), "Retraso de entrega: medio %llu us, máximo %llu us.",
+                      static_cast<unsigned long long>(retrasoMedio),
+                      static_cast<unsigned long long>(_stats.retrasoMaximoUs));
+        _logger->imprimirLog("STATUS", linea);
+    }
+    if (_stats.bytesSaltados > 0) {
+        std::snprintf(linea, sizeof(linea), "Se saltaron %llu bytes dañados de la captura.",
+                      static_cast<unsigned long long>(_stats.bytesSaltados));
+        _logger->imprimirLog("WARNING", linea);
+    }
+}
+
+bool ReproductorCaptura::recorrer(const unsigned char* datos, std::size_t tamano)
+{
+    if (std::memcmp(datos, FormatoCaptura::kFirma, sizeof(FormatoCaptura::kFirma)) != 0) {
+        error("El archivo no es una captura PRT-7.");
+        return false;
+    }
+
+    std::size_t pos = sizeof(FormatoCaptura::kFirma);
+    std::uint64_t inicioSegmentoNs = 0;
+    std::uint64_t desfaseUs = 0;
+    bool enSegmento = false;
+
+    while (pos < tamano) {
+        const std::size_t inicio = pos;
+        FormatoCaptura::Registro registro {};
+        if (!FormatoCaptura::leerRegistro(datos, tamano, pos, registro)
+            || (registro.tipo == FormatoCaptura::kDatos && !enSegmento)) {
+            // Un registro dañado invalida el resto de su segmento (los tiempos son relativos),
+            // pero los segmentos siguientes se pueden reproducir.
+            pos = inicio + 1;
+            const bool hallado = buscarSegmento(datos, tamano, pos);
+            if (!hallado) {
+                pos = tamano;
+            }
+            _stats.bytesSaltados += pos - inicio;
+            enSegmento = false;
+            if (hallado) {
+                aviso("La captura tiene un tramo truncado o dañado; se reanuda en el siguiente segmento.");
+                continue;
+            }
+            aviso("La captura termina en un tramo truncado o dañado; se omite.");
+            break;
+        }
+        if (registro.tipo == FormatoCaptura::kSegmento) {
+            _stats.duracionOriginalUs += desfaseUs;
+            inicioSegmentoNs = nanosegundosMonotonicos();
+            desfaseUs = 0;
+            enSegmento = true;
+            ++_stats.segmentos;
+            continue;
+        }
+
+        desfaseUs += registro.valor;
+        if (_detenerConEnter && _stats.registros % kRegistrosPorRevision == 0) {
+            if (enterPulsado(0)) {
+                _stats.duracionOriginalUs += desfaseUs;
+                return true;
+            }
+        }
+        if (_ritmo == RitmoReproduccion::Original) {
+            const std::uint64_t objetivo = inicioSegmentoNs + desfaseUs * 1000u;
+            if (!esperarHasta(objetivo)) {
+                _stats.duracionOriginalUs += desfaseUs;
+                return true;
+            }
+            const std::uint64_t ahora = nanosegundosMonotonicos();
+            const std::uint64_t retrasoUs = (ahora > objetivo) ? (ahora - objetivo) / 1000u : 0;
+            _stats.retrasoTotalUs += retrasoUs;
+            if (retrasoUs > _stats.retrasoMaximoUs) {
+                _stats.retrasoMaximoUs = retrasoUs;
+            }
+        }
+
+        _destino->alimentar(reinterpret_cast<const char*>(datos + registro.datos), registro.longitud);
+        ++_stats.registros;
+        _stats.bytes += registro.longitud;
+    }
+
+    _stats.duracionOriginalUs += desfaseUs;
+    return true;
+}
+
+bool ReproductorCaptura::esperarHasta(std::uint64_t objetivoNs)
+{
+    while (true) {
+        const std::uint64_t ahora = nanosegundosMonotonicos();
+        if (ahora >= objetivoNs) {
+            return true;
+        }
+
+        const std::uint64_t restante = objetivoNs - ahora;
+        if (!_detenerConEnter) {
+            timespec objetivo {};
+            objetivo.tv_sec = static_cast<time_t>(objetivoNs / 1000000000u);
+            objetivo.tv_nsec = static_cast<long>(objetivoNs % 1000000000u);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &objetivo, nullptr);
+            continue;
+        }
+
+        if (enterPulsado(restante)) {
+            return false;
+        }
+    }
+}
+
+bool ReproductorCaptura::enterPulsado(std::uint64_t esperaNs)
+{
+    timespec espera {};
+    espera.tv_sec = static_cast<time_t>(esperaNs / 1000000000u);
+    espera.tv_nsec = static_cast<long>(esperaNs % 1000000000u);
+    pollfd entrada {STDIN_FILENO, POLLIN, 0};
+    const int listo = ::ppoll(&entrada, 1, &espera, nullptr);
+    if (listo > 0 && (entrada.revents & POLLIN)) {
+        char buffer[32];
+        const ssize_t leidos = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+        return leidos <= 0 || std::memchr(buffer, '\n', static_cast<std::size_t>(leidos));
+    }
+    return false;
+}
+
+void ReproductorCaptura::aviso(const char* mensaje) const
+{
+    if (_logger) {
+        _logger->imprimirLog("WARNING", mensaje);
+    } else {
+        std::fprintf(stderr, "[WARNING] %s\n", mensaje);
+    }
+}
+
+void ReproductorCaptura::error(const char* mensaje) const
+{
+    if (_logger) {
+        _logger->imprimirLog("ERROR", mensaje);
+    } else {
+        std::fprintf(stderr, "[ERROR] %s\n", mensaje);
+    }
+}
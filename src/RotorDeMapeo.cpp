@@ -1,6 +1,50 @@
 #include "RotorDeMapeo.h"
 
-RotorDeMapeo::RotorDeMapeo() : _cabeza(nullptr), _tamano(0)
+#include "NucleoRotor.h"
+
+namespace {
+
+const int kLetras = 26;
+
+/**
+ * @brief Bloques desde este tamaño pasan al núcleo vectorial; los cortos no amortizan la llamada.
+ */
+const std::size_t kMinNucleo = 16;
+
+/**
+ * @brief Tablas precalculadas: una fila de 256 entradas por cada desplazamiento.
+ */
+struct TablaRotor {
+    char filas[kLetras][256];
+
+    TablaRotor()
+    {
+        for (int desplazamiento = 0; desplazamiento < kLetras; ++desplazamiento) {
+            for (int c = 0; c < 256; ++c) {
+                char salida = static_cast<char>(c);
+                if (c >= 'A' && c <= 'Z') {
+                    salida = static_cast<char>('A' + (c - 'A' + desplazamiento) % kLetras);
+                }
+                filas[desplazamiento][c] = salida;
+            }
+        }
+    }
+};
+
+const TablaRotor& tablaRotor()
+{
+    static const TablaRotor tabla;
+    return tabla;
+}
+
+} // namespace
+
+RotorDeMapeo::RotorDeMapeo(MotorRotor motor)
+    : _cabeza(nullptr)
+    , _tamano(0)
+    , _motor(motor)
+    , _desplazamiento(0)
+    , _fila(tablaRotor().filas[0])
 {
     inicializar();
 }
@@ -27,6 +71,12 @@ void RotorDeMapeo::rotar(int pasos)
         return;
     }
 
+    _desplazamiento = (_desplazamiento + pasos % kLetras + kLetras) % kLetras;
+    _fila = tablaRotor().filas[_desplazamiento];
+    if (_motor == MotorRotor::Tabla) {
+        return;
+    }
+
     int offset = pasos % static_cast<int>(_tamano);
     if (offset < 0) {
         offset += static_cast<int>(_tamano);
@@ -39,6 +89,10 @@ void RotorDeMapeo::rotar(int pasos)
 
 char RotorDeMapeo::getMapeo(char entrada) const
 {
+    if (_motor == MotorRotor::Tabla) {
+        return _fila[static_cast<unsigned char>(entrada)];
+    }
+
     if (!_cabeza) {
         return entrada;
     }
@@ -55,8 +109,30 @@ char RotorDeMapeo::getMapeo(char entrada) const
     return actual->valor;
 }
 
+void RotorDeMapeo::getMapeo(const char* entrada, char* salida, std::size_t cantidad) const
+{
+    if (_motor == MotorRotor::Tabla && cantidad >= kMinNucleo) {
+        NucleoRotor::decodificar(entrada, salida, cantidad, _desplazamiento);
+        return;
+    }
+    if (_motor == MotorRotor::Tabla) {
+        const char* fila = _fila;
+        for (std::size_t i = 0; i < cantidad; ++i) {
+            salida[i] = fila[static_cast<unsigned char>(entrada[i])];
+        }
+        return;
+    }
+
+    for (std::size_t i = 0; i < cantidad; ++i) {
+        salida[i] = getMapeo(entrada[i]);
+    }
+}
+
 void RotorDeMapeo::reiniciar() noexcept
 {
+    _desplazamiento = 0;
+    _fila = tablaRotor().filas[0];
+
     if (!_cabeza) {
         return;
     }
@@ -71,6 +147,39 @@ void RotorDeMapeo::reiniciar() noexcept
     _cabeza = actual;
 }
 
+void RotorDeMapeo::setMotor(MotorRotor motor) noexcept
+{
+    if (motor == _motor) {
+        return;
+    }
+    _motor = motor;
+    if (_motor == MotorRotor::ListaEnlazada) {
+        sincronizarCabeza();
+    }
+}
+
+MotorRotor RotorDeMapeo::getMotor() const noexcept
+{
+    return _motor;
+}
+
+int RotorDeMapeo::getDesplazamiento() const noexcept
+{
+    return _desplazamiento;
+}
+
+void RotorDeMapeo::sincronizarCabeza() noexcept
+{
+    if (!_cabeza) {
+        return;
+    }
+
+    const char objetivo = static_cast<char>('A' + _desplazamiento);
+    while (_cabeza->valor != objetivo) {
+        _cabeza = _cabeza->siguiente;
+    }
+}
+
 void RotorDeMapeo::inicializar()
 {
     Nodo* previo = nullptr;
@@ -0,0 +1,85 @@
+#include "SalidaDescriptor.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+
+SalidaDescriptor::SalidaDescriptor(int fd) noexcept
+    : _fd(fd)
+    , _buffer(new (std::nothrow) char[kCapacidad])
+    , _usados(0)
+    , _error(false)
+    , _vaciarPorMensaje(false)
+{
+}
+
+SalidaDescriptor::~SalidaDescriptor()
+{
+    vaciar();
+    delete[] _buffer;
+}
+
+void SalidaDescriptor::escribirFragmento(const char* datos, std::size_t longitud)
+{
+    if (!datos || longitud == 0) {
+        return;
+    }
+
+    if (!_buffer || longitud >= kCapacidad) {
+        vaciar();
+        escribirTodo(datos, longitud);
+        return;
+    }
+
+    if (_usados + longitud > kCapacidad) {
+        vaciar();
+    }
+    std::memcpy(_buffer + _usados, datos, longitud);
+    _usados += longitud;
+}
+
+void SalidaDescriptor::finalizarMensaje()
+{
+    const char salto = '\n';
+    escribirFragmento(&salto, 1);
+    if (_vaciarPorMensaje) {
+        vaciar();
+    }
+}
+
+void SalidaDescriptor::setVaciarPorMensaje(bool activo) noexcept
+{
+    _vaciarPorMensaje = activo;
+}
+
+bool SalidaDescriptor::vaciar() noexcept
+{
+    if (_usados > 0) {
+        escribirTodo(_buffer, _usados);
+        _usados = 0;
+    }
+    return !_error;
+}
+
+bool SalidaDescriptor::huboError() const noexcept
+{
+    return _error;
+}
+
+bool SalidaDescriptor::escribirTodo(const char* datos, std::size_t longitud) noexcept
+{
+    while (longitud > 0) {
+        const ssize_t escritos = ::write(_fd, datos, longitud);
+        if (escritos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _error = true;
+            return false;
+        }
+        datos += escritos;
+        longitud -= static_cast<std::size_t>(escritos);
+    }
+    return true;
+}
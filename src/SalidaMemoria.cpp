@@ -0,0 +1,73 @@
+#include "SalidaMemoria.h"
+
+#include <cstring>
+#include <new>
+
+SalidaMemoria::SalidaMemoria() noexcept
+    : _datos(nullptr)
+    , _capacidad(0)
+    , _usados(0)
+    , _error(false)
+{
+}
+
+SalidaMemoria::~SalidaMemoria()
+{
+    delete[] _datos;
+}
+
+void SalidaMemoria::escribirFragmento(const char* datos, std::size_t longitud)
+{
+    if (_capacidad - _usados < longitud && !crecer(_usados + longitud)) {
+        _error = true;
+        return;
+    }
+    std::memcpy(_datos + _usados, datos, longitud);
+    _usados += longitud;
+}
+
+void SalidaMemoria::finalizarMensaje()
+{
+    const char salto = '\n';
+    escribirFragmento(&salto, 1);
+}
+
+void SalidaMemoria::reiniciar() noexcept
+{
+    _usados = 0;
+    _error = false;
+}
+
+const char* SalidaMemoria::datos() const noexcept
+{
+    return _datos;
+}
+
+std::size_t SalidaMemoria::longitud() const noexcept
+{
+    return _usados;
+}
+
+bool SalidaMemoria::huboError() const noexcept
+{
+    return _error;
+}
+
+bool SalidaMemoria::crecer(std::size_t minimo) noexcept
+{
+    std::size_t capacidad = _capacidad ? _capacidad * 2 : 4096;
+    while (capacidad < minimo) {
+        capacidad *= 2;
+    }
+    char* datos = new (std::nothrow) char[capacidad];
+    if (!datos) {
+        return false;
+    }
+    if (_usados > 0) {
+        std::memcpy(datos, _datos, _usados);
+    }
+    delete[] _datos;
+    _datos = datos;
+    _capacidad = capacidad;
+    return true;
+}
@@ -10,6 +10,17 @@ void TramaLoad::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor)
     if (!carga || !rotor) {
         return;
     }
-    const char decodificado = rotor->getMapeo(_dato);
-    carga->insertarAlFinal(decodificado);
+    aplicar(*carga, *rotor);
+}
+
+char TramaLoad::aplicar(ListaDeCarga& carga, const RotorDeMapeo& rotor) const
+{
+    const char decodificado = rotor.getMapeo(_dato);
+    carga.insertarAlFinal(decodificado);
+    return decodificado;
+}
+
+char TramaLoad::dato() const noexcept
+{
+    return _dato;
 }
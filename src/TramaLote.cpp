@@ -0,0 +1,40 @@
+#include "TramaLote.h"
+
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+TramaLote::TramaLote(const char* datos, std::size_t longitud) noexcept : _datos(datos), _longitud(datos ? longitud : 0) {}
+
+void TramaLote::procesar(ListaDeCarga* carga, RotorDeMapeo* rotor)
+{
+    if (!carga || !rotor) {
+        return;
+    }
+    aplicar(*carga, *rotor);
+}
+
+std::size_t TramaLote::aplicar(ListaDeCarga& carga, const RotorDeMapeo& rotor) const
+{
+    char decodificados[kTramo];
+    std::size_t hechos = 0;
+    while (hechos < _longitud) {
+        std::size_t tramo = _longitud - hechos;
+        if (tramo > kTramo) {
+            tramo = kTramo;
+        }
+        rotor.getMapeo(_datos + hechos, decodificados, tramo);
+        carga.insertarVarios(decodificados, tramo);
+        hechos += tramo;
+    }
+    return hechos;
+}
+
+const char* TramaLote::datos() const noexcept
+{
+    return _datos;
+}
+
+std::size_t TramaLote::longitud() const noexcept
+{
+    return _longitud;
+}
@@ -9,5 +9,16 @@ void TramaMap::procesar(ListaDeCarga* /*carga*/, RotorDeMapeo* rotor)
     if (!rotor) {
         return;
     }
-    rotor->rotar(_desplazamiento);
+    aplicar(*rotor);
+}
+
+int TramaMap::aplicar(RotorDeMapeo& rotor) const
+{
+    rotor.rotar(_desplazamiento);
+    return rotor.getDesplazamiento();
+}
+
+int TramaMap::desplazamiento() const noexcept
+{
+    return _desplazamiento;
 }
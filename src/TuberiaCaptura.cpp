@@ -0,0 +1,313 @@
+#include "TuberiaCaptura.h"
+
+#include "AuxiliarCli.h"
+#include "GrabadorCaptura.h"
+#include "LineaDispatcher.h"
+#include "RegistroContadores.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const int kEsperaPollMs = 100;
+
+} // namespace
+
+TuberiaCaptura::SalidaEnCola::SalidaEnCola(TuberiaCaptura& tuberia) noexcept : _tuberia(tuberia)
+{
+    _actual.longitud = 0;
+}
+
+void TuberiaCaptura::SalidaEnCola::escribirFragmento(const char* datos, std::size_t longitud)
+{
+    while (longitud > 0) {
+        std::size_t espacio = kBytesPorSalida - _actual.longitud;
+        if (espacio == 0) {
+            vaciar();
+            espacio = kBytesPorSalida;
+        }
+        const std::size_t copia = (longitud < espacio) ? longitud : espacio;
+        std::memcpy(_actual.datos + _actual.longitud, datos, copia);
+        _actual.longitud += copia;
+        datos += copia;
+        longitud -= copia;
+    }
+}
+
+void TuberiaCaptura::SalidaEnCola::finalizarMensaje()
+{
+    const char salto = '\n';
+    escribirFragmento(&salto, 1);
+    vaciar();
+}
+
+void TuberiaCaptura::SalidaEnCola::vaciar() noexcept
+{
+    if (_actual.longitud == 0) {
+        return;
+    }
+
+    BloqueSalida* destino = _tuberia._salida->espacioLibre();
+    if (destino) {
+        destino->longitud = _actual.longitud;
+        std::memcpy(destino->datos, _actual.datos, _actual.longitud);
+        _tuberia._salida->publicar();
+        _tuberia._haySalida.notificar();
+    } else {
+        _tuberia._bloquesDescartados.fetch_add(1, std::memory_order_relaxed);
+        _tuberia._bytesDescartados.fetch_add(_actual.longitud, std::memory_order_relaxed);
+    }
+    _actual.longitud = 0;
+}
+
+TuberiaCaptura::TuberiaCaptura(int fd, LineaDispatcher* dispatcher, AuxiliarCli* logger, int salidaFd) noexcept
+    : _fd(fd)
+    , _salidaFd(salidaFd)
+    , _dispatcher(dispatcher)
+    , _logger(logger)
+    , _grabador(nullptr)
+    , _contadores(nullptr)
+    , _entrada(new (std::nothrow) ColaSpsc<BloqueCrudo, kBloquesEnCola>)
+    , _salida(new (std::nothrow) ColaSpsc<BloqueSalida, kBloquesEnCola>)
+    , _adaptador(*this)
+    , _detener(false)
+    , _lectorTerminado(false)
+    , _decodificadorTerminado(false)
+    , _falloLectura(false)
+    , _bytesLeidos(0)
+    , _lecturas(0)
+    , _esperasEntrada(0)
+    , _maxOcupacionEntrada(0)
+    , _bytesEscritos(0)
+    , _bloquesDescartados(0)
+    , _bytesDescartados(0)
+{
+}
+
+TuberiaCaptura::~TuberiaCaptura()
+{
+    delete _entrada;
+    delete _salida;
+}
+
+void TuberiaCaptura::setGrabador(GrabadorCaptura* grabador) noexcept
+{
+    _grabador = grabador;
+}
+
+void TuberiaCaptura::setContadores(RegistroContadores* contadores) noexcept
+{
+    _contadores = contadores;
+}
+
+bool TuberiaCaptura::ejecutarHastaEnter()
+{
+    if (_fd < 0 || !_dispatcher || !_entrada || !_salida) {
+        if (_logger) {
+            _logger->imprimirLog("ERROR", "La tubería de captura no está configurada.");
+        }
+        return false;
+    }
+
+    AuxiliarCli* loggerDispatcher = _dispatcher->getLogger();
+    _dispatcher->setLogger(nullptr);
+    _dispatcher->setSalida(&_adaptador);
+
+    if (_logger) {
+        _logger->imprimirLog("STATUS", "Captura en tubería (lector, decodificador, salida). ENTER la detiene.");
+        _logger->vaciar();
+    }
+
+    std::thread escritor(&TuberiaCaptura::escribir, this);
+    std::thread decodificador(&TuberiaCaptura::decodificar, this);
+    std::thread lector(&TuberiaCaptura::leer, this);
+
+    while (!_lectorTerminado.load(std::memory_order_acquire)) {
+        pollfd entrada {STDIN_FILENO, POLLIN, 0};
+        const int listo = ::poll(&entrada, 1, kEsperaPollMs);
+        if (_contadores && RegistroContadores::volcadoSolicitado()) {
+            _contadores->volcar();
+        }
+        if (listo > 0) {
+            char buffer[32];
+            const ssize_t leidos = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (leidos <= 0 || std::memchr(buffer, '\n', static_cast<std::size_t>(leidos))) {
+                break;
+            }
+        }
+    }
+
+    _detener.store(true, std::memory_order_release);
+    _hayEspacioEntrada.notificar();
+    lector.join();
+    decodificador.join();
+    escritor.join();
+
+    if (_bytesEscritos.load(std::memory_order_relaxed) > 0) {
+        const ssize_t salto = ::write(_salidaFd, "\n", 1);
+        (void)salto;
+    }
+
+    _dispatcher->setSalida(nullptr);
+    _dispatcher->setLogger(loggerDispatcher);
+
+    imprimirEstadisticas();
+    return !_falloLectura.load(std::memory_order_relaxed);
+}
+
+TuberiaCaptura::Estadisticas TuberiaCaptura::estadisticas() const noexcept
+{
+    Estadisticas e;
+    e.bytesLeidos = _bytesLeidos.load(std::memory_order_relaxed);
+    e.lecturas = _lecturas.load(std::memory_order_relaxed);
+    e.esperasEntrada = _esperasEntrada.load(std::memory_order_relaxed);
+    e.maxOcupacionEntrada = _maxOcupacionEntrada.load(std::memory_order_relaxed);
+    e.bytesEscritos = _bytesEscritos.load(std::memory_order_relaxed);
+    e.bloquesDescartados = _bloquesDescartados.load(std::memory_order_relaxed);
+    e.bytesDescartados = _bytesDescartados.load(std::memory_order_relaxed);
+    return e;
+}
+
+void TuberiaCaptura::imprimirEstadisticas() const
+{
+    if (!_logger) {
+        return;
+    }
+
+    const Estadisticas e = estadisticas();
+    char mensaje[256];
+    std::snprintf(mensaje, sizeof(mensaje), "Lector: %llu bytes en %llu lecturas, %llu esperas por cola llena (máx. %llu/%zu bloques).",
+                  static_cast<unsigned long long>(e.bytesLeidos), static_cast<unsigned long long>(e.lecturas),
+                  static_cast<unsigned long long>(e.esperasEntrada), static_cast<unsigned long long>(e.maxOcupacionEntrada),
+                  kBloquesEnCola);
+    _logger->imprimirLog("STATUS", mensaje);
+
+    std::snprintf(mensaje, sizeof(mensaje), "Salida: %llu bytes escritos, %llu bloques (%llu bytes) descartados.",
+                  static_cast<unsigned long long>(e.bytesEscritos), static_cast<unsigned long long>(e.bloquesDescartados),
+                  static_cast<unsigned long long>(e.bytesDescartados));
+    _logger->imprimirLog(e.bloquesDescartados > 0 ? "WARNING" : "STATUS", mensaje);
+}
+
+void TuberiaCaptura::leer()
+{
+    while (!_detener.load(std::memory_order_acquire)) {
+        pollfd puerto {_fd, POLLIN, 0};
+        const int listo = ::poll(&puerto, 1, kEsperaPollMs);
+        if (listo < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _falloLectura.store(true, std::memory_order_relaxed);
+            break;
+        }
+        if (listo == 0) {
+            if (_grabador) {
+                _grabador->vaciarSiVencido();
+            }
+            continue;
+        }
+
+        BloqueCrudo* bloque = _entrada->espacioLibre();
+        if (!bloque) {
+            _esperasEntrada.fetch_add(1, std::memory_order_relaxed);
+            while (!bloque && !_detener.load(std::memory_order_acquire)) {
+                _hayEspacioEntrada.esperar(
+                    [this] { return _entrada->tamano() < kBloquesEnCola || _detener.load(std::memory_order_acquire); },
+                    kEsperaPollMs);
+                bloque = _entrada->espacioLibre();
+            }
+            if (!bloque) {
+                break;
+            }
+        }
+
+        const ssize_t leidos = ::read(_fd, bloque->datos, kBytesPorBloque);
+        if (leidos > 0) {
+            bloque->longitud = static_cast<std::size_t>(leidos);
+            if (_grabador) {
+                _grabador->registrar(bloque->datos, bloque->longitud);
+            }
+            _entrada->publicar();
+            _hayEntrada.notificar();
+            _bytesLeidos.fetch_add(static_cast<std::uint64_t>(leidos), std::memory_order_relaxed);
+            _lecturas.fetch_add(1, std::memory_order_relaxed);
+            if (_contadores) {
+                _contadores->sumar(Contador::Lecturas);
+                _contadores->sumar(Contador::BytesLeidos, static_cast<std::uint64_t>(leidos));
+            }
+        } else if (leidos == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            if (_contadores) {
+                _contadores->sumar(leidos == 0 ? Contador::Desconexiones : Contador::ErroresLectura);
+            }
+            _falloLectura.store(true, std::memory_order_relaxed);
+            break;
+        }
+    }
+    _lectorTerminado.store(true, std::memory_order_release);
+    _hayEntrada.notificar();
+}
+
+void TuberiaCaptura::decodificar()
+{
+    while (true) {
+        BloqueCrudo* bloque = _entrada->frente();
+        if (!bloque) {
+            if (_lectorTerminado.load(std::memory_order_acquire) && !_entrada->frente()) {
+                break;
+            }
+            _hayEntrada.esperar(
+                [this] { return _entrada->tamano() > 0 || _lectorTerminado.load(std::memory_order_acquire); },
+                kEsperaPollMs);
+            continue;
+        }
+
+        const std::uint64_t ocupacion = _entrada->tamano();
+        if (ocupacion > _maxOcupacionEntrada.load(std::memory_order_relaxed)) {
+            _maxOcupacionEntrada.store(ocupacion, std::memory_order_relaxed);
+        }
+
+        _dispatcher->onRawBytes(bloque->datos, bloque->longitud);
+        _entrada->liberar();
+        _hayEspacioEntrada.notificar();
+        _adaptador.vaciar();
+    }
+    _adaptador.vaciar();
+    _decodificadorTerminado.store(true, std::memory_order_release);
+    _haySalida.notificar();
+}
+
+void TuberiaCaptura::escribir()
+{
+    while (true) {
+        BloqueSalida* bloque = _salida->frente();
+        if (!bloque) {
+            if (_decodificadorTerminado.load(std::memory_order_acquire) && !_salida->frente()) {
+                break;
+            }
+            _haySalida.esperar(
+                [this] { return _salida->tamano() > 0 || _decodificadorTerminado.load(std::memory_order_acquire); },
+                kEsperaPollMs);
+            continue;
+        }
+
+        std::size_t escritos = 0;
+        while (escritos < bloque->longitud) {
+            const ssize_t n = ::write(_salidaFd, bloque->datos + escritos, bloque->longitud - escritos);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            escritos += static_cast<std::size_t>(n);
+        }
+        _bytesEscritos.fetch_add(escritos, std::memory_order_relaxed);
+        _salida->liberar();
+    }
+}
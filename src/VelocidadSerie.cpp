@@ -0,0 +1,40 @@
+#include "VelocidadSerie.h"
+
+#if defined(__linux__)
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace VelocidadSerie {
+
+#if defined(__linux__) && defined(TCGETS2) && defined(BOTHER)
+
+bool aplicarPersonalizada(int fd, unsigned baud) noexcept
+{
+    if (fd < 0 || baud == 0) {
+        return false;
+    }
+
+    struct termios2 opciones {};
+    if (ioctl(fd, TCGETS2, &opciones) != 0) {
+        return false;
+    }
+
+    // BOTHER indica que la velocidad está en c_ispeed/c_ospeed y no en los bits CBAUD.
+    opciones.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    opciones.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    opciones.c_ispeed = baud;
+    opciones.c_ospeed = baud;
+    return ioctl(fd, TCSETS2, &opciones) == 0;
+}
+
+#else
+
+bool aplicarPersonalizada(int, unsigned) noexcept
+{
+    return false;
+}
+
+#endif
+
+} // namespace VelocidadSerie
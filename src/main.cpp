@@ -1,13 +1,30 @@
 #include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include <iostream>
 #include <limits>
 
 #include "ArduinoParser.h"
 #include "AuxiliarCli.h"
+#include "CapturaMultiple.h"
+#include "DecodificadorLotes.h"
+#include "DecodificadorParalelo.h"
+#include "DecodificadorSesiones.h"
+#include "DestinoMensajes.h"
+#include "GrabadorCaptura.h"
+#include "InstrumentacionEtapas.h"
 #include "LineaDispatcher.h"
 #include "ListaDeCarga.h"
+#include "MedidorLatencia.h"
+#include "RegistroContadores.h"
+#include "ReproductorCaptura.h"
 #include "RotorDeMapeo.h"
+#include "SalidaDescriptor.h"
 
 /**
  * @brief Elimina espacios iniciales y finales del buffer recibido.
@@ -19,8 +36,12 @@ static void recortarEnLugar(char* texto);
  * @brief Muestra el menú principal con la configuración actual.
  * @param rutaActual Texto con la ruta del dispositivo serie.
  * @param baud Baudrate configurado.
+ * @param perfil Perfil de E/S del puerto serie.
+ * @param rutaGrabacion Archivo donde se grabarán las capturas; vacío si no se graba.
+ * @param destinoMensajes Archivo o socket de los mensajes de la captura; vacío si solo van al log.
  */
-static void imprimirMenuPrincipal(const char* rutaActual, unsigned baud);
+static void imprimirMenuPrincipal(const char* rutaActual, unsigned baud, PerfilEntrada perfil, const char* rutaGrabacion,
+                                  const char* destinoMensajes);
 
 /**
  * @brief Permite seleccionar interactívamente el preset del puerto serie.
@@ -36,6 +57,13 @@ static void configurarPresetInteractivo(AuxiliarCli& logger, ArduinoParser& pars
  */
 static void configurarBaudrateInteractivo(AuxiliarCli& logger, ArduinoParser& parser);
 
+/**
+ * @brief Elige el perfil de E/S (latencia o rendimiento) que usará el puerto serie.
+ * @param logger Utilidad de logging y lectura validada.
+ * @param parser Parser al que se aplicará el perfil.
+ */
+static void configurarPerfilInteractivo(AuxiliarCli& logger, ArduinoParser& parser);
+
 /**
  * @brief Ejecuta el modo simulación con entrada manual o dataset de ejemplo.
  * @param logger Utilidad para mensajes y lectura.
@@ -49,28 +77,154 @@ static void menuSimulacion(AuxiliarCli& logger, LineaDispatcher& dispatcher, Lis
  * @param logger Utilidad para mensajes.
  * @param parser Parser que realiza la lectura del puerto.
  * @param dispatcher Dispatcher que procesa las tramas recibidas.
+ * @param rutaGrabacion Archivo donde se agrega la captura cruda; vacío para no grabar.
+ * @param destinoMensajes Archivo, "unix:RUTA" o "tcp:HOST:PUERTO" que recibe cada mensaje al cerrarse; vacío
+ *        para verlos solo en el log (o en STDOUT con la tubería).
+ * @param enTuberia Si es true, lectura, decodificación y salida corren en hilos separados.
+ */
+static void ejecutarCapturaSerie(AuxiliarCli& logger, ArduinoParser& parser, LineaDispatcher& dispatcher,
+                                 const char* rutaGrabacion, const char* destinoMensajes, bool enTuberia = false);
+
+/**
+ * @brief Captura desde varios dispositivos serie o pty a la vez, cada uno con su sesión.
+ * @param logger Utilidad para mensajes y lectura.
+ * @param baud Baudrate que se aplicará a todos los dispositivos.
+ */
+static void ejecutarCapturaMultiple(AuxiliarCli& logger, unsigned baud);
+
+/**
+ * @brief Reproduce una captura grabada a través del parser y el dispatcher del menú.
+ * @param logger Utilidad para mensajes y lectura.
+ * @param parser Parser que recibirá los bytes grabados.
+ * @param dispatcher Dispatcher que procesa las tramas reproducidas.
+ */
+static void menuReproduccion(AuxiliarCli& logger, ArduinoParser& parser, LineaDispatcher& dispatcher);
+
+/**
+ * @brief Ajusta el nivel de log que se mostrará en ejecución.
+ * @param logger Logger a configurar.
+ */
+static void configurarNivelLogInteractivo(AuxiliarCli& logger);
+
+/**
+ * @brief Muestra el menú principal hasta que el usuario elija salir.
+ * @param rutaMetricas Archivo de métricas que se reescribe tras cada opción; nullptr para no exportar.
+ * @return Código de salida del programa.
+ */
+static int ejecutarMenuInteractivo(const char* rutaMetricas);
+
+/**
+ * @brief Ejecuta el modo sin menús indicado por la línea de comandos.
+ * @param argc Número de argumentos.
+ * @param argv Argumentos recibidos.
+ * @return Código de salida del programa.
+ */
+static int ejecutarModoLotes(int argc, char* argv[]);
+
+/**
+ * @brief Reproduce una captura grabada y escribe solo los mensajes decodificados.
+ * @param ruta Archivo de captura.
+ * @param ritmo Ritmo de entrega de los bloques.
+ * @param salidaFd Descriptor donde se escriben los mensajes.
+ * @param vaciarPorMensaje true para escribir cada mensaje en cuanto se cierra (sockets o ritmo original).
+ * @param contadores Registro de métricas; puede ser nulo.
+ * @return true si la captura se reprodujo completa.
+ */
+static bool reproducirCaptura(const char* ruta, RitmoReproduccion ritmo, int salidaFd, bool vaciarPorMensaje,
+                              RegistroContadores* contadores);
+
+/**
+ * @brief Decodifica una fuente por sesiones con ayuda de su índice "<ruta>.idx".
+ * @param ruta Archivo de tramas o captura grabada.
+ * @param sesion Sesión a decodificar, desde 1; 0 para todas en paralelo.
+ * @param hilos Hilos del grupo; 0 usa todos los núcleos.
+ * @param salidaFd Descriptor donde se escriben los mensajes.
+ * @param contadores Registro de métricas; puede ser nulo.
+ * @return true si la fuente se decodificó y la salida se escribió.
+ */
+static bool decodificarPorSesiones(const char* ruta, unsigned long sesion, std::size_t hilos, int salidaFd,
+                                   RegistroContadores* contadores);
+
+/**
+ * @brief Reconstruye el índice de sesiones de una fuente y lo lista en STDOUT.
+ * @param ruta Archivo de tramas o captura grabada.
+ * @return true si el índice se construyó y se guardó junto a la fuente.
+ */
+static bool indexarSesiones(const char* ruta);
+
+/**
+ * @brief Interpreta un entero positivo escrito solo con dígitos.
+ * @param texto Valor recibido en la línea de comandos.
+ * @param maximo Mayor valor aceptado.
+ * @param valor Recibe el entero.
+ * @return false si hay signo, espacios, basura al final, o el valor es 0 o excede @p maximo.
  */
-static void ejecutarCapturaSerie(AuxiliarCli& logger, ArduinoParser& parser, LineaDispatcher& dispatcher);
+static bool interpretarEnteroPositivo(const char* texto, unsigned long maximo, unsigned long& valor);
 
 /**
- * @brief Punto de entrada del decodificador interactivo PRT-7.
+ * @brief Interpreta un tamaño en bytes con sufijo opcional K, M o G (potencias de 1024).
+ * @param texto Valor recibido en la línea de comandos.
+ * @param tamano Recibe el tamaño en bytes.
+ * @return false si el texto no es un número válido.
+ */
+static bool interpretarTamano(const char* texto, std::size_t& tamano);
+
+/**
+ * @brief Captura desde una pty de prt7_emulador y reporta latencia y ritmo sostenido.
+ * @param ruta Ruta del dispositivo o pty.
+ * @param baud Baudrate a configurar con termios; 0 lo detecta con ArduinoParser::detectarBaudrate().
+ * @param perfil Perfil de E/S con el que se abre el puerto.
+ * @param contadores Registro de métricas; puede ser nulo.
+ * @return true si el puerto se abrió y se recibieron tramas.
+ */
+static bool medirLatencia(const char* ruta, unsigned baud, PerfilEntrada perfil, RegistroContadores* contadores);
+
+/**
+ * @brief Punto de entrada del decodificador PRT-7.
+ *
+ * Sin argumentos se muestra el menú interactivo; con argumentos se decodifica
+ * un archivo de tramas, STDIN o una captura grabada sin interacción (ver --ayuda).
+ *
+ * @param argc Número de argumentos.
+ * @param argv Argumentos recibidos.
  * @return Código de salida del programa.
  */
-int main()
+int main(int argc, char* argv[])
+{
+    if (argc > 1) {
+        return ejecutarModoLotes(argc, argv);
+    }
+    return ejecutarMenuInteractivo(nullptr);
+}
+
+int ejecutarMenuInteractivo(const char* rutaMetricas)
 {
     AuxiliarCli logger;
     ListaDeCarga lista;
     RotorDeMapeo rotor;
     LineaDispatcher dispatcher(&lista, &rotor, &logger);
     ArduinoParser parser(&logger, &dispatcher);
+    char rutaGrabacion[256] = "";
+    char destinoMensajes[256] = "";
+
+    RegistroContadores contadores;
+    if (rutaMetricas) {
+        contadores.setRutaVolcado(rutaMetricas);
+        parser.setContadores(&contadores);
+        dispatcher.setContadores(&contadores);
+        RegistroContadores::instalarSenalVolcado();
+    }
 
     bool salir = false;
     logger.imprimirLog("STATUS", "Decodificador PRT-7 listo.");
+    if (rutaMetricas) {
+        logger.imprimirLog("STATUS", "Métricas activas: SIGUSR2 las escribe durante la captura.");
+    }
 
     while (!salir) {
         const char* rutaActual = ArduinoParser::defaultPathFor(parser.getPreset());
         const unsigned baudActual = parser.getBaudrate();
-        imprimirMenuPrincipal(rutaActual, baudActual);
+        imprimirMenuPrincipal(rutaActual, baudActual, parser.getPerfil(), rutaGrabacion, destinoMensajes);
 
         int opcion = -1;
         logger.obtenerDato("Seleccione una opción", opcion);
@@ -86,7 +240,35 @@ int main()
             menuSimulacion(logger, dispatcher, lista);
             break;
         case 4:
-            ejecutarCapturaSerie(logger, parser, dispatcher);
+            ejecutarCapturaSerie(logger, parser, dispatcher, rutaGrabacion, destinoMensajes);
+            break;
+        case 5:
+            ejecutarCapturaMultiple(logger, parser.getBaudrate());
+            break;
+        case 6:
+            ejecutarCapturaSerie(logger, parser, dispatcher, rutaGrabacion, destinoMensajes, true);
+            break;
+        case 7:
+            configurarNivelLogInteractivo(logger);
+            break;
+        case 8:
+            logger.obtenerCadena("Archivo de grabación (vacío para no grabar)", rutaGrabacion, sizeof(rutaGrabacion));
+            recortarEnLugar(rutaGrabacion);
+            logger.imprimirLog("STATUS", rutaGrabacion[0] ? "Las capturas se grabarán en el archivo indicado."
+                                                          : "Grabación desactivada.");
+            break;
+        case 9:
+            menuReproduccion(logger, parser, dispatcher);
+            break;
+        case 10:
+            configurarPerfilInteractivo(logger, parser);
+            break;
+        case 11:
+            logger.obtenerCadena("Destino de mensajes (archivo, unix:RUTA o tcp:HOST:PUERTO; vacío para solo log)",
+                                 destinoMensajes, sizeof(destinoMensajes));
+            recortarEnLugar(destinoMensajes);
+            logger.imprimirLog("STATUS", destinoMensajes[0] ? "Cada mensaje cerrado se enviará al destino indicado."
+                                                            : "Los mensajes se verán solo en el log.");
             break;
         case 0:
             salir = true;
@@ -95,6 +277,10 @@ int main()
             logger.imprimirLog("WARNING", "Opción no reconocida.");
             break;
         }
+
+        if (rutaMetricas && !contadores.volcar()) {
+            logger.imprimirLog("WARNING", "No se pudo escribir el archivo de métricas.");
+        }
     }
 
     logger.imprimirLog("STATUS", "Programa finalizado.");
@@ -122,16 +308,27 @@ void recortarEnLugar(char* texto)
     }
 }
 
-void imprimirMenuPrincipal(const char* rutaActual, unsigned baud)
+void imprimirMenuPrincipal(const char* rutaActual, unsigned baud, PerfilEntrada perfil, const char* rutaGrabacion,
+                           const char* destinoMensajes)
 {
     std::cout << "\nDecodificador PRT-7\n"
                  "Dispositivo: " << (rutaActual ? rutaActual : "(sin definir)") << "\n"
                  "Baudrate: " << baud << "\n"
+                 "Perfil E/S: " << ArduinoParser::nombrePerfil(perfil) << "\n"
+                 "Grabación: " << ((rutaGrabacion && rutaGrabacion[0]) ? rutaGrabacion : "(desactivada)") << "\n"
+                 "Mensajes: " << ((destinoMensajes && destinoMensajes[0]) ? destinoMensajes : "(solo log)") << "\n"
                  "────────────────────────────────────────────────\n"
                  "1 | Seleccionar preset del puerto serie\n"
                  "2 | Ajustar baudrate\n"
                  "3 | Ejecutar simulación\n"
                  "4 | Capturar desde el dispositivo serie\n"
+                 "5 | Capturar desde varios dispositivos\n"
+                 "6 | Capturar en tubería de tres hilos\n"
+                 "7 | Ajustar nivel de log\n"
+                 "8 | Configurar grabación de capturas\n"
+                 "9 | Reproducir una captura grabada\n"
+                 "10 | Elegir perfil de E/S serie\n"
+                 "11 | Configurar destino de mensajes\n"
                  "0 | Salir\n";
 }
 
@@ -169,26 +366,89 @@ void configurarBaudrateInteractivo(AuxiliarCli& logger, ArduinoParser& parser)
                  "────────────────────────────────\n"
                  "0 | Cancelar\n"
                  "1 | 115200\n"
-                 "2 | 9600\n";
+                 "2 | 9600\n"
+                 "3 | 921600\n"
+                 "4 | 2000000\n"
+                 "5 | Otro valor\n"
+                 "6 | Detectar desde el dispositivo\n";
     int opcion = 0;
     logger.obtenerDato("Seleccione una opción", opcion);
 
+    unsigned baud = 0;
     switch (opcion) {
     case 0:
         logger.imprimirLog("STATUS", "Baudrate sin cambios.");
-        break;
+        return;
     case 1:
-        parser.setBaudrate(115200);
-        logger.imprimirLog("STATUS", "Baudrate ajustado a 115200.");
+        baud = 115200;
         break;
     case 2:
-        parser.setBaudrate(9600);
-        logger.imprimirLog("STATUS", "Baudrate ajustado a 9600.");
+        baud = 9600;
+        break;
+    case 3:
+        baud = 921600;
+        break;
+    case 4:
+        baud = 2000000;
+        break;
+    case 5: {
+        int valor = 0;
+        logger.obtenerDato("Baudrate (bits por segundo)", valor);
+        if (valor <= 0) {
+            logger.imprimirLog("WARNING", "Baudrate no válido.");
+            return;
+        }
+        baud = static_cast<unsigned>(valor);
+        break;
+    }
+    case 6:
+        logger.imprimirLog("STATUS", "Detectando baudrate; el dispositivo debe estar transmitiendo.");
+        baud = ArduinoParser::detectarBaudrate(ArduinoParser::defaultPathFor(parser.getPreset()), &logger);
+        if (baud == 0) {
+            logger.imprimirLog("WARNING", "No se detectó un baudrate con tramas válidas; sin cambios.");
+            return;
+        }
         break;
     default:
         logger.imprimirLog("WARNING", "Opción de baudrate no válida.");
+        return;
+    }
+
+    parser.setBaudrate(baud);
+    char mensaje[64];
+    std::snprintf(mensaje, sizeof(mensaje), "Baudrate ajustado a %u.", baud);
+    logger.imprimirLog("STATUS", mensaje);
+}
+
+void configurarPerfilInteractivo(AuxiliarCli& logger, ArduinoParser& parser)
+{
+    std::cout << "\nPerfiles de E/S:\n"
+                 "────────────────────────────────\n"
+                 "0 | Cancelar\n"
+                 "1 | Estándar (VMIN=0, VTIME=1)\n"
+                 "2 | Baja latencia (VMIN=1, ASYNC_LOW_LATENCY, lectura no bloqueante)\n"
+                 "3 | Rendimiento (VMIN=255, VTIME=1, bloques de 64 KB)\n";
+    int opcion = 0;
+    logger.obtenerDato("Seleccione un perfil", opcion);
+
+    switch (opcion) {
+    case 0:
+        logger.imprimirLog("STATUS", "Perfil sin cambios.");
+        return;
+    case 1:
+        parser.setPerfil(PerfilEntrada::Estandar);
         break;
+    case 2:
+        parser.setPerfil(PerfilEntrada::BajaLatencia);
+        break;
+    case 3:
+        parser.setPerfil(PerfilEntrada::Rendimiento);
+        break;
+    default:
+        logger.imprimirLog("WARNING", "Opción de perfil no válida.");
+        return;
     }
+    logger.imprimirLog("STATUS", "Perfil de E/S actualizado; se aplica al abrir el puerto.");
 }
 
 void menuSimulacion(AuxiliarCli& logger, LineaDispatcher& dispatcher, ListaDeCarga& lista)
@@ -268,7 +528,8 @@ void menuSimulacion(AuxiliarCli& logger, LineaDispatcher& dispatcher, ListaDeCar
     dispatcher.terminarSesion();
 }
 
-void ejecutarCapturaSerie(AuxiliarCli& logger, ArduinoParser& parser, LineaDispatcher& dispatcher)
+void ejecutarCapturaSerie(AuxiliarCli& logger, ArduinoParser& parser, LineaDispatcher& dispatcher,
+                          const char* rutaGrabacion, const char* destinoMensajes, bool enTuberia)
 {
     logger.imprimirLog("STATUS", "Preparando captura desde el puerto serie.");
     dispatcher.terminarSesion();
@@ -278,15 +539,539 @@ void ejecutarCapturaSerie(AuxiliarCli& logger, ArduinoParser& parser, LineaDispa
         return;
     }
 
+    GrabadorCaptura grabador;
+    if (rutaGrabacion && rutaGrabacion[0] != '\0') {
+        if (grabador.abrir(rutaGrabacion, parser.getBaudrate())) {
+            parser.setGrabador(&grabador);
+            if (grabador.bytesDescartados() > 0) {
+                char aviso[160];
+                std::snprintf(aviso, sizeof(aviso),
+                              "La grabación anterior terminaba en un registro incompleto; se descartaron %llu bytes.",
+                              static_cast<unsigned long long>(grabador.bytesDescartados()));
+                logger.imprimirLog("WARNING", aviso);
+            }
+            logger.imprimirLog("STATUS", "Grabando la captura cruda.");
+        } else {
+            logger.imprimirLog("WARNING", "No se pudo abrir el archivo de grabación o no es una captura PRT7; se captura sin grabar.");
+        }
+    }
+
+    int mensajesFd = -1;
+    if (destinoMensajes && destinoMensajes[0] != '\0') {
+        mensajesFd = DestinoMensajes::abrir(destinoMensajes);
+        if (mensajesFd < 0) {
+            logger.imprimirLog("WARNING", "No se pudo abrir el destino de mensajes; se verán solo en el log.");
+        }
+    }
+    // Cada FIN (o cierre de sesión) llega al destino en el acto, sin esperar a llenar el buffer.
+    SalidaDescriptor salidaMensajes(mensajesFd);
+    salidaMensajes.setVaciarPorMensaje(true);
+
     logger.imprimirLog("STATUS", "Esperando marcador INICIO desde el dispositivo...");
 
-    const bool exito = parser.listenUntilEnter();
+    bool exito = false;
+    if (enTuberia) {
+        exito = parser.listenEnTuberia(mensajesFd >= 0 ? mensajesFd : STDOUT_FILENO);
+    } else {
+        if (mensajesFd >= 0) {
+            dispatcher.setSalida(&salidaMensajes);
+        }
+#if PRT7_INSTRUMENTACION
+        InstrumentacionEtapas instrumentacion;
+        parser.setInstrumentacion(&instrumentacion);
+        dispatcher.setInstrumentacion(&instrumentacion);
+        InstrumentacionEtapas::instalarSenalReporte();
+        logger.imprimirLog("STATUS", "Instrumentación activa: SIGUSR1 imprime la latencia por etapa.");
+#endif
+        logger.iniciarAsincrono();
+        exito = parser.listenUntilEnter();
+        logger.detenerAsincrono();
+#if PRT7_INSTRUMENTACION
+        parser.setInstrumentacion(nullptr);
+        dispatcher.setInstrumentacion(nullptr);
+        instrumentacion.imprimirReporte(&logger);
+#endif
+    }
     parser.closePort();
 
+    if (grabador.activo()) {
+        parser.setGrabador(nullptr);
+        char resumen[128];
+        std::snprintf(resumen, sizeof(resumen), "Captura grabada: %llu bytes.",
+                      static_cast<unsigned long long>(grabador.bytesGrabados()));
+        if (grabador.cerrar()) {
+            logger.imprimirLog("STATUS", resumen);
+        } else {
+            logger.imprimirLog("WARNING", "La grabación quedó incompleta por un error de escritura.");
+        }
+    }
+
     if (exito) {
         logger.imprimirLog("SUCCESS", "Captura finalizada correctamente.");
     } else {
         logger.imprimirLog("WARNING", "La captura terminó con incidencias.");
     }
     dispatcher.terminarSesion();
+    dispatcher.setSalida(nullptr);
+    if (mensajesFd >= 0) {
+        if (!salidaMensajes.vaciar()) {
+            logger.imprimirLog("WARNING", "Falló la escritura en el destino de mensajes.");
+        }
+        ::close(mensajesFd);
+    }
+}
+
+void ejecutarCapturaMultiple(AuxiliarCli& logger, unsigned baud)
+{
+    int hilos = 0;
+    logger.obtenerDato("Número de hilos trabajadores", hilos);
+    if (hilos < 1) {
+        hilos = 1;
+    }
+
+    char rutas[1024];
+    logger.obtenerCadena("Rutas separadas por espacios (ej. /dev/ttyACM0 /dev/pts/3)", rutas, sizeof(rutas));
+
+    CapturaMultiple captura(&logger, static_cast<std::size_t>(hilos));
+    captura.setBaudrate(baud);
+
+    for (char* ruta = std::strtok(rutas, " \t"); ruta; ruta = std::strtok(nullptr, " \t")) {
+        if (!captura.agregarDispositivo(ruta)) {
+            logger.imprimirLog("WARNING", "Se alcanzó el máximo de dispositivos; se ignoran las rutas restantes.");
+            break;
+        }
+    }
+
+    if (!captura.ejecutarHastaEnter()) {
+        logger.imprimirLog("WARNING", "La captura múltiple no pudo iniciarse.");
+        return;
+    }
+    logger.imprimirLog("SUCCESS", "Captura múltiple finalizada.");
+}
+
+void menuReproduccion(AuxiliarCli& logger, ArduinoParser& parser, LineaDispatcher& dispatcher)
+{
+    char ruta[256];
+    logger.obtenerCadena("Archivo de captura", ruta, sizeof(ruta));
+    recortarEnLugar(ruta);
+
+    std::cout << "\nRitmo de reproducción:\n"
+                 "────────────────────────────────\n"
+                 "0 | Cancelar\n"
+                 "1 | Ritmo original\n"
+                 "2 | Lo más rápido posible\n";
+    int opcion = 0;
+    logger.obtenerDato("Seleccione una opción", opcion);
+    if (opcion != 1 && opcion != 2) {
+        logger.imprimirLog("STATUS", "Reproducción cancelada.");
+        return;
+    }
+
+    ReproductorCaptura reproductor(&parser, &logger);
+    reproductor.setRitmo(opcion == 1 ? RitmoReproduccion::Original : RitmoReproduccion::Maximo);
+    reproductor.setDetenerConEnter(true);
+
+    dispatcher.terminarSesion();
+    logger.imprimirLog("STATUS", "ENTER detiene la reproducción.");
+    logger.iniciarAsincrono();
+    const bool exito = reproductor.reproducir(ruta);
+    logger.detenerAsincrono();
+    dispatcher.terminarSesion();
+
+    reproductor.imprimirEstadisticas();
+    if (exito) {
+        logger.imprimirLog("SUCCESS", "Reproducción finalizada.");
+    }
+}
+
+void configurarNivelLogInteractivo(AuxiliarCli& logger)
+{
+    std::cout << "\nNiveles de log:\n"
+                 "────────────────────────────────\n"
+                 "0 | Solo errores\n"
+                 "1 | Errores y advertencias\n"
+                 "2 | + Éxitos\n"
+                 "3 | + Estado general\n"
+                 "4 | + Detalle por trama\n";
+    int opcion = -1;
+    logger.obtenerDato("Seleccione un nivel", opcion);
+
+    if (opcion < 0 || opcion > 4) {
+        logger.imprimirLog("WARNING", "Nivel de log no válido.");
+        return;
+    }
+    if (opcion > PRT7_NIVEL_LOG) {
+        logger.imprimirLog("WARNING", "Ese nivel no se compiló en este binario (ver PRT7_NIVEL_LOG).");
+    }
+    logger.setNivel(static_cast<NivelLog>(opcion));
+    logger.imprimirLog("STATUS", "Nivel de log actualizado.");
+}
+
+bool interpretarEnteroPositivo(const char* texto, unsigned long maximo, unsigned long& valor)
+{
+    // strtoul() acepta espacios y signo, y niega un '-' en vez de rechazarlo.
+    if (!std::isdigit(static_cast<unsigned char>(texto[0]))) {
+        return false;
+    }
+    errno = 0;
+    char* fin = nullptr;
+    const unsigned long leido = std::strtoul(texto, &fin, 10);
+    if (*fin != '\0' || errno == ERANGE || leido == 0 || leido > maximo) {
+        return false;
+    }
+    valor = leido;
+    return true;
+}
+
+bool interpretarTamano(const char* texto, std::size_t& tamano)
+{
+    // strtoull() acepta espacios y signo, y niega un '-' en vez de rechazarlo.
+    if (!std::isdigit(static_cast<unsigned char>(texto[0]))) {
+        return false;
+    }
+    errno = 0;
+    char* fin = nullptr;
+    const unsigned long long valor = std::strtoull(texto, &fin, 10);
+    if (errno == ERANGE) {
+        return false;
+    }
+    unsigned long long factor = 1;
+    switch (*fin) {
+    case '\0':
+        break;
+    case 'k':
+    case 'K':
+        factor = 1024ull;
+        ++fin;
+        break;
+    case 'm':
+    case 'M':
+        factor = 1024ull * 1024ull;
+        ++fin;
+        break;
+    case 'g':
+    case 'G':
+        factor = 1024ull * 1024ull * 1024ull;
+        ++fin;
+        break;
+    default:
+        return false;
+    }
+    if (*fin != '\0' || valor > SIZE_MAX / factor) {
+        return false;
+    }
+    tamano = static_cast<std::size_t>(valor * factor);
+    return true;
+}
+
+int ejecutarModoLotes(int argc, char* argv[])
+{
+    const char* entrada = nullptr;
+    const char* salida = nullptr;
+    const char* captura = nullptr;
+    const char* latencia = nullptr;
+    const char* metricas = nullptr;
+    unsigned baud = 115200;
+    std::size_t hilos = 1;
+    const char* indexar = nullptr;
+    unsigned long sesion = 0;
+    std::size_t limiteLista = 0;
+    const char* dirDesborde = nullptr;
+    PerfilEntrada perfil = PerfilEntrada::Estandar;
+    RitmoReproduccion ritmo = RitmoReproduccion::Maximo;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--ayuda") == 0) {
+            std::printf("Uso: %s [-d|--decodificar ARCHIVO|-] [--hilos N|auto] [-o|--salida DESTINO]\n"
+                        "       %s -r|--reproducir CAPTURA [--ritmo original|maximo] [-o|--salida DESTINO]\n"
+                        "       %s (-d|-r) ARCHIVO --sesion N | --indexar ARCHIVO\n"
+                        "       %s --latencia RUTA [--baud B|auto] [--perfil PERFIL]\n"
+                        "Sin argumentos (o solo con --metricas, --limite-lista o --dir-desborde) se abre\n"
+                        "el menú interactivo.\n"
+                        "  -d, --decodificar  Archivo de tramas a decodificar; '-' lee STDIN.\n"
+                        "      --hilos        Reparte la decodificación de un archivo regular entre N hilos\n"
+                        "                     (hasta 256; 'auto' usa todos los núcleos; 1 por defecto).\n"
+                        "  -r, --reproducir   Captura grabada desde el menú a reproducir.\n"
+                        "      --ritmo        Ritmo de la reproducción (maximo por defecto).\n"
+                        "                     Con --hilos, -r reparte las sesiones entre hilos (ritmo maximo).\n"
+                        "      --indexar      Escribe ARCHIVO.idx con el inicio de cada sesión y lo lista.\n"
+                        "      --sesion       Decodifica solo la sesión N (desde 1) usando ARCHIVO.idx.\n"
+                        "      --latencia     Lee la pty de prt7_emulador y reporta percentiles de latencia.\n"
+                        "      --baud         Baudrate para --latencia (115200 por defecto; admite valores\n"
+                        "                     arbitrarios como 1843200, o 'auto' para detectarlo).\n"
+                        "      --perfil       Perfil de E/S para --latencia: estandar, baja-latencia o rendimiento.\n"
+                        "  -o, --salida       Destino de los mensajes: ARCHIVO, unix:RUTA o tcp:HOST:PUERTO\n"
+                        "                     (STDOUT por defecto). Un mensaje termina con FIN o con su sesión.\n"
+                        "      --limite-lista Memoria residente por sesión (sufijos K, M, G); lo más antiguo del\n"
+                        "                     mensaje pasa a un archivo temporal (sin límite por defecto).\n"
+                        "      --dir-desborde Directorio del archivo temporal ($TMPDIR o /tmp por defecto).\n"
+                        "      --metricas     Archivo de contadores en formato de texto de Prometheus;\n"
+                        "                     se escribe al terminar y al recibir SIGUSR2 durante la captura.\n",
+                        argv[0], argv[0], argv[0], argv[0]);
+            return 0;
+        }
+        if ((std::strcmp(arg, "-d") == 0 || std::strcmp(arg, "--decodificar") == 0) && i + 1 < argc) {
+            entrada = argv[++i];
+        } else if ((std::strcmp(arg, "-o") == 0 || std::strcmp(arg, "--salida") == 0) && i + 1 < argc) {
+            salida = argv[++i];
+        } else if ((std::strcmp(arg, "-r") == 0 || std::strcmp(arg, "--reproducir") == 0) && i + 1 < argc) {
+            captura = argv[++i];
+        } else if (std::strcmp(arg, "--latencia") == 0 && i + 1 < argc) {
+            latencia = argv[++i];
+        } else if (std::strcmp(arg, "--metricas") == 0 && i + 1 < argc) {
+            metricas = argv[++i];
+        } else if (std::strcmp(arg, "--baud") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            unsigned long leido = 0;
+            if (std::strcmp(valor, "auto") == 0) {
+                baud = 0;
+            } else if (interpretarEnteroPositivo(valor, UINT_MAX, leido)) {
+                baud = static_cast<unsigned>(leido);
+            } else {
+                std::fprintf(stderr, "Baudrate no válido: %s (número positivo o 'auto')\n", valor);
+                return 2;
+            }
+        } else if (std::strcmp(arg, "--hilos") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            unsigned long leido = 0;
+            if (std::strcmp(valor, "auto") == 0) {
+                hilos = 0;
+            } else if (interpretarEnteroPositivo(valor, DecodificadorParalelo::kMaxHilos, leido)) {
+                hilos = static_cast<std::size_t>(leido);
+            } else {
+                std::fprintf(stderr, "Número de hilos no válido: %s (de 1 a %zu, o 'auto')\n", valor,
+                             DecodificadorParalelo::kMaxHilos);
+                return 2;
+            }
+        } else if (std::strcmp(arg, "--indexar") == 0 && i + 1 < argc) {
+            indexar = argv[++i];
+        } else if (std::strcmp(arg, "--sesion") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            if (!interpretarEnteroPositivo(valor, ULONG_MAX, sesion)) {
+                std::fprintf(stderr, "Número de sesión no válido: %s (la primera es 1)\n", valor);
+                return 2;
+            }
+        } else if (std::strcmp(arg, "--limite-lista") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            if (!interpretarTamano(valor, limiteLista)) {
+                std::fprintf(stderr, "Tamaño no válido: %s (ej. 64M)\n", valor);
+                return 2;
+            }
+        } else if (std::strcmp(arg, "--dir-desborde") == 0 && i + 1 < argc) {
+            dirDesborde = argv[++i];
+        } else if (std::strcmp(arg, "--perfil") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            if (!ArduinoParser::interpretarPerfil(valor, perfil)) {
+                std::fprintf(stderr, "Perfil no reconocido: %s (estandar|baja-latencia|rendimiento)\n", valor);
+                return 2;
+            }
+        } else if (std::strcmp(arg, "--ritmo") == 0 && i + 1 < argc) {
+            const char* valor = argv[++i];
+            if (std::strcmp(valor, "original") == 0) {
+                ritmo = RitmoReproduccion::Original;
+            } else if (std::strcmp(valor, "maximo") == 0) {
+                ritmo = RitmoReproduccion::Maximo;
+            } else {
+                std::fprintf(stderr, "Ritmo no reconocido: %s (original|maximo)\n", valor);
+                return 2;
+            }
+        } else if (arg[0] != '-' || std::strcmp(arg, "-") == 0) {
+            entrada = arg;
+        } else {
+            std::fprintf(stderr, "Opción no reconocida: %s (use --ayuda)\n", arg);
+            return 2;
+        }
+    }
+
+    if (indexar) {
+        return indexarSesiones(indexar) ? 0 : 1;
+    }
+
+    // Antes de crear cualquier lista: también aplica a las de canales e hilos.
+    ListaDeCarga::setDesbordePorDefecto(limiteLista, dirDesborde);
+
+    if (!entrada && !captura && !latencia && (metricas || limiteLista > 0 || dirDesborde)) {
+        return ejecutarMenuInteractivo(metricas);
+    }
+
+    RegistroContadores contadores;
+    RegistroContadores* registro = nullptr;
+    if (metricas) {
+        contadores.setRutaVolcado(metricas);
+        registro = &contadores;
+    }
+
+    if (latencia) {
+        const bool medido = medirLatencia(latencia, baud, perfil, registro);
+        if (registro && !contadores.volcar()) {
+            std::fprintf(stderr, "No se pudo escribir %s\n", metricas);
+        }
+        return medido ? 0 : 1;
+    }
+
+    if (!entrada && !captura) {
+        std::fprintf(stderr, "Falta el archivo de entrada (use --ayuda)\n");
+        return 2;
+    }
+
+    int salidaFd = STDOUT_FILENO;
+    if (salida) {
+        salidaFd = DestinoMensajes::abrir(salida);
+        if (salidaFd < 0) {
+            std::fprintf(stderr, "No se pudo abrir %s para escritura\n", salida);
+            return 1;
+        }
+    }
+
+    bool exito = false;
+    if (sesion > 0 || (captura && hilos != 1)) {
+        exito = decodificarPorSesiones(captura ? captura : entrada, sesion, hilos, salidaFd, registro);
+    } else if (captura) {
+        // En una reproducción al ritmo original o hacia un socket cada mensaje sale al cerrarse.
+        const bool vaciarPorMensaje = ritmo == RitmoReproduccion::Original ||
+                                      DestinoMensajes::clasificar(salida) != DestinoMensajes::TipoDestino::Archivo;
+        exito = reproducirCaptura(captura, ritmo, salidaFd, vaciarPorMensaje, registro);
+    } else if (hilos != 1) {
+        DecodificadorParalelo decodificador(hilos);
+        decodificador.setContadores(registro);
+        exito = decodificador.decodificarArchivo(entrada, salidaFd);
+    } else {
+        DecodificadorLotes decodificador;
+        decodificador.setContadores(registro);
+        exito = decodificador.decodificarArchivo(entrada, salidaFd);
+    }
+    if (registro && !contadores.volcar()) {
+        std::fprintf(stderr, "No se pudo escribir %s\n", metricas);
+        exito = false;
+    }
+
+    if (salida) {
+        ::close(salidaFd);
+    }
+    return exito ? 0 : 1;
+}
+
+bool reproducirCaptura(const char* ruta, RitmoReproduccion ritmo, int salidaFd, bool vaciarPorMensaje,
+                       RegistroContadores* contadores)
+{
+    ListaDeCarga lista;
+    RotorDeMapeo rotor;
+    LineaDispatcher dispatcher(&lista, &rotor, nullptr);
+    SalidaDescriptor salida(salidaFd);
+    salida.setVaciarPorMensaje(vaciarPorMensaje);
+    dispatcher.setSalida(&salida);
+    ArduinoParser parser(nullptr, &dispatcher);
+    parser.setContadores(contadores);
+    dispatcher.setContadores(contadores);
+#if PRT7_INSTRUMENTACION
+    InstrumentacionEtapas instrumentacion;
+    parser.setInstrumentacion(&instrumentacion);
+    dispatcher.setInstrumentacion(&instrumentacion);
+#endif
+
+    ReproductorCaptura reproductor(&parser);
+    reproductor.setRitmo(ritmo);
+    const bool exito = reproductor.reproducir(ruta);
+    dispatcher.terminarSesion();
+    dispatcher.setSalida(nullptr);
+    const bool escrito = salida.vaciar();
+
+    const ReproductorCaptura::Estadisticas stats = reproductor.estadisticas();
+    std::fprintf(stderr, "%llu bloques, %llu bytes en %.3f s (original %.3f s), retraso máximo %llu us\n",
+                 static_cast<unsigned long long>(stats.registros), static_cast<unsigned long long>(stats.bytes),
+                 stats.duracionRealUs / 1e6, stats.duracionOriginalUs / 1e6,
+                 static_cast<unsigned long long>(stats.retrasoMaximoUs));
+    if (stats.bytesSaltados > 0) {
+        std::fprintf(stderr, "%llu bytes dañados saltados\n", static_cast<unsigned long long>(stats.bytesSaltados));
+    }
+#if PRT7_INSTRUMENTACION
+    instrumentacion.imprimirReporte(nullptr);
+#endif
+    return exito && escrito;
+}
+
+bool decodificarPorSesiones(const char* ruta, unsigned long sesion, std::size_t hilos, int salidaFd,
+                            RegistroContadores* contadores)
+{
+    DecodificadorSesiones decodificador(hilos);
+    decodificador.setContadores(contadores);
+    if (!decodificador.abrir(ruta)) {
+        return false;
+    }
+    if (sesion > 0) {
+        return decodificador.decodificarSesion(static_cast<std::size_t>(sesion - 1), salidaFd);
+    }
+    return decodificador.decodificarTodas(salidaFd);
+}
+
+bool indexarSesiones(const char* ruta)
+{
+    DecodificadorSesiones decodificador(1);
+    if (!decodificador.abrir(ruta, true)) {
+        return false;
+    }
+    const IndiceSesiones& indice = decodificador.indice();
+    std::printf("# sesion\tsegmento\tinstante_us\tregistro\tdentro\n");
+    for (std::size_t n = 0; n < indice.sesiones(); ++n) {
+        const EntradaSesion& entrada = indice.sesion(n);
+        std::printf("%zu\t%u\t%llu\t%llu\t%llu\n", n + 1, static_cast<unsigned>(entrada.segmento),
+                    static_cast<unsigned long long>(entrada.instanteUs),
+                    static_cast<unsigned long long>(entrada.posicion.registro),
+                    static_cast<unsigned long long>(entrada.posicion.dentro));
+    }
+    std::fprintf(stderr, "%zu sesiones en %s (%s)%s\n", indice.sesiones(), ruta,
+                 indice.formato() == FormatoFuente::Captura ? "captura" : "texto",
+                 indice.independientes() ? "" : "; usa canales o modo binario, no se decodifica por sesiones");
+    return true;
+}
+
+bool medirLatencia(const char* ruta, unsigned baud, PerfilEntrada perfil, RegistroContadores* contadores)
+{
+    ListaDeCarga lista;
+    RotorDeMapeo rotor;
+    LineaDispatcher dispatcher(&lista, &rotor, nullptr);
+    MedidorLatencia medidor;
+    dispatcher.setMedidor(&medidor);
+
+    AuxiliarCli logger;
+    logger.setNivel(NivelLog::Warning);
+    if (baud == 0) {
+        baud = ArduinoParser::detectarBaudrate(ruta, &logger);
+        if (baud == 0) {
+            logger.imprimirLog("ERROR", "No se detectó un baudrate con tramas válidas.");
+            return false;
+        }
+        std::fprintf(stderr, "Baudrate detectado: %u\n", baud);
+    }
+    ArduinoParser parser(&logger, &dispatcher);
+    parser.setBaudrate(baud);
+    parser.setPerfil(perfil);
+    parser.setContadores(contadores);
+    dispatcher.setContadores(contadores);
+    if (contadores) {
+        RegistroContadores::instalarSenalVolcado();
+    }
+    if (!parser.openPath(ruta)) {
+        return false;
+    }
+#if PRT7_INSTRUMENTACION
+    InstrumentacionEtapas instrumentacion;
+    parser.setInstrumentacion(&instrumentacion);
+    dispatcher.setInstrumentacion(&instrumentacion);
+    InstrumentacionEtapas::instalarSenalReporte();
+    logger.setNivel(NivelLog::Status); // los reportes por SIGUSR1 salen como STATUS
+#endif
+
+    // Termina con ENTER o cuando el emulador cierra la pty.
+    parser.listenUntilEnter();
+    parser.closePort();
+    dispatcher.terminarSesion();
+
+    std::printf("Perfil de E/S: %s\n", ArduinoParser::nombrePerfil(perfil));
+    medidor.imprimirReporte(stdout);
+#if PRT7_INSTRUMENTACION
+    instrumentacion.imprimirReporte(nullptr);
+#endif
+    return medidor.histograma().cantidad() > 0;
 }
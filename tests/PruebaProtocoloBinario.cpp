@@ -0,0 +1,101 @@
+/**
+ * @file PruebaProtocoloBinario.cpp
+ * @brief Comprueba varint, zigzag y CRC-16 del protocolo binario.
+ *
+ * Cada fallo se reporta en STDERR; el código de salida distinto de cero lo marca en ctest.
+ */
+
+#include "ProtocoloBinario.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+int fallos = 0;
+
+void comprobar(bool condicion, const char* descripcion)
+{
+    if (!condicion) {
+        std::fprintf(stderr, "FALLO: %s\n", descripcion);
+        ++fallos;
+    }
+}
+
+void probarIdaYVueltaVarint()
+{
+    const std::uint64_t valores[] = {0u, 1u, 127u, 128u, 300u, 16383u, 16384u, 0xFFFFFFFFu,
+                                     0x7FFFFFFFFFFFFFFFull, 0x8000000000000000ull, 0xFFFFFFFFFFFFFFFFull};
+    for (const std::uint64_t valor : valores) {
+        unsigned char buffer[ProtocoloBinario::kMaxVarint];
+        const std::size_t escritos = ProtocoloBinario::escribirVarint(valor, buffer);
+        std::uint64_t leido = 0;
+        const std::size_t consumidos = ProtocoloBinario::leerVarint(buffer, escritos, leido);
+        comprobar(escritos <= ProtocoloBinario::kMaxVarint, "varint dentro de kMaxVarint");
+        comprobar(consumidos == escritos, "varint consume lo escrito");
+        comprobar(leido == valor, "varint ida y vuelta");
+        comprobar(ProtocoloBinario::leerVarint(buffer, escritos - 1, leido) == 0, "varint truncado");
+    }
+
+    const std::int64_t rotaciones[] = {0, 1, -1, 63, -64, 1000000, INT64_MAX, INT64_MIN};
+    for (const std::int64_t rotacion : rotaciones) {
+        comprobar(ProtocoloBinario::desdeZigzag(ProtocoloBinario::aZigzag(rotacion)) == rotacion, "zigzag ida y vuelta");
+    }
+    comprobar(ProtocoloBinario::aZigzag(-1) == 1u && ProtocoloBinario::aZigzag(1) == 2u, "zigzag de rotaciones cortas");
+}
+
+void probarDesbordeVarint()
+{
+    unsigned char buffer[11];
+    std::memset(buffer, 0xFF, sizeof(buffer));
+    std::uint64_t valor = 0;
+
+    // Nueve bytes llenos y un décimo con el bit 63: el máximo representable.
+    buffer[9] = 0x01;
+    comprobar(ProtocoloBinario::leerVarint(buffer, 10, valor) == 10 && valor == 0xFFFFFFFFFFFFFFFFull,
+              "varint de 64 bits exactos");
+
+    // Bits por encima del 63 en el décimo byte.
+    buffer[9] = 0x02;
+    comprobar(ProtocoloBinario::leerVarint(buffer, 10, valor) == 0, "varint con bit 64");
+    buffer[9] = 0x7F;
+    comprobar(ProtocoloBinario::leerVarint(buffer, 10, valor) == 0, "varint con bits 64-69");
+
+    // Un décimo byte con continuación pediría un undécimo.
+    buffer[9] = 0x81;
+    buffer[10] = 0x00;
+    comprobar(ProtocoloBinario::leerVarint(buffer, 11, valor) == 0, "varint de once bytes");
+}
+
+void probarCrc()
+{
+    const char texto[] = "123456789";
+    const unsigned char* datos = reinterpret_cast<const unsigned char*>(texto);
+    const std::size_t longitud = sizeof(texto) - 1;
+
+    // Valor de control publicado para CRC-16/CCITT-FALSE.
+    comprobar(ProtocoloBinario::crc16(datos, longitud) == 0x29B1u, "CRC de control");
+    comprobar(ProtocoloBinario::crc16(datos, 0) == 0xFFFFu, "CRC vacío");
+
+    const std::uint16_t parcial = ProtocoloBinario::crc16(datos, 4);
+    comprobar(ProtocoloBinario::crc16(datos + 4, longitud - 4, parcial) == 0x29B1u, "CRC acumulado por partes");
+
+    unsigned char alterado[sizeof(texto) - 1];
+    std::memcpy(alterado, datos, longitud);
+    alterado[3] ^= 0x01u;
+    comprobar(ProtocoloBinario::crc16(alterado, longitud) != 0x29B1u, "CRC detecta un bit cambiado");
+}
+
+} // namespace
+
+int main()
+{
+    probarIdaYVueltaVarint();
+    probarDesbordeVarint();
+    probarCrc();
+    if (fallos == 0) {
+        std::puts("protocolo binario: OK");
+    }
+    return fallos == 0 ? 0 : 1;
+}